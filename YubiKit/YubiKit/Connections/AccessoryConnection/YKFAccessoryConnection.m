@@ -102,6 +102,7 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
 @implementation YKFAccessoryConnection
 
 @synthesize delegate;
+@synthesize commandChainingEnabled = _commandChainingEnabled;
 
 - (instancetype)initWithAccessoryManager:(id<YKFEAAccessoryManagerProtocol>)accessoryManager configuration:(YKFAccessoryConnectionConfiguration *)configuration {
     YKFAssertAbortInit(accessoryManager);
@@ -121,6 +122,11 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
     return _connectionState;
 }
 
+- (void)setCommandChainingEnabled:(BOOL)commandChainingEnabled {
+    _commandChainingEnabled = commandChainingEnabled;
+    self.connectionController.commandChainingEnabled = commandChainingEnabled;
+}
+
 - (YKFSmartCardInterface *)smartCardInterface {
     if (!self.connectionController) {
         return nil;
@@ -524,6 +530,7 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
     if (self.session) {
         self.reconnectOnApplicationActive = NO;
         self.connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:self.session operationQueue:self.communicationQueue];
+        self.connectionController.commandChainingEnabled = self.commandChainingEnabled;
         self.session.outputStream.delegate = self;
         
         YKFLogInfo(@"Session opened.");
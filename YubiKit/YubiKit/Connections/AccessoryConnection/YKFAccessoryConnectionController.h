@@ -23,6 +23,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface YKFAccessoryConnectionController : NSObject<YKFConnectionControllerProtocol>
 
+/*
+ The number of busy frames (WTX) the key sent while processing the last command.
+ */
+@property (nonatomic, readonly) NSUInteger lastCommandBusyFrameCount;
+
 - (nullable instancetype)initWithSession:(id<YKFEASessionProtocol>)session operationQueue:(NSOperationQueue *)operationQueue NS_DESIGNATED_INITIALIZER;
 - (instancetype)init NS_UNAVAILABLE;
 
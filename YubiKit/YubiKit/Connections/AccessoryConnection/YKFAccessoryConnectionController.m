@@ -22,8 +22,10 @@
 #import "YKFNSDataAdditions+Private.h"
 #import "YKFSessionError+Private.h"
 #import "YKFAPDU+Private.h"
+#import "YKFResponseBuffer.h"
+#import "YKFByteSpan.h"
 
-@interface YKFAccessoryConnectionController()
+@interface YKFAccessoryConnectionController()<NSStreamDelegate>
 
 @property (nonatomic) NSOperationQueue *communicationQueue;
 @property (nonatomic) NSMutableDictionary *delayedDispatches;
@@ -32,14 +34,49 @@
 @property (nonatomic) NSOutputStream *outputStream;
 @property (nonatomic) NSThread *streamsThread;
 
+@property (nonatomic, readwrite) NSUInteger lastCommandBusyFrameCount;
+
+// YES when a command was cancelled while the key was processing it. The key still sends the response, which is
+// discarded before the next command is written. Only accessed on the communication queue.
+@property (nonatomic) BOOL hasPendingResponse;
+
+// Signaled by the stream events and by cancellations to wake up the stream IO waiting on the communication queue.
+@property (nonatomic) dispatch_semaphore_t streamEventSemaphore;
+
 @end
 
 @implementation YKFAccessoryConnectionController
 
-static NSUInteger const YubiKeyConnectionControllerReadBufferSize = 512; // bytes
-static NSTimeInterval const YKFAccessoryConnectionCommandProbeTime = 0.05;
+// YLP frame headers.
+static UInt8 const YKFAccessoryConnectionResponseHeader = 0x00;
+static UInt8 const YKFAccessoryConnectionBusyHeader = 0x01;
+
+// The YLP header and the status code.
+static NSUInteger const YKFAccessoryConnectionMinimumResponseLength = 3; // bytes
+
+// The YLP header and the 3 bytes WTX.
+static NSUInteger const YKFAccessoryConnectionBusyFrameLength = 4; // bytes
+
+// The interval between the busy frames when the key does not announce it, and the bounds of the announced intervals.
+static NSTimeInterval const YKFAccessoryConnectionDefaultWTX = 0.5;
+static NSTimeInterval const YKFAccessoryConnectionMinimumWTX = 0.01;
+static NSTimeInterval const YKFAccessoryConnectionMaximumWTX = 5.0;
+
+// The number of announced intervals without a frame after which the key is considered unresponsive.
+static NSUInteger const YKFAccessoryConnectionMissedWTXLimit = 3;
+
+// The time without new bytes after which a response frame is complete. The frames have no length field and a long frame
+// can be delivered by the stream in parts.
+static NSTimeInterval const YKFAccessoryConnectionFrameQuietInterval = 0.02;
+
+// The YLP header, a short response and the status code. Longer frames grow the read buffer.
+static NSUInteger const YKFAccessoryConnectionInitialFrameLength = 1 + 256 + 2; // bytes
 static NSTimeInterval const YKFAccessoryConnectionDefaultTimeout = 10.0;
-static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
+
+// The accessory protocol has no frame size limit: the blocks are as large as a short APDU allows.
+static NSUInteger const YKFAccessoryConnectionCommandChainingBlockSize = 255; // bytes
+
+@synthesize commandChainingEnabled;
 
 - (instancetype)initWithSession:(id<YKFEASessionProtocol>)session operationQueue:(NSOperationQueue *)operationQueue {
     YKFAssertAbortInit(session);
@@ -55,6 +92,7 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
         YKFAssertAbortInit(self.outputStream);
         
         self.delayedDispatches = [[NSMutableDictionary alloc] init];
+        self.streamEventSemaphore = dispatch_semaphore_create(0);
         
         self.streamsThread = [[NSThread alloc] initWithTarget: self selector:@selector(streamsThreadExecution) object:nil];
         [self.streamsThread start];
@@ -81,6 +119,16 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     }];
 }
 
+- (NSUInteger)commandChainingBlockSize {
+    return YKFAccessoryConnectionCommandChainingBlockSize;
+}
+
+- (BOOL)supportsExtendedLength {
+    // The YLP frames have no length field and the end of a response is only detected when the stream stays quiet.
+    // The responses are kept short, so a stall of the stream cannot cut a multi-KB frame.
+    return NO;
+}
+
 #pragma mark - Dispatching
 
 - (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block {
@@ -100,6 +148,21 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     [self.communicationQueue addOperation:operation];
 }
 
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block delay:(NSTimeInterval)delay {
+    YKFParameterAssertReturn(block);
+    
+    if (delay <= 0) {
+        [self dispatchBlockOnCommunicationQueue:block];
+        return;
+    }
+    
+    ykf_weak_self();
+    ykf_dispatch_after_cancellable(delay, self.communicationQueue, self.delayedDispatches, ^{
+        ykf_safe_strong_self();
+        [strongSelf dispatchBlockOnCommunicationQueue:block];
+    });
+}
+
 - (void)streamsThreadExecution {
     YKFAssertOffMainThread();
     
@@ -122,9 +185,11 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     ykf_dispatch_thread_async(self.streamsThread, ^{
         NSRunLoop *runLoop = [NSRunLoop currentRunLoop];
         
+        inputStream.delegate = self;
         [inputStream scheduleInRunLoop:runLoop forMode:NSDefaultRunLoopMode];
         [inputStream open];
         
+        outputStream.delegate = self;
         [outputStream scheduleInRunLoop:runLoop forMode:NSDefaultRunLoopMode];
         [outputStream open];
         
@@ -143,11 +208,13 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
             [inputStream close];
         }
         [inputStream removeFromRunLoop:runLoop forMode:NSDefaultRunLoopMode];
+        inputStream.delegate = nil;
         
         if (outputStream.streamStatus != NSStreamStatusClosed) {
             [outputStream close];
         }
         [outputStream removeFromRunLoop:runLoop forMode:NSDefaultRunLoopMode];
+        outputStream.delegate = nil;
         
         CFRunLoopStop(CFRunLoopGetCurrent());
         
@@ -155,30 +222,62 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     });
 }
 
+#pragma mark - NSStreamDelegate
+
+- (void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)eventCode {
+    switch (eventCode) {
+        case NSStreamEventHasBytesAvailable:
+        case NSStreamEventHasSpaceAvailable:
+        case NSStreamEventErrorOccurred:
+        case NSStreamEventEndEncountered:
+            dispatch_semaphore_signal(self.streamEventSemaphore);
+            break;
+        default:
+            break;
+    }
+}
+
 #pragma mark - Stream IO
 
-- (BOOL)writeData:(NSData *)data timeout:(NSTimeInterval)timeout parentOperation:(NSOperation *)operation {
+/*
+ Blocks the communication queue until the next stream event or cancellation. Returns NO if the deadline passed first.
+ This is the only wait of the stream IO: the deadline of the command and the cancellations both end it, so a command
+ never waits longer than its deadline and notices a cancellation right away.
+ The signals may be left over from events which were already handled, so the callers check the stream state again
+ after every wakeup.
+ */
+- (BOOL)waitForStreamEventWithDeadline:(dispatch_time_t)deadline {
+    return dispatch_semaphore_wait(self.streamEventSemaphore, deadline) == 0;
+}
+
+- (BOOL)writeData:(NSData *)data deadline:(dispatch_time_t)deadline parentOperation:(NSOperation *)operation {
     YKFAssertOffMainThread();
     
     YKFParameterAssertReturnValue(data, NO);
     YKFParameterAssertReturnValue(self.outputStream, NO);
     
-    NSMutableData *writeData = [data mutableCopy];
-    NSTimeInterval totalSleepTime = 0;
+    // The partial writes advance in the command buffer, which is never copied.
+    const UInt8 *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger offset = 0;
     
-    while (writeData.length > 0 && !operation.isCancelled) {
-        while (self.outputStream.hasSpaceAvailable && writeData.length > 0 && !operation.isCancelled) {
-            NSInteger bytesWritten = [self.outputStream write:writeData.bytes maxLength:writeData.length];
+    while (offset < length && !operation.isCancelled) {
+        while (self.outputStream.hasSpaceAvailable && offset < length && !operation.isCancelled) {
+            NSInteger bytesWritten = [self.outputStream write:bytes + offset maxLength:length - offset];
             if (bytesWritten > 0) {
-                [writeData replaceBytesInRange:NSMakeRange(0, bytesWritten) withBytes:NULL length:0];
+                offset += bytesWritten;
             } else if (bytesWritten == -1) { // Write error.
                 return NO;
+            } else {
+                break; // The stream is full.
             }
         }
+        if (offset == length || operation.isCancelled) {
+            break;
+        }
         
-        [NSThread sleepForTimeInterval: YKFAccessoryConnectionCommandProbeTime];
-        totalSleepTime += YKFAccessoryConnectionCommandProbeTime;
-        if (totalSleepTime >= timeout) {
+        // Wait for the stream to have space available.
+        if (![self waitForStreamEventWithDeadline:deadline]) {
             return NO;
         }
     }
@@ -190,18 +289,54 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     return YES;
 }
 
-- (BOOL)readData:(NSData**)readData timeout:(NSTimeInterval)timeout parentOperation:(NSOperation *)operation {
+/*
+ Reads one YLP frame. The busy frames have a fixed length. The response frames have no length field, so a response is
+ read until it has at least the header and a status code and the stream stays quiet for a short interval: a long frame
+ which is delivered in parts is completed with the next stream events. The buffer fits a short response and grows for
+ the longer frames.
+ */
+- (BOOL)readData:(NSData**)readData deadline:(dispatch_time_t)deadline parentOperation:(NSOperation *)operation {
     YKFAssertOffMainThread();
     YKFParameterAssertReturnValue(self.inputStream, NO);
     
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt8 readBuffer[YubiKeyConnectionControllerReadBufferSize];
+    YKFResponseBuffer *buffer = [[YKFResponseBuffer alloc] initWithCapacity:YKFAccessoryConnectionInitialFrameLength];
+    
+    // Discard the signals of the events which were handled by the previous reads and writes, so the waits below sleep
+    // until the key sends the frame. The stream is checked for bytes after this, so no event can be lost.
+    while (dispatch_semaphore_wait(self.streamEventSemaphore, DISPATCH_TIME_NOW) == 0) {}
     
-    NSTimeInterval totalSleepTime = 0;
-    while (!self.inputStream.hasBytesAvailable && !operation.isCancelled) {
-        [NSThread sleepForTimeInterval: YKFAccessoryConnectionCommandProbeTime];
-        totalSleepTime += YKFAccessoryConnectionCommandProbeTime;
-        if (totalSleepTime >= timeout) {
+    while (!operation.isCancelled) {
+        // Read the data while available.
+        while (self.inputStream.hasBytesAvailable) {
+            NSInteger bytesRead = [buffer appendBytesFromInputStream:self.inputStream];
+            if (bytesRead == -1) { // Read error.
+                return NO;
+            }
+            if (bytesRead == 0) {
+                break;
+            }
+        }
+        
+        if (buffer.length) {
+            UInt8 header = buffer.bytes[0];
+            if (header != YKFAccessoryConnectionResponseHeader && header != YKFAccessoryConnectionBusyHeader) {
+                YKFLogError(@"Unexpected YLP frame header: %02X", header);
+                return NO;
+            }
+            NSUInteger minimumLength = [self minimumLengthOfFrame:buffer];
+            if (buffer.length >= minimumLength) {
+                if (minimumLength == YKFAccessoryConnectionBusyFrameLength) {
+                    break;
+                }
+                dispatch_time_t quietDeadline = ykf_dispatch_deadline(YKFAccessoryConnectionFrameQuietInterval);
+                if (![self waitForStreamEventWithDeadline:quietDeadline]) {
+                    break;
+                }
+                continue;
+            }
+        }
+        
+        if (![self waitForStreamEventWithDeadline:deadline]) {
             return NO;
         }
     }
@@ -210,17 +345,7 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
         return NO;
     }
     
-    // Read the data while available.
-    while (self.inputStream.hasBytesAvailable) {
-        NSInteger bytesRead = [self.inputStream read:readBuffer maxLength:YubiKeyConnectionControllerReadBufferSize];
-        if (bytesRead > 0) {
-            [buffer appendBytes:readBuffer length:bytesRead];
-        } else if (bytesRead == -1) { // Read error.
-            return NO;
-        }
-    }
-    
-    *readData = [buffer copy];
+    *readData = [buffer takeData];
     
     return YES;
 }
@@ -240,72 +365,182 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     ykf_weak_self();
     [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
         ykf_safe_strong_self();
-        NSDate *commandStartDate = [NSDate date];
-        YKFLogVerbose(@"Sent(IAP): %@", [command.ylpApduData ykf_hexadecimalString]);
+        uint64_t commandStartTime = ykf_monotonic_time();
+        
+        NSError *error = nil;
+        NSData *commandResult = [strongSelf transmitCommand:command timeout:timeout operation:operation error:&error];
+        
+        // Do not notify if the operation was canceled.
+        if (operation.isCancelled) {
+            return;
+        }
+        
+        NSTimeInterval executionTime = ykf_elapsed_time_since(commandStartTime);
+        completion(commandResult, error, executionTime);
+        
+        YKFLogVerbose(@"Command execution time: %lf seconds", executionTime);
+    }];
+}
 
-        // 1. Send the command to the key.
-        BOOL success = [strongSelf writeData:command.ylpApduData timeout:timeout parentOperation:operation];
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    [self executeBatch:commands timeout:YKFAccessoryConnectionDefaultTimeout completion:completion];
+}
+
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    YKFParameterAssertReturn(commands);
+    YKFParameterAssertReturn(completion);
+    
+    YKFLogVerbose(@"AccessoryConnectionController - Execute batch of %lu commands...", (unsigned long)commands.count);
+    
+    ykf_weak_self();
+    [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+        ykf_safe_strong_self();
+        uint64_t batchStartTime = ykf_monotonic_time();
+        NSMutableArray<NSData *> *responses = [[NSMutableArray alloc] initWithCapacity:commands.count];
+        NSError *error = nil;
         
-        if (!success && !operation.isCancelled) {
-            NSError *error = nil;
-            if (strongSelf.outputStream.streamError) {
-                error = [strongSelf.outputStream.streamError copy];
-            } else {
-                error = [YKFSessionError errorWithCode:YKFSessionErrorWriteTimeoutCode];
+        for (YKFAPDU *command in commands) {
+            NSData *commandResult = [strongSelf transmitCommand:command timeout:timeout operation:operation error:&error];
+            if (operation.isCancelled) {
+                return;
+            }
+            if (!commandResult) {
+                break;
+            }
+            [responses addObject:commandResult];
+            if (![commandResult ykf_isSuccessfulAPDUResponse]) {
+                break;
             }
-            
-            NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-            completion(nil, error, executionTime);
-            return;
         }
+        
+        NSTimeInterval executionTime = ykf_elapsed_time_since(batchStartTime);
+        completion(responses, error, executionTime);
+        
+        YKFLogVerbose(@"Batch execution time: %lf seconds", executionTime);
+    }];
+}
+
+/*
+ Sends the command and waits for the response on the communication queue. Returns the data and status of the response,
+ or nil when the command failed or was cancelled. The error is not set when the command was cancelled.
+ 
+ The timeout is a deadline for the whole command, on the monotonic clock of dispatch_time: writing the command and
+ reading the response share it. A busy frame proves that the key is still processing the command, so it moves the
+ deadline to a few announced intervals after the frame when that is later.
+ */
+- (NSData *)transmitCommand:(YKFAPDU *)command timeout:(NSTimeInterval)timeout operation:(NSOperation *)operation error:(NSError **)error {
+    YKFLogVerbose(@"Sent(IAP): %@", [command.ylpApduData ykf_hexadecimalString]);
 
-        // Do not wait for the command to process if the operation was canceled.
+    dispatch_time_t deadline = ykf_dispatch_deadline(timeout);
+    
+    // 0. Discard the response of the cancelled command, otherwise it would be read as the response to this one.
+    if (self.hasPendingResponse && ![self discardPendingResponseWithDeadline:deadline parentOperation:operation]) {
         if (operation.isCancelled) {
-            return;
+            return nil;
+        }
+        // The response could not be delimited (e.g. its first bytes were read by the cancelled command). Drop what the
+        // key sent, so the next command starts on a frame boundary instead of failing on the same bytes again.
+        [self drainInputStream];
+        self.hasPendingResponse = NO;
+        if (error) {
+            NSError *streamError = self.inputStream.streamError;
+            *error = streamError ? [streamError copy] : [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
+        }
+        return nil;
+    }
+    
+    // 1. Send the command to the key.
+    BOOL success = [self writeData:command.ylpApduData deadline:deadline parentOperation:operation];
+    
+    // Do not wait for the command to process if the operation was canceled.
+    if (operation.isCancelled) {
+        return nil;
+    }
+    
+    if (!success) {
+        if (error) {
+            NSError *streamError = self.outputStream.streamError;
+            *error = streamError ? [streamError copy] : [YKFSessionError errorWithCode:YKFSessionErrorWriteTimeoutCode];
         }
+        return nil;
+    }
 
-        BOOL keyIsBusyProcesssing = YES;
-        NSData *commandResult = nil;
+    BOOL keyIsBusyProcesssing = YES;
+    NSData *commandResult = nil;
+    self.lastCommandBusyFrameCount = 0;
 
-        while (keyIsBusyProcesssing) {
-            // 2. Wait for the key to process the command.
-            [NSThread sleepForTimeInterval: YKFAccessoryConnectionCommandTime];
-            
-            // 3. Read the command result.
-            success = [strongSelf readData:&commandResult timeout:timeout parentOperation:operation];
-
-            if ((!success || commandResult.length == 0) && !operation.isCancelled) {
-                NSError *error = nil;
-                if (strongSelf.inputStream.streamError) {
-                    error = [strongSelf.inputStream.streamError copy];
-                } else {
-                    error = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
-                }
-                
-                NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-                completion(nil, error, executionTime);
-                return;
+    while (keyIsBusyProcesssing) {
+        // 2. Read the command result when the key sends it. While the key is busy the read sleeps until the next
+        // frame, which is announced by the WTX of the previous one.
+        success = [self readData:&commandResult deadline:deadline parentOperation:operation];
+        
+        if (operation.isCancelled) {
+            // The key sends the response, or the rest of it after a busy frame, regardless of the cancellation.
+            self.hasPendingResponse = !success || [self isKeyBusyProcessingResult:commandResult];
+            return nil;
+        }
+
+        if (!success || commandResult.length == 0) {
+            if (error) {
+                NSError *streamError = self.inputStream.streamError;
+                *error = streamError ? [streamError copy] : [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
             }
+            return nil;
+        }
+        
+        keyIsBusyProcesssing = [self isKeyBusyProcessingResult:commandResult];
+        if (keyIsBusyProcesssing) {
+            self.lastCommandBusyFrameCount += 1;
             
-            // Do not notify if the operation was canceled.
-            if (operation.isCancelled) {
-                return;
-            }
+            // The key is given a few of the announced intervals to send the next frame, even beyond the deadline.
+            NSTimeInterval waitingTimeExtension = [self waitingTimeExtensionFromBusyResult:commandResult];
+            deadline = MAX(deadline, ykf_dispatch_deadline(waitingTimeExtension * YKFAccessoryConnectionMissedWTXLimit));
             
-            keyIsBusyProcesssing = [strongSelf isKeyBusyProcessingResult:commandResult];
-            if (keyIsBusyProcesssing) {
-                YKFLogVerbose(@"The key is busy, processing the request. Waiting for response...");
-            }
+            YKFLogVerbose(@"The key is busy, processing the request. Waiting for response in %.3lf seconds...", waitingTimeExtension);
         }
+    }
+    
+    if (self.lastCommandBusyFrameCount) {
+        YKFLogVerbose(@"The key sent %lu busy frames before the response.", (unsigned long)self.lastCommandBusyFrameCount);
+    }
 
-        NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-        YKFLogVerbose(@"Received(IAP): %@", [commandResult ykf_hexadecimalString]);
-        commandResult = [self dataAndStatusFromKeyResponse:commandResult];
+    YKFLogVerbose(@"Received(IAP): %@", [commandResult ykf_hexadecimalString]);
+    return [self dataAndStatusFromKeyResponse:commandResult];
+}
 
-        completion(commandResult, nil, executionTime);
-        
-        YKFLogVerbose(@"Command execution time: %lf seconds", executionTime);
-    }];
+/*
+ Reads the frames of the response to a cancelled command until its last frame, without a busy header.
+ */
+- (BOOL)discardPendingResponseWithDeadline:(dispatch_time_t)deadline parentOperation:(NSOperation *)operation {
+    NSData *frame = nil;
+    BOOL keyIsBusyProcesssing = YES;
+    while (keyIsBusyProcesssing) {
+        if (![self readData:&frame deadline:deadline parentOperation:operation] || frame.length == 0) {
+            return NO;
+        }
+        keyIsBusyProcesssing = [self isKeyBusyProcessingResult:frame];
+        if (keyIsBusyProcesssing) {
+            NSTimeInterval waitingTimeExtension = [self waitingTimeExtensionFromBusyResult:frame];
+            deadline = MAX(deadline, ykf_dispatch_deadline(waitingTimeExtension * YKFAccessoryConnectionMissedWTXLimit));
+        }
+    }
+    YKFLogVerbose(@"Discarded the response of a cancelled command: %@", [frame ykf_hexadecimalString]);
+    self.hasPendingResponse = NO;
+    return YES;
+}
+
+/*
+ Reads and drops the bytes of the input stream until it stays quiet for the frame interval.
+ */
+- (void)drainInputStream {
+    UInt8 bytes[256];
+    do {
+        while (self.inputStream.hasBytesAvailable) {
+            if ([self.inputStream read:bytes maxLength:sizeof(bytes)] <= 0) {
+                return;
+            }
+        }
+    } while ([self waitForStreamEventWithDeadline:ykf_dispatch_deadline(YKFAccessoryConnectionFrameQuietInterval)]);
 }
 
 - (void)cancelAllCommands {
@@ -314,12 +549,10 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     
     [self.communicationQueue cancelAllOperations];
     
-    NSArray *keys = self.delayedDispatches.allKeys;
-    for (NSString *key in keys) {
-        dispatch_block_t block = self.delayedDispatches[key];
-        dispatch_block_cancel(block);
-    };
-    [self.delayedDispatches removeAllObjects];
+    // Wake up the command waiting for the streams to notice the cancellation.
+    dispatch_semaphore_signal(self.streamEventSemaphore);
+    
+    ykf_dispatch_cancel_delayed_blocks(self.delayedDispatches);
     
     dispatch_resume(self.communicationQueue.underlyingQueue);
     self.communicationQueue.suspended = NO;
@@ -327,6 +560,19 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
 
 #pragma mark - Helpers
 
+/*
+ A busy frame is read with its whole WTX, otherwise the last WTX byte would be read as the header of the next frame.
+ The 3 bytes frames with the busy header and 9000 are responses (see BUG #62 below).
+ */
+- (NSUInteger)minimumLengthOfFrame:(YKFResponseBuffer *)buffer {
+    const UInt8 *bytes = buffer.bytes;
+    if (bytes[0] != YKFAccessoryConnectionBusyHeader || buffer.length < YKFAccessoryConnectionMinimumResponseLength) {
+        return YKFAccessoryConnectionMinimumResponseLength;
+    }
+    BOOL statusIsSuccess = YKFLoadBigEndianUInt16(bytes + 1) == YKFAPDUErrorCodeNoError;
+    return statusIsSuccess ? YKFAccessoryConnectionMinimumResponseLength : YKFAccessoryConnectionBusyFrameLength;
+}
+
 /*
  Returns YES if the key returned a status code with the header 0x01 (key is busy processing the request).
  This status code is usually returned by CCID operations which require time to
@@ -346,7 +592,23 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     BOOL statusIsSuccess = [result ykf_getBigEndianIntegerInRange:NSMakeRange(result.length - 2, 2)] == YKFAPDUErrorCodeNoError;
     // ~
     
-    return headerByte == 0x01 && !statusIsSuccess;
+    return headerByte == YKFAccessoryConnectionBusyHeader && !statusIsSuccess;
+}
+
+/*
+ Returns the interval until the next frame announced by a busy frame. The WTX follows the header as a 3 byte big endian
+ number of milliseconds. Busy frames without a WTX or with a value out of bounds use the default interval.
+ */
+- (NSTimeInterval)waitingTimeExtensionFromBusyResult:(NSData *)result {
+    YKFParameterAssertReturnValue(result, YKFAccessoryConnectionDefaultWTX);
+    if (result.length < 4) {
+        return YKFAccessoryConnectionDefaultWTX;
+    }
+    NSTimeInterval waitingTimeExtension = YKFLoadBigEndian((const UInt8 *)result.bytes + 1, 3) / 1000.0;
+    if (waitingTimeExtension < YKFAccessoryConnectionMinimumWTX || waitingTimeExtension > YKFAccessoryConnectionMaximumWTX) {
+        return YKFAccessoryConnectionDefaultWTX;
+    }
+    return waitingTimeExtension;
 }
 
 - (NSData *)dataAndStatusFromKeyResponse:(NSData *)response {
@@ -354,17 +616,18 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     YKFAssertReturnValue(response.length >= 3, @"Key response data is too short.", [NSData data]);
     
     UInt8 *bytes = (UInt8 *)response.bytes;
-    YKFParameterAssertReturnValue(bytes[0] == 0x00 || bytes[0] == 0x01, [NSData data]);
+    YKFParameterAssertReturnValue(bytes[0] == YKFAccessoryConnectionResponseHeader || bytes[0] == YKFAccessoryConnectionBusyHeader, [NSData data]);
     
-    if (bytes[0] == 0x00) {
+    if (bytes[0] == YKFAccessoryConnectionResponseHeader) {
         // Remove the first byte (the YLP key protocol header)
         NSRange range = {1, response.length - 1};
-        return [response subdataWithRange:range];
+        return [response ykf_noCopySubdataWithRange:range];
     }
-    else if (bytes[0] == 0x01) {
+    else if (bytes[0] == YKFAccessoryConnectionBusyHeader) {
         // Remove the first byte (the YLP key protocol header) and the WTX
+        YKFAssertReturnValue(response.length >= 4, @"Key response data is too short.", [NSData data]);
         NSRange range = {4, response.length - 4};
-        return [response subdataWithRange:range];
+        return [response ykf_noCopySubdataWithRange:range];
     }
     
     return [NSData data];
@@ -61,6 +61,8 @@
 
 @implementation YKFNFCConnection
 
+@synthesize commandChainingEnabled = _commandChainingEnabled;
+
 - (instancetype)init {
     self = [super init];
     if (self) {
@@ -73,6 +75,11 @@
     return _nfcConnectionState;
 }
 
+- (void)setCommandChainingEnabled:(BOOL)commandChainingEnabled {
+    _commandChainingEnabled = commandChainingEnabled;
+    self.connectionController.commandChainingEnabled = commandChainingEnabled;
+}
+
 - (YKFSmartCardInterface *)smartCardInterface {
     if (!self.connectionController) {
         return nil;
@@ -346,6 +353,7 @@
             [self observeIso7816TagAvailability];
             
             self.connectionController = [[YKFNFCConnectionController alloc] initWithNFCTag:tag operationQueue:self.communicationQueue];
+            self.connectionController.commandChainingEnabled = self.commandChainingEnabled;
             [self.delegate didConnectNFC:self];
             
             self.tagDescription = [[YKFNFCTagDescription alloc] initWithTag: tag];
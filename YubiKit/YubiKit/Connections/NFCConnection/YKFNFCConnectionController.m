@@ -16,14 +16,20 @@
 #import "YKFNSMutableDataAdditions.h"
 #import "YKFBlockMacros.h"
 #import "YKFLogger.h"
+#import "YKFDispatch.h"
 #import "YKFAssert.h"
 #import "YKFSessionError.h"
 #import "YKFSessionError+Private.h"
 #import "YKFNSDataAdditions+Private.h"
 #import "YKFAPDU+Private.h"
+#import "YKFAPDUError.h"
 
 static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
 
+// The block and the APDU header fit in a single 256 bytes ISO-DEP frame (with the PCB and CRC), so every chained
+// block is sent by the reader without ISO-DEP chaining.
+static NSUInteger const YKFNFCConnectionCommandChainingBlockSize = 248; // bytes
+
 @interface YKFNFCConnectionController()
 
 @property (nonatomic) NSOperationQueue *communicationQueue;
@@ -35,6 +41,8 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
 
 @implementation YKFNFCConnectionController
 
+@synthesize commandChainingEnabled;
+
 - (instancetype)initWithNFCTag:(id<NFCISO7816Tag>)tag operationQueue:(NSOperationQueue *)operationQueue {
     self = [super init];
     if (self) {
@@ -45,6 +53,15 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
     return self;
 }
 
+- (NSUInteger)commandChainingBlockSize {
+    return YKFNFCConnectionCommandChainingBlockSize;
+}
+
+- (BOOL)supportsExtendedLength {
+    // Core NFC sends the extended APDUs as they are, the YubiKey accepts them over ISO-DEP.
+    return YES;
+}
+
 #pragma mark - Commands
 
 - (void)execute:(nonnull YKFAPDU *)command completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
@@ -60,65 +77,121 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
     ykf_weak_self();
     [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
         ykf_safe_strong_self();
-      
-        // Do not wait for the command to process if the operation was canceled.
-        if (operation.isCancelled) {
-            return;
-        }
+        uint64_t commandStartTime = ykf_monotonic_time();
+        
+        NSError *executionError = nil;
+        NSData *executionResult = [strongSelf transmitCommand:command timeout:timeout operation:operation error:&executionError];
         
-        // Check availability before executing. If the command is queued, the tag may become unavailable at execution time.
-        if (!strongSelf.tag.isAvailable) {
-            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost], 0);
+        // Do not notify if the operation was canceled.
+        if (operation.isCancelled) {
             return;
         }
-                
-        NFCISO7816APDU *cnApdu = [[NFCISO7816APDU alloc] initWithData:command.apduData];
-        YKFAssertReturn(cnApdu, @"Could not create a Core NFC APDU object from the command data.");
-
-        __block NSError *executionError = nil;
-        __block NSData *executionResult = nil;
-        NSDate *commandStartDate = [NSDate date];
-        dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
-        YKFLogVerbose(@"Sent(NFC): %@", [command.apduData ykf_hexadecimalString]);
-
-        [strongSelf.tag sendCommandAPDU:cnApdu completionHandler:^(NSData *responseData, uint8_t sw1, uint8_t sw2, NSError *error) {
-            if (error) {
-                executionError = error;
-                dispatch_semaphore_signal(executionSemaphore);
-                return;
-            }
-            
 
-            NSMutableData *fullResponse = [[NSMutableData alloc] initWithData:responseData];
-            [fullResponse ykf_appendByte:sw1];
-            [fullResponse ykf_appendByte:sw2];
-            executionResult = [fullResponse copy];
+        NSTimeInterval executionTime = ykf_elapsed_time_since(commandStartTime);
+        completion(executionResult, executionError, executionTime);
+        
+        YKFLogVerbose(@"Command execution time: %lf seconds", executionTime);
+    }];
+}
 
-            YKFLogVerbose(@"Received(NFC): %@", [executionResult ykf_hexadecimalString]);
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    [self executeBatch:commands timeout:YKFNFCConnectionDefaultTimeout completion:completion];
+}
 
-            dispatch_semaphore_signal(executionSemaphore);
-        }];
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    YKFParameterAssertReturn(commands);
+    YKFParameterAssertReturn(completion);
+    
+    YKFLogVerbose(@"NFCConnectionController - Execute batch of %lu commands...", (unsigned long)commands.count);
+    
+    ykf_weak_self();
+    [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+        ykf_safe_strong_self();
+        uint64_t batchStartTime = ykf_monotonic_time();
+        NSMutableArray<NSData *> *responses = [[NSMutableArray alloc] initWithCapacity:commands.count];
+        NSError *executionError = nil;
         
-        // Lock the async call to enforce the sequential execution using the library dispatch queue.
-        if(dispatch_semaphore_wait(executionSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0) {
-            executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
+        for (YKFAPDU *command in commands) {
+            NSData *executionResult = [strongSelf transmitCommand:command timeout:timeout operation:operation error:&executionError];
+            if (operation.isCancelled) {
+                return;
+            }
+            if (!executionResult) {
+                break;
+            }
+            [responses addObject:executionResult];
+            if (![executionResult ykf_isSuccessfulAPDUResponse]) {
+                break;
+            }
         }
         
-        // Do not notify if the operation was canceled.
-        if (operation.isCancelled) {
-            return;
+        NSTimeInterval executionTime = ykf_elapsed_time_since(batchStartTime);
+        completion(responses, executionError, executionTime);
+        
+        YKFLogVerbose(@"Batch execution time: %lf seconds", executionTime);
+    }];
+}
+
+/*
+ Sends the command to the tag and waits for the response on the communication queue. Returns the data and status of
+ the response, or nil when the command failed or was cancelled. The error is not set when the command was cancelled.
+ */
+- (NSData *)transmitCommand:(YKFAPDU *)command timeout:(NSTimeInterval)timeout operation:(NSOperation *)operation error:(NSError **)error {
+    // Do not wait for the command to process if the operation was canceled.
+    if (operation.isCancelled) {
+        return nil;
+    }
+    
+    // Check availability before executing. If the command is queued, the tag may become unavailable at execution time.
+    if (!self.tag.isAvailable) {
+        if (error) {
+            *error = [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost];
         }
+        return nil;
+    }
+            
+    NFCISO7816APDU *cnApdu = [[NFCISO7816APDU alloc] initWithData:command.apduData];
+    YKFAssertReturnValue(cnApdu, @"Could not create a Core NFC APDU object from the command data.", nil);
 
-        NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-        if (executionError) {
-            completion(nil, executionError, executionTime);
-        } else {
-            YKFAssertReturn(executionResult, @"The command did not return any response data when error was not nil.");
-            completion(executionResult, nil, executionTime);
+    __block NSError *executionError = nil;
+    __block NSData *executionResult = nil;
+    dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
+    YKFLogVerbose(@"Sent(NFC): %@", [command.apduData ykf_hexadecimalString]);
+
+    [self.tag sendCommandAPDU:cnApdu completionHandler:^(NSData *responseData, uint8_t sw1, uint8_t sw2, NSError *error) {
+        if (error) {
+            executionError = error;
+            dispatch_semaphore_signal(executionSemaphore);
+            return;
         }
         
-        YKFLogVerbose(@"Command execution time: %lf seconds", executionTime);
+
+        NSMutableData *fullResponse = [[NSMutableData alloc] initWithData:responseData];
+        [fullResponse ykf_appendByte:sw1];
+        [fullResponse ykf_appendByte:sw2];
+        executionResult = [fullResponse copy];
+
+        YKFLogVerbose(@"Received(NFC): %@", [executionResult ykf_hexadecimalString]);
+
+        dispatch_semaphore_signal(executionSemaphore);
     }];
+    
+    // Lock the async call to enforce the sequential execution using the library dispatch queue.
+    if(dispatch_semaphore_wait(executionSemaphore, ykf_dispatch_deadline(timeout)) != 0) {
+        executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
+    }
+    
+    if (operation.isCancelled) {
+        return nil;
+    }
+    if (executionError) {
+        if (error) {
+            *error = executionError;
+        }
+        return nil;
+    }
+    YKFAssertReturnValue(executionResult, @"The command did not return any response data when error was not nil.", nil);
+    return executionResult;
 }
 
 - (void)closeConnectionWithCompletion:(nonnull YKFConnectionControllerCompletionBlock)completion {
@@ -132,12 +205,7 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
     
     [self.communicationQueue cancelAllOperations];
     
-    NSArray *keys = self.delayedDispatches.allKeys;
-    for (NSString *key in keys) {
-        dispatch_block_t block = self.delayedDispatches[key];
-        dispatch_block_cancel(block);
-    };
-    [self.delayedDispatches removeAllObjects];
+    ykf_dispatch_cancel_delayed_blocks(self.delayedDispatches);
     
     dispatch_resume(self.communicationQueue.underlyingQueue);
     self.communicationQueue.suspended = NO;
@@ -162,4 +230,19 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
     [self.communicationQueue addOperation:operation];
 }
 
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block delay:(NSTimeInterval)delay {
+    YKFParameterAssertReturn(block);
+    
+    if (delay <= 0) {
+        [self dispatchBlockOnCommunicationQueue:block];
+        return;
+    }
+    
+    ykf_weak_self();
+    ykf_dispatch_after_cancellable(delay, self.communicationQueue, self.delayedDispatches, ^{
+        ykf_safe_strong_self();
+        [strongSelf dispatchBlockOnCommunicationQueue:block];
+    });
+}
+
 @end
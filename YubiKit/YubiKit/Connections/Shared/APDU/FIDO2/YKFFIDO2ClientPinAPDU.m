@@ -16,6 +16,7 @@
 #import "YKFFIDO2ClientPinRequest.h"
 #import "YKFCBOREncoder.h"
 #import "YKFCBORType.h"
+#import "YKFCBORMapSchema.h"
 #import "YKFAssert.h"
 
 typedef NS_ENUM(NSUInteger, YKFFIDO2ClientPinAPDUKey) {
@@ -29,6 +30,15 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2ClientPinAPDUKey) {
 
 @implementation YKFFIDO2ClientPinAPDU
 
++ (YKFCBORMapSchema *)requestSchema {
+    static YKFCBORMapSchema *schema = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schema = [[YKFCBORMapSchema alloc] initWithIntegerKeyCount:YKFFIDO2ClientPinAPDUKeyPinHashEnc];
+    });
+    return schema;
+}
+
 - (instancetype)initWithRequest:(YKFFIDO2ClientPinRequest *)request {
     YKFAssertAbortInit(request);
     YKFAssertAbortInit(request.subCommand >= 0x01 && request.subCommand <= 0x05)
@@ -39,25 +49,25 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2ClientPinAPDUKey) {
         YKFAssertAbortInit(request.pinHashEnc);
     }
     
-    NSMutableDictionary *requestDictionary = [[NSMutableDictionary alloc] init];
+    YKFCBORSchemaMap *requestMap = YKFCBORSchemaMap([self.class requestSchema]);
     
-    requestDictionary[YKFCBORInteger(YKFFIDO2ClientPinAPDUKeyPinProtocol)] = YKFCBORInteger(request.pinProtocol);
-    requestDictionary[YKFCBORInteger(YKFFIDO2ClientPinAPDUKeySubCommand)] = YKFCBORInteger(request.subCommand);
+    [requestMap setObject:YKFCBORInteger(request.pinProtocol) forIntegerKey:YKFFIDO2ClientPinAPDUKeyPinProtocol];
+    [requestMap setObject:YKFCBORInteger(request.subCommand) forIntegerKey:YKFFIDO2ClientPinAPDUKeySubCommand];
     
     if (request.keyAgreement) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2ClientPinAPDUKeyKeyAgreement)] = request.keyAgreement;
+        [requestMap setObject:request.keyAgreement forIntegerKey:YKFFIDO2ClientPinAPDUKeyKeyAgreement];
     }
     if (request.pinAuth) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2ClientPinAPDUKeyPinAuth)] = YKFCBORByteString(request.pinAuth);
+        [requestMap setObject:YKFCBORByteString(request.pinAuth) forIntegerKey:YKFFIDO2ClientPinAPDUKeyPinAuth];
     }
     if (request.pinEnc) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2ClientPinAPDUKeyPinEnc)] = YKFCBORByteString(request.pinEnc);
+        [requestMap setObject:YKFCBORByteString(request.pinEnc) forIntegerKey:YKFFIDO2ClientPinAPDUKeyPinEnc];
     }
     if (request.pinHashEnc) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2ClientPinAPDUKeyPinHashEnc)] = YKFCBORByteString(request.pinHashEnc);
+        [requestMap setObject:YKFCBORByteString(request.pinHashEnc) forIntegerKey:YKFFIDO2ClientPinAPDUKeyPinHashEnc];
     }
     
-    NSData *cborData = [YKFCBOREncoder encodeMap:YKFCBORMap(requestDictionary)];
+    NSData *cborData = [YKFCBOREncoder encodeObjectInSingleBuffer:requestMap];
     YKFAssertAbortInit(cborData);
     
     return [super initWithCommand:YKFFIDO2CommandClientPIN data:cborData];
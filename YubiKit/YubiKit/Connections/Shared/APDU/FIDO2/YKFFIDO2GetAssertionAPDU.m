@@ -15,6 +15,7 @@
 #import "YKFFIDO2GetAssertionAPDU.h"
 #import "YKFCBORType.h"
 #import "YKFCBOREncoder.h"
+#import "YKFCBORMapSchema.h"
 #import "YKFAssert.h"
 #import "YKFFIDO2Type.h"
 #import "YKFFIDO2Type+Private.h"
@@ -31,6 +32,15 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionAPDUKey) {
 
 @implementation YKFFIDO2GetAssertionAPDU
 
++ (YKFCBORMapSchema *)requestSchema {
+    static YKFCBORMapSchema *schema = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schema = [[YKFCBORMapSchema alloc] initWithIntegerKeyCount:YKFFIDO2GetAssertionAPDUKeyPinProtocol];
+    });
+    return schema;
+}
+
 - (nullable instancetype)initWithClientDataHash:(NSData *)clientDataHash
                                            rpId:(NSString *)rpId
                                       allowList:(NSArray * _Nullable)allowList
@@ -40,13 +50,13 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionAPDUKey) {
     YKFAssertAbortInit(clientDataHash);
     YKFAssertAbortInit(rpId);
     
-    NSMutableDictionary *requestDictionary = [[NSMutableDictionary alloc] init];
+    YKFCBORSchemaMap *requestMap = YKFCBORSchemaMap([self.class requestSchema]);
     
     // RP
-    requestDictionary[YKFCBORInteger(YKFFIDO2GetAssertionAPDUKeyRp)] = YKFCBORTextString(rpId);
+    [requestMap setObject:YKFCBORTextString(rpId) forIntegerKey:YKFFIDO2GetAssertionAPDUKeyRp];
     
     // Client Data Hash
-    requestDictionary[YKFCBORInteger(YKFFIDO2GetAssertionAPDUKeyClientDataHash)] = YKFCBORByteString(clientDataHash);
+    [requestMap setObject:YKFCBORByteString(clientDataHash) forIntegerKey:YKFFIDO2GetAssertionAPDUKeyClientDataHash];
     
     // Allow List
     if (allowList) {
@@ -54,7 +64,7 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionAPDUKey) {
         for (YKFFIDO2PublicKeyCredentialDescriptor *credentialDescriptor in allowList) {
             [mutableAllowList addObject:[credentialDescriptor cborTypeObject]];
         }
-        requestDictionary[YKFCBORInteger(YKFFIDO2GetAssertionAPDUKeyAllowList)] = YKFCBORArray(mutableAllowList);
+        [requestMap setObject:YKFCBORArray(mutableAllowList) forIntegerKey:YKFFIDO2GetAssertionAPDUKeyAllowList];
     }
     
     // Options
@@ -65,20 +75,20 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionAPDUKey) {
             NSNumber *value = options[optionKey];
             mutableOptions[YKFCBORTextString(optionKey)] = YKFCBORBool(value.boolValue);
         }
-        requestDictionary[YKFCBORInteger(YKFFIDO2GetAssertionAPDUKeyOptions)] = YKFCBORMap(mutableOptions);
+        [requestMap setObject:YKFCBORMap(mutableOptions) forIntegerKey:YKFFIDO2GetAssertionAPDUKeyOptions];
     }
 
     // Pin Auth
     if (pinAuth) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2GetAssertionAPDUKeyPinAuth)] = YKFCBORByteString(pinAuth);
+        [requestMap setObject:YKFCBORByteString(pinAuth) forIntegerKey:YKFFIDO2GetAssertionAPDUKeyPinAuth];
     }
 
     // Pin Protocol
     if (pinProtocol) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2GetAssertionAPDUKeyPinProtocol)] = YKFCBORInteger(pinProtocol);
+        [requestMap setObject:YKFCBORInteger(pinProtocol) forIntegerKey:YKFFIDO2GetAssertionAPDUKeyPinProtocol];
     }
     
-    NSData *cborData = [YKFCBOREncoder encodeMap:YKFCBORMap(requestDictionary)];
+    NSData *cborData = [YKFCBOREncoder encodeObjectInSingleBuffer:requestMap];
     YKFAssertAbortInit(cborData);
     
     return [super initWithCommand:YKFFIDO2CommandGetAssertion data:cborData];
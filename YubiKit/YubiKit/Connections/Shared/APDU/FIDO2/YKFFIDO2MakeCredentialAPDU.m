@@ -14,6 +14,7 @@
 
 #import "YKFFIDO2MakeCredentialAPDU.h"
 #import "YKFCBOREncoder.h"
+#import "YKFCBORMapSchema.h"
 #import "YKFAssert.h"
 #import "YKFFIDO2Type.h"
 #import "YKFFIDO2Type+Private.h"
@@ -32,6 +33,15 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2MakeCredentialAPDUKey) {
 
 @implementation YKFFIDO2MakeCredentialAPDU
 
++ (YKFCBORMapSchema *)requestSchema {
+    static YKFCBORMapSchema *schema = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schema = [[YKFCBORMapSchema alloc] initWithIntegerKeyCount:YKFFIDO2MakeCredentialAPDUKeyPinProtocol];
+    });
+    return schema;
+}
+
 - (nullable instancetype)initWithClientDataHash:(NSData *)clientDataHash
                                              rp:(YKFFIDO2PublicKeyCredentialRpEntity *)rp
                                            user:(YKFFIDO2PublicKeyCredentialUserEntity *)user
@@ -46,23 +56,23 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2MakeCredentialAPDUKey) {
     YKFAssertAbortInit(user);
     YKFAssertAbortInit(pubKeyCredParams);
     
-    NSMutableDictionary *requestDictionary = [[NSMutableDictionary alloc] init];
+    YKFCBORSchemaMap *requestMap = YKFCBORSchemaMap([self.class requestSchema]);
     
     // Client Data Hash
-    requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyClientDataHash)] = YKFCBORByteString(clientDataHash);
+    [requestMap setObject:YKFCBORByteString(clientDataHash) forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyClientDataHash];
     
     // RP
-    requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyRp)] = [rp cborTypeObject];
+    [requestMap setObject:[rp cborTypeObject] forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyRp];
     
     // User
-    requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyUser)] = [user cborTypeObject];
+    [requestMap setObject:[user cborTypeObject] forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyUser];
     
     // PubKeyCredParams
     NSMutableArray *mutablePubKeyCredParams = [[NSMutableArray alloc] initWithCapacity:pubKeyCredParams.count];
     for (YKFFIDO2PublicKeyCredentialType *credentialType in pubKeyCredParams) {
         [mutablePubKeyCredParams addObject:[credentialType cborTypeObject]];
     }
-    requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyPubKeyCredParams)] = YKFCBORArray(mutablePubKeyCredParams);
+    [requestMap setObject:YKFCBORArray(mutablePubKeyCredParams) forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyPubKeyCredParams];
     
     // ExcludeList
     if (excludeList) {
@@ -70,7 +80,7 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2MakeCredentialAPDUKey) {
         for (YKFFIDO2PublicKeyCredentialDescriptor *descriptor in excludeList) {
             [mutableExcludeList addObject:[descriptor cborTypeObject]];
         }
-        requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyExcludeList)] = YKFCBORArray(mutableExcludeList);
+        [requestMap setObject:YKFCBORArray(mutableExcludeList) forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyExcludeList];
     }
     
     // Options
@@ -81,20 +91,20 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2MakeCredentialAPDUKey) {
             NSNumber *value = options[optionKey];
             mutableOptions[YKFCBORTextString(optionKey)] = YKFCBORBool(value.boolValue);
         }
-        requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyOptions)] = YKFCBORMap(mutableOptions);
+        [requestMap setObject:YKFCBORMap(mutableOptions) forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyOptions];
     }
     
     // Pin Auth
     if (pinAuth) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyPinAuth)] = YKFCBORByteString(pinAuth);
+        [requestMap setObject:YKFCBORByteString(pinAuth) forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyPinAuth];
     }
     
     // Pin Protocol
     if (pinProtocol) {
-        requestDictionary[YKFCBORInteger(YKFFIDO2MakeCredentialAPDUKeyPinProtocol)] = YKFCBORInteger(pinProtocol);
+        [requestMap setObject:YKFCBORInteger(pinProtocol) forIntegerKey:YKFFIDO2MakeCredentialAPDUKeyPinProtocol];
     }
 
-    NSData *cborData = [YKFCBOREncoder encodeMap:YKFCBORMap(requestDictionary)];
+    NSData *cborData = [YKFCBOREncoder encodeObjectInSingleBuffer:requestMap];
     YKFAssertAbortInit(cborData);
     
     return [super initWithCommand:YKFFIDO2CommandMakeCredential data:cborData];
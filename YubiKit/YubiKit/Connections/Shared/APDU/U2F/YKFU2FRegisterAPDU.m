@@ -17,6 +17,7 @@
 #import "YKFNSDataAdditions.h"
 #import "YKFAssert.h"
 #import "YKFNSDataAdditions+Private.h"
+#import "YKFNSMutableDataAdditions.h"
 
 /*
  DOMString typ as defined in FIDO U2F Raw Message Format
@@ -43,15 +44,18 @@ static const UInt8 YKFU2FRegisterAPDUEnforceUserPresenceAndSign = 0x03;
      https://fidoalliance.org/specs/u2f-specs-1.0-bt-nfc-id-amendment/fido-u2f-raw-message-formats.html
      Note: The "cid_pubkey" is missing in this case since the TLS stack on iOS does not support channel id.
      */
-    NSDictionary *jsonDictionary = @{@"type": U2FClientDataTypeRegistration,
-                                     @"challenge": challenge,
-                                     @"origin": appId};
-    NSError *error = nil;
-    NSData *jsonData = [NSJSONSerialization dataWithJSONObject:jsonDictionary options:0 error:&error];
+    NSMutableData *jsonData = [[NSMutableData alloc] initWithCapacity:64 + challenge.length + appId.length * 3];
+    [jsonData ykf_appendUTF8String:@"{\"type\":"];
+    [jsonData ykf_appendJSONString:U2FClientDataTypeRegistration];
+    [jsonData ykf_appendUTF8String:@",\"challenge\":"];
+    [jsonData ykf_appendJSONString:challenge];
+    [jsonData ykf_appendUTF8String:@",\"origin\":"];
+    [jsonData ykf_appendJSONString:appId];
+    [jsonData ykf_appendUTF8String:@"}"];
     self.clientData = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
     YKFAssertAbortInit(self.clientData)
     
-    NSData *challengeSHA256 = [[self.clientData dataUsingEncoding:NSUTF8StringEncoding] ykf_SHA256];
+    NSData *challengeSHA256 = [jsonData ykf_SHA256];
     YKFAssertAbortInit(challengeSHA256);
     
     NSData *applicationSHA256 = [[appId dataUsingEncoding:NSUTF8StringEncoding] ykf_SHA256];
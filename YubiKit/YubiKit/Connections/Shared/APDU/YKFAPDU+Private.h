@@ -14,6 +14,11 @@
 
 @interface YKFAPDU()
 
+/*!
+ Creates an extended APDU which asks for the whole response in one exchange, with the maximum extended Le (65536 bytes).
+ */
+- (nullable instancetype)initExtendedWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(nonnull NSData *)data;
+
 /*!
  The APDU raw data which cotains the YubiKey iAP2 Protocol framing.
  */
@@ -24,4 +29,29 @@ The APDU raw data.
 */
 @property (nonatomic, readonly) NSData *apduData;
 
+/*!
+ The command header, as passed to [initWithCla:ins:p1:p2:data:type:].
+ */
+@property (nonatomic, readonly) UInt8 cla;
+@property (nonatomic, readonly) UInt8 ins;
+@property (nonatomic, readonly) UInt8 p1;
+@property (nonatomic, readonly) UInt8 p2;
+
+/*!
+ The type of the command, as passed to [initWithCla:ins:p1:p2:data:type:].
+ */
+@property (nonatomic, readonly) YKFAPDUType type;
+
+/*!
+ The command data as a slice of apduData, or nil for the APDUs created with pre-built data, which are not parsed
+ and cannot be split with command chaining.
+ */
+@property (nonatomic, readonly) NSData *commandData;
+
+/*!
+ YES for the commands which can return more than a short response (256 bytes). When the key and the transport support
+ extended APDUs, only these commands are sent with the extended Le.
+ */
+@property (nonatomic, assign) BOOL mayReturnLongResponse;
+
 @end
@@ -14,14 +14,25 @@
 
 #import "YKFAPDU.h"
 #import "YKFAccessoryConnectionController.h"
-#import "YKFNSMutableDataAdditions.h"
+#import "YKFNSDataAdditions+Private.h"
 #import "YKFAssert.h"
+#import "YKFByteSpan.h"
+
+static NSUInteger const YKFAPDUHeaderLength = 4; // CLA, INS, P1, P2
+static UInt8 const YKFAPDUYLPSignal = 0x00;      // YLP iAP2 Signal
 
 @interface YKFAPDU()
 
 @property (nonatomic, readwrite) NSData *ylpApduData;
 @property (nonatomic, readwrite) NSData *apduData;
 
+@property (nonatomic, readwrite) UInt8 cla;
+@property (nonatomic, readwrite) UInt8 ins;
+@property (nonatomic, readwrite) UInt8 p1;
+@property (nonatomic, readwrite) UInt8 p2;
+@property (nonatomic, readwrite) YKFAPDUType type;
+@property (nonatomic, readwrite) NSData *commandData;
+
 @end
 
 @implementation YKFAPDU
@@ -37,84 +48,137 @@
     
     self = [super init];
     if (self) {
+        self.cla = cla;
+        self.ins = ins;
+        self.p1 = p1;
+        self.p2 = p2;
+        self.type = type;
+        
+        BOOL setup = NO;
         switch (type) {
             case YKFAPDUTypeShort:
-                [self setupApduWithCla:cla ins:ins p1:p1 p2:p2 data:data];
+                setup = [self setupApduWithCla:cla ins:ins p1:p1 p2:p2 data:data];
                 break;
             case YKFAPDUTypeExtended:
             default:
-                [self setupExtendedApduWithCla:cla ins:ins p1:p1 p2:p2 data:data];
+                setup = [self setupExtendedApduWithCla:cla ins:ins p1:p1 p2:p2 data:data le:NO];
                 break;
         }
+        YKFAbortInitWhen(!setup)
     }
     return self;
 }
 
-- (void)setupApduWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData*)data {
-    NSMutableData *command = [[NSMutableData alloc] init];
+- (instancetype)initExtendedWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData *)data {
+    YKFAssertAbortInit(data.length <= UINT16_MAX)
     
-    [command ykf_appendByte:cla];   // APDU CLA
-    [command ykf_appendByte:ins];   // APDU INS
-    [command ykf_appendByte:p1];    // APDU P1
-    [command ykf_appendByte:p2];    // APDU P2
+    self = [super init];
+    if (self) {
+        self.cla = cla;
+        self.ins = ins;
+        self.p1 = p1;
+        self.p2 = p2;
+        self.type = YKFAPDUTypeExtended;
+        YKFAbortInitWhen(![self setupExtendedApduWithCla:cla ins:ins p1:p1 p2:p2 data:data le:YES])
+    }
+    return self;
+}
 
-    if (data.length) {
-        UInt8 length = data.length;
-        [command ykf_appendByte:length];    // LenLc
-        [command appendData:data];          // Data
+/*
+ The command is serialized once, after one byte of headroom for the YLP iAP2 signal. ylpApduData is the whole buffer
+ and apduData and commandData are slices of it, so building a command copies the data only once.
+ */
+- (BOOL)setupApduWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData*)data {
+    NSUInteger length = YKFAPDUHeaderLength + (data.length ? 1 + data.length : 0);
+    YKFByteWriter writer;
+    if (![self setupBufferWriter:&writer length:length]) {
+        return NO;
     }
     
-    self.apduData = [command copy];
+    YKFByteWriterWriteUInt8(&writer, cla);  // APDU CLA
+    YKFByteWriterWriteUInt8(&writer, ins);  // APDU INS
+    YKFByteWriterWriteUInt8(&writer, p1);   // APDU P1
+    YKFByteWriterWriteUInt8(&writer, p2);   // APDU P2
     
-    NSMutableData *ylpCommand = [[NSMutableData alloc] initWithCapacity:command.length + 1];
-    [ylpCommand ykf_appendByte:0x00]; // YLP iAP2 Signal
-    [ylpCommand appendData:command];
-    self.ylpApduData = [ylpCommand copy];
+    if (data.length) {
+        YKFByteWriterWriteUInt8(&writer, data.length);              // LenLc
+        YKFByteWriterWriteBytes(&writer, data.bytes, data.length);  // Data
+    }
     
+    [self setupWithBufferWriter:&writer dataRange:NSMakeRange(YKFAPDUHeaderLength + 1, data.length)];
+    return YES;
 }
 
-- (void)setupExtendedApduWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData *)data {
-    NSMutableData *command = [[NSMutableData alloc] init];
+/*
+ Without data the 3 length bytes are zero, which is also the extended Le for the maximum response length. With data,
+ le appends the 2 bytes extended Le for the maximum response length after the data.
+ */
+- (BOOL)setupExtendedApduWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData *)data le:(BOOL)le {
+    BOOL appendsLe = le && data.length;
+    NSUInteger length = YKFAPDUHeaderLength + 3 + data.length + (appendsLe ? 2 : 0);
+    YKFByteWriter writer;
+    if (![self setupBufferWriter:&writer length:length]) {
+        return NO;
+    }
     
-    [command ykf_appendByte:cla];   // APDU CLA
-    [command ykf_appendByte:ins];   // APDU INS
-    [command ykf_appendByte:p1];    // APDU P1
-    [command ykf_appendByte:p2];    // APDU P2
+    YKFByteWriterWriteUInt8(&writer, cla);  // APDU CLA
+    YKFByteWriterWriteUInt8(&writer, ins);  // APDU INS
+    YKFByteWriterWriteUInt8(&writer, p1);   // APDU P1
+    YKFByteWriterWriteUInt8(&writer, p2);   // APDU P2
     
-    if (data.length) {
-        UInt8 lengthHigh = data.length / 256;
-        UInt8 lengthLow = data.length % 256;
-        [command ykf_appendByte:0x00];           // APDU Zero
-        [command ykf_appendByte:lengthHigh];     // LenH
-        [command ykf_appendByte:lengthLow];      // LenL
-        [command appendData:data];               // Data
-    } else {
-        [command ykf_appendByte:0x00];           // APDU Zero
-        [command ykf_appendByte:0x00];           // LenH
-        [command ykf_appendByte:0x00];           // LenL
+    YKFByteWriterWriteUInt8(&writer, 0x00);                     // APDU Zero
+    YKFByteWriterWriteUInt16(&writer, data.length);             // LenH LenL
+    YKFByteWriterWriteBytes(&writer, data.bytes, data.length);  // Data
+    if (appendsLe) {
+        YKFByteWriterWriteUInt16(&writer, 0x0000);              // LeH LeL
     }
     
-    self.apduData = [command copy];
-    
-    NSMutableData *ylpCommand = [[NSMutableData alloc] initWithCapacity:command.length + 1];
-    [ylpCommand ykf_appendByte:0x00]; // YLP iAP2 Signal
-    [ylpCommand appendData:command];
-    self.ylpApduData = [ylpCommand copy];
+    [self setupWithBufferWriter:&writer dataRange:NSMakeRange(YKFAPDUHeaderLength + 3, data.length)];
+    return YES;
 }
 
 - (nullable instancetype)initWithData:(nonnull NSData *)data {
     YKFAssertAbortInit(data.length);
     self = [super init];
     if (self) {
+        // Keep the pre-built data as the APDU data (copy is a retain for immutable data), the YLP view needs its own
+        // buffer because of the leading signal byte.
         self.apduData = [data copy];
         
-        // Append the YLP iAP2 Signal for the ylpApduData.
-        NSMutableData *tempBuffer = [[NSMutableData alloc] initWithCapacity:data.length + 1];
-        [tempBuffer ykf_appendByte:0x00];
-        [tempBuffer appendData:data];
-        self.ylpApduData = [tempBuffer copy];
+        UInt8 *bytes = malloc(data.length + 1);
+        YKFAssertAbortInit(bytes);
+        bytes[0] = YKFAPDUYLPSignal;
+        memcpy(bytes + 1, self.apduData.bytes, data.length);
+        self.ylpApduData = [[NSData alloc] initWithBytesNoCopy:bytes length:data.length + 1 freeWhenDone:YES];
     }
     return self;
 }
 
+#pragma mark - Helpers
+
+/*
+ Allocates the buffer for a command of length bytes and the YLP signal, and sets up the writer positioned after the
+ signal. Returns NO if the buffer could not be allocated.
+ */
+- (BOOL)setupBufferWriter:(YKFByteWriter *)writer length:(NSUInteger)length {
+    UInt8 *bytes = malloc(length + 1);
+    YKFAssertReturnValue(bytes, @"Could not allocate the APDU buffer.", NO);
+    
+    *writer = YKFByteWriterMake(bytes, length + 1);
+    YKFByteWriterWriteUInt8(writer, YKFAPDUYLPSignal);
+    return YES;
+}
+
+/*
+ Takes the ownership of the buffer filled by the writer and sets up the views of the command. The data range is
+ relative to apduData.
+ */
+- (void)setupWithBufferWriter:(YKFByteWriter *)writer dataRange:(NSRange)dataRange {
+    NSAssert(!writer->overflow && writer->length == writer->capacity, @"The APDU buffer was not filled.");
+    
+    self.ylpApduData = [[NSData alloc] initWithBytesNoCopy:writer->bytes length:writer->length freeWhenDone:YES];
+    self.apduData = [self.ylpApduData ykf_noCopySubdataWithRange:NSMakeRange(1, writer->length - 1)];
+    self.commandData = dataRange.length ? [self.apduData ykf_noCopySubdataWithRange:dataRange] : [NSData data];
+}
+
 @end
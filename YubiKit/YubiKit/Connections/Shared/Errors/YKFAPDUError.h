@@ -31,7 +31,8 @@ typedef NS_ENUM(NSUInteger, YKFAPDUErrorCode) {
     
     // Application/Applet short codes
     
-    YKFAPDUErrorCodeMoreData                 = 0x61 // 0x61XX
+    YKFAPDUErrorCodeMoreData                 = 0x61, // 0x61XX
+    YKFAPDUErrorCodeWrongLe                  = 0x6C  // 0x6CXX
 };
 
 NS_ASSUME_NONNULL_BEGIN
@@ -13,7 +13,7 @@
 // limitations under the License.
 
 #import "YKFFIDO2ClientPinResponse.h"
-#import "YKFCBORDecoder.h"
+#import "YKFCBORFieldDecoder.h"
 #import "YKFAssert.h"
 
 typedef NS_ENUM(NSUInteger, YKFFIDO2ClientPinResponseKey) {
@@ -22,6 +22,19 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2ClientPinResponseKey) {
     YKFFIDO2ClientPinResponseKeyRetries      = 0x03
 };
 
+typedef NS_ENUM(NSUInteger, YKFFIDO2ClientPinResponseField) {
+    YKFFIDO2ClientPinResponseFieldKeyAgreement,
+    YKFFIDO2ClientPinResponseFieldPinToken,
+    YKFFIDO2ClientPinResponseFieldRetries,
+    YKFFIDO2ClientPinResponseFieldCount
+};
+
+static const YKFCBORField YKFFIDO2ClientPinResponseFields[YKFFIDO2ClientPinResponseFieldCount] = {
+    [YKFFIDO2ClientPinResponseFieldKeyAgreement] = {.integerKey = YKFFIDO2ClientPinResponseKeyKeyAgreement, .type = YKFCBORFieldTypeMap},
+    [YKFFIDO2ClientPinResponseFieldPinToken] = {.integerKey = YKFFIDO2ClientPinResponsePinToken, .type = YKFCBORFieldTypeByteString},
+    [YKFFIDO2ClientPinResponseFieldRetries] = {.integerKey = YKFFIDO2ClientPinResponseKeyRetries, .type = YKFCBORFieldTypeUnsignedInteger}
+};
+
 @interface YKFFIDO2ClientPinResponse()
 
 @property (nonatomic, readwrite) NSDictionary *keyAgreement;
@@ -35,34 +48,33 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2ClientPinResponseKey) {
 - (nullable instancetype)initWithCBORData:(NSData *)cborData {
     self = [super init];
     if (self) {
-        YKFCBORMap *responseMap = nil;
-        
-        NSInputStream *decoderInputStream = [[NSInputStream alloc] initWithData:cborData];
-        [decoderInputStream open];
-        responseMap = [YKFCBORDecoder decodeObjectFrom:decoderInputStream];
-        [decoderInputStream close];
+        YKFAssertAbortInit(cborData);
         
-        YKFAssertAbortInit(responseMap);
-        
-        BOOL success = [self parseResponseMap: responseMap];
+        BOOL success = [self parseResponseData:[cborData copy]];
         YKFAssertAbortInit(success);
     }
     return self;
 }
 
-- (BOOL)parseResponseMap:(YKFCBORMap *)map {
-    id convertedObject = [YKFCBORDecoder convertCBORObjectToFoundationType:map];
-    if (!convertedObject || ![convertedObject isKindOfClass:NSDictionary.class]) {
+- (BOOL)parseResponseData:(NSData *)data {
+    YKFCBORFieldValue values[YKFFIDO2ClientPinResponseFieldCount];
+    BOOL success = [YKFCBORFieldDecoder decodeMapFromData:data fields:YKFFIDO2ClientPinResponseFields
+                                                    count:YKFFIDO2ClientPinResponseFieldCount values:values];
+    if (!success) {
+        return NO;
+    }
+    
+    const YKFCBORFieldValue *keyAgreement = &values[YKFFIDO2ClientPinResponseFieldKeyAgreement];
+    self.keyAgreement = [YKFCBORFieldDecoder objectFromData:data value:keyAgreement];
+    if (keyAgreement->present && !self.keyAgreement) {
         return NO;
     }
-    NSDictionary *response = (NSDictionary *)convertedObject;
     
-    self.keyAgreement = response[@(YKFFIDO2ClientPinResponseKeyKeyAgreement)];
-    self.pinToken = response[@(YKFFIDO2ClientPinResponsePinToken)];
+    self.pinToken = [YKFCBORFieldDecoder byteStringFromData:data value:&values[YKFFIDO2ClientPinResponseFieldPinToken]];
     
-    NSNumber *retries = response[@(YKFFIDO2ClientPinResponseKeyRetries)];
-    if (retries != nil) {
-        self.retries = retries.integerValue;
+    const YKFCBORFieldValue *retries = &values[YKFFIDO2ClientPinResponseFieldRetries];
+    if (retries->present) {
+        self.retries = (NSUInteger)retries->integerValue;
     }
     
     return YES;
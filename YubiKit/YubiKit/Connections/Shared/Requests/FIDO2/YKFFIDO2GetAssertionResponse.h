@@ -60,7 +60,9 @@ NS_ASSUME_NONNULL_BEGIN
  
  @discussion
     This property is optional. The key may not provide the user data structure
-    in the response. See CTAP2 specifications for more details.
+    in the response. See CTAP2 specifications for more details. The user data
+    structure is validated when the response is parsed and decoded when the
+    property is read for the first time.
  */
 @property (nonatomic, readonly, nullable) YKFFIDO2PublicKeyCredentialUserEntity *user;
 
@@ -14,7 +14,7 @@
 
 #import "YKFFIDO2GetAssertionResponse.h"
 #import "YKFFIDO2GetAssertionResponse+Private.h"
-#import "YKFCBORDecoder.h"
+#import "YKFCBORFieldDecoder.h"
 #import "YKFFIDO2Type.h"
 #import "YKFAssert.h"
 
@@ -26,6 +26,53 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionResponseKey) {
     YKFFIDO2GetAssertionResponseKeyNumberOfCredentials   = 0x05
 };
 
+#pragma mark - Field Tables
+
+typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionResponseField) {
+    YKFFIDO2GetAssertionResponseFieldCredential,
+    YKFFIDO2GetAssertionResponseFieldAuthData,
+    YKFFIDO2GetAssertionResponseFieldSignature,
+    YKFFIDO2GetAssertionResponseFieldUser,
+    YKFFIDO2GetAssertionResponseFieldNumberOfCredentials,
+    YKFFIDO2GetAssertionResponseFieldCount
+};
+
+static const YKFCBORField YKFFIDO2GetAssertionResponseFields[YKFFIDO2GetAssertionResponseFieldCount] = {
+    [YKFFIDO2GetAssertionResponseFieldCredential] = {.integerKey = YKFFIDO2GetAssertionResponseKeyCredential, .type = YKFCBORFieldTypeMap},
+    [YKFFIDO2GetAssertionResponseFieldAuthData] = {.integerKey = YKFFIDO2GetAssertionResponseKeyAuthData, .type = YKFCBORFieldTypeByteString, .required = YES},
+    [YKFFIDO2GetAssertionResponseFieldSignature] = {.integerKey = YKFFIDO2GetAssertionResponseKeySignature, .type = YKFCBORFieldTypeByteString, .required = YES},
+    [YKFFIDO2GetAssertionResponseFieldUser] = {.integerKey = YKFFIDO2GetAssertionResponseKeyUser, .type = YKFCBORFieldTypeMap},
+    [YKFFIDO2GetAssertionResponseFieldNumberOfCredentials] = {.integerKey = YKFFIDO2GetAssertionResponseKeyNumberOfCredentials, .type = YKFCBORFieldTypeUnsignedInteger}
+};
+
+typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionCredentialField) {
+    YKFFIDO2GetAssertionCredentialFieldId,
+    YKFFIDO2GetAssertionCredentialFieldType,
+    YKFFIDO2GetAssertionCredentialFieldTransports,
+    YKFFIDO2GetAssertionCredentialFieldCount
+};
+
+static const YKFCBORField YKFFIDO2GetAssertionCredentialFields[YKFFIDO2GetAssertionCredentialFieldCount] = {
+    [YKFFIDO2GetAssertionCredentialFieldId] = {.textKey = "id", .type = YKFCBORFieldTypeByteString, .required = YES},
+    [YKFFIDO2GetAssertionCredentialFieldType] = {.textKey = "type", .type = YKFCBORFieldTypeTextString, .required = YES},
+    [YKFFIDO2GetAssertionCredentialFieldTransports] = {.textKey = "transports", .type = YKFCBORFieldTypeArray}
+};
+
+typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionUserField) {
+    YKFFIDO2GetAssertionUserFieldId,
+    YKFFIDO2GetAssertionUserFieldName,
+    YKFFIDO2GetAssertionUserFieldDisplayName,
+    YKFFIDO2GetAssertionUserFieldIcon,
+    YKFFIDO2GetAssertionUserFieldCount
+};
+
+static const YKFCBORField YKFFIDO2GetAssertionUserFields[YKFFIDO2GetAssertionUserFieldCount] = {
+    [YKFFIDO2GetAssertionUserFieldId] = {.textKey = "id", .type = YKFCBORFieldTypeByteString, .required = YES},
+    [YKFFIDO2GetAssertionUserFieldName] = {.textKey = "name", .type = YKFCBORFieldTypeTextString},
+    [YKFFIDO2GetAssertionUserFieldDisplayName] = {.textKey = "displayName", .type = YKFCBORFieldTypeTextString},
+    [YKFFIDO2GetAssertionUserFieldIcon] = {.textKey = "icon", .type = YKFCBORFieldTypeTextString}
+};
+
 @interface YKFFIDO2GetAssertionResponse()
 
 @property (nonatomic, readwrite) YKFFIDO2PublicKeyCredentialDescriptor *credential;
@@ -36,6 +83,9 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionResponseKey) {
 
 @property (nonatomic, readwrite) NSData *rawResponse;
 
+// The range of the encoded user entity in the response. The user entity is decoded only when the user property is read.
+@property (nonatomic, assign) NSRange userRange;
+
 @end
 
 @implementation YKFFIDO2GetAssertionResponse
@@ -44,82 +94,117 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetAssertionResponseKey) {
     self = [super init];
     if (self) {
         YKFAssertAbortInit(cborData);
-        self.rawResponse = cborData;
         
-        YKFCBORMap *responseMap = nil;
+        // The decoded byte strings are slices of the response.
+        self.rawResponse = [cborData copy];
         
-        NSInputStream *decoderInputStream = [[NSInputStream alloc] initWithData:cborData];
-        [decoderInputStream open];
-        responseMap = [YKFCBORDecoder decodeObjectFrom:decoderInputStream];
-        [decoderInputStream close];
-        
-        YKFAssertAbortInit(responseMap);
-        
-        BOOL success = [self parseResponseMap: responseMap];
+        BOOL success = [self parseResponseData:self.rawResponse];
         YKFAssertAbortInit(success);
     }
     return self;
 }
 
-#pragma mark - Private
+#pragma mark - Properties
 
-- (BOOL)parseResponseMap:(YKFCBORMap *)map {
-    id convertedObject = [YKFCBORDecoder convertCBORObjectToFoundationType:map];
-    if (!convertedObject || ![convertedObject isKindOfClass:NSDictionary.class]) {
-        return NO;
-    }
-    NSDictionary *response = (NSDictionary *)convertedObject;
-    
-    // Credential    
-    NSDictionary *responseCredential = response[@(YKFFIDO2GetAssertionResponseKeyCredential)];
-    if (responseCredential) {
-        YKFFIDO2PublicKeyCredentialDescriptor *credentialDescriptor = [[YKFFIDO2PublicKeyCredentialDescriptor alloc] init];
-        credentialDescriptor.credentialId = responseCredential[@"id"];
-        
-        YKFFIDO2PublicKeyCredentialType *credentialType = [[YKFFIDO2PublicKeyCredentialType alloc] init];
-        credentialType.name = responseCredential[@"type"];
-        credentialDescriptor.credentialType = credentialType;
-        
-        NSArray *responseTransports = responseCredential[@"transports"];
-        NSMutableArray *transports = [[NSMutableArray alloc] initWithCapacity:responseTransports.count];
-        for (NSString *responseTransport in responseTransports) {
-            YKFFIDO2AuthenticatorTransport *transport = [[YKFFIDO2AuthenticatorTransport alloc] init];
-            transport.name = responseTransport;
-            [transports addObject: transport];
+- (YKFFIDO2PublicKeyCredentialUserEntity *)user {
+    @synchronized (self) {
+        if (!_user && self.userRange.location != NSNotFound) {
+            _user = [self userEntityFromData:self.rawResponse range:self.userRange];
+            self.userRange = NSMakeRange(NSNotFound, 0);
         }
-        credentialDescriptor.credentialTransports = transports;
-        
-        self.credential = credentialDescriptor;
+        return _user;
     }
+}
+
+#pragma mark - Private
 
+- (BOOL)parseResponseData:(NSData *)data {
+    YKFCBORFieldValue values[YKFFIDO2GetAssertionResponseFieldCount];
+    BOOL success = [YKFCBORFieldDecoder decodeMapFromData:data fields:YKFFIDO2GetAssertionResponseFields
+                                                    count:YKFFIDO2GetAssertionResponseFieldCount values:values];
+    YKFAssertReturnValue(success, @"authenticatorGetAssertion response is not valid.", NO);
+    
+    // Credential
+    const YKFCBORFieldValue *credential = &values[YKFFIDO2GetAssertionResponseFieldCredential];
+    if (credential->present) {
+        self.credential = [self credentialDescriptorFromData:data range:credential->encodedRange];
+        YKFAssertReturnValue(self.credential, @"authenticatorGetAssertion credential is not valid.", NO);
+    }
+    
     // Auth Data
-    NSData *authData = response[@(YKFFIDO2GetAssertionResponseKeyAuthData)];    
-    YKFAssertReturnValue(authData, @"authenticatorGetAssertion authData is required.", NO);
-    self.authData = authData;
+    self.authData = [YKFCBORFieldDecoder byteStringFromData:data value:&values[YKFFIDO2GetAssertionResponseFieldAuthData]];
     
     // Signature
-    NSData *signature = response[@(YKFFIDO2GetAssertionResponseKeySignature)];
-    YKFAssertReturnValue(signature, @"authenticatorGetAssertion signature is required.", NO);
-    self.signature = signature;
+    self.signature = [YKFCBORFieldDecoder byteStringFromData:data value:&values[YKFFIDO2GetAssertionResponseFieldSignature]];
     
-    // User
-    NSDictionary *responseUser = response[@(YKFFIDO2GetAssertionResponseKeyUser)];
-    if (responseUser) {
-        YKFFIDO2PublicKeyCredentialUserEntity *user = [[YKFFIDO2PublicKeyCredentialUserEntity alloc] init];
-        user.userId = responseUser[@"id"];
-        user.userName = responseUser[@"name"];
-        user.userDisplayName = responseUser[@"displayName"];
-        user.userIcon = responseUser[@"icon"];
-        self.user = user;
+    // User: the map and its required fields are validated here, the entity is created when the user property is read.
+    const YKFCBORFieldValue *user = &values[YKFFIDO2GetAssertionResponseFieldUser];
+    if (user->present) {
+        YKFCBORFieldValue userValues[YKFFIDO2GetAssertionUserFieldCount];
+        success = [YKFCBORFieldDecoder decodeMapFromData:data range:user->encodedRange fields:YKFFIDO2GetAssertionUserFields
+                                                   count:YKFFIDO2GetAssertionUserFieldCount values:userValues];
+        YKFAssertReturnValue(success, @"authenticatorGetAssertion user is not valid.", NO);
     }
+    self.userRange = user->present ? user->encodedRange : NSMakeRange(NSNotFound, 0);
     
     // Number Of Credentials
-    NSNumber *numberOfCredentials = response[@(YKFFIDO2GetAssertionResponseKeyNumberOfCredentials)];
-    if (numberOfCredentials != nil) {
-        self.numberOfCredentials = numberOfCredentials.integerValue;
+    const YKFCBORFieldValue *numberOfCredentials = &values[YKFFIDO2GetAssertionResponseFieldNumberOfCredentials];
+    if (numberOfCredentials->present) {
+        self.numberOfCredentials = (NSInteger)numberOfCredentials->integerValue;
     }
     
     return YES;
 }
 
+- (YKFFIDO2PublicKeyCredentialDescriptor *)credentialDescriptorFromData:(NSData *)data range:(NSRange)range {
+    YKFCBORFieldValue values[YKFFIDO2GetAssertionCredentialFieldCount];
+    BOOL success = [YKFCBORFieldDecoder decodeMapFromData:data range:range fields:YKFFIDO2GetAssertionCredentialFields
+                                                    count:YKFFIDO2GetAssertionCredentialFieldCount values:values];
+    if (!success) {
+        return nil;
+    }
+    
+    YKFFIDO2PublicKeyCredentialDescriptor *credentialDescriptor = [[YKFFIDO2PublicKeyCredentialDescriptor alloc] init];
+    credentialDescriptor.credentialId = [YKFCBORFieldDecoder byteStringFromData:data value:&values[YKFFIDO2GetAssertionCredentialFieldId]];
+    
+    YKFFIDO2PublicKeyCredentialType *credentialType = [[YKFFIDO2PublicKeyCredentialType alloc] init];
+    credentialType.name = [YKFCBORFieldDecoder textStringFromData:data value:&values[YKFFIDO2GetAssertionCredentialFieldType]];
+    credentialDescriptor.credentialType = credentialType;
+    
+    const YKFCBORFieldValue *transportsValue = &values[YKFFIDO2GetAssertionCredentialFieldTransports];
+    NSArray *responseTransports = @[];
+    if (transportsValue->present) {
+        responseTransports = [YKFCBORFieldDecoder textStringArrayFromData:data value:transportsValue];
+        if (!responseTransports) {
+            return nil;
+        }
+    }
+    NSMutableArray *transports = [[NSMutableArray alloc] initWithCapacity:responseTransports.count];
+    for (NSString *responseTransport in responseTransports) {
+        YKFFIDO2AuthenticatorTransport *transport = [[YKFFIDO2AuthenticatorTransport alloc] init];
+        transport.name = responseTransport;
+        [transports addObject: transport];
+    }
+    credentialDescriptor.credentialTransports = transports;
+    
+    return credentialDescriptor;
+}
+
+- (YKFFIDO2PublicKeyCredentialUserEntity *)userEntityFromData:(NSData *)data range:(NSRange)range {
+    YKFCBORFieldValue values[YKFFIDO2GetAssertionUserFieldCount];
+    BOOL success = [YKFCBORFieldDecoder decodeMapFromData:data range:range fields:YKFFIDO2GetAssertionUserFields
+                                                    count:YKFFIDO2GetAssertionUserFieldCount values:values];
+    if (!success) {
+        return nil;
+    }
+    
+    YKFFIDO2PublicKeyCredentialUserEntity *user = [[YKFFIDO2PublicKeyCredentialUserEntity alloc] init];
+    user.userId = [YKFCBORFieldDecoder byteStringFromData:data value:&values[YKFFIDO2GetAssertionUserFieldId]];
+    user.userName = [YKFCBORFieldDecoder textStringFromData:data value:&values[YKFFIDO2GetAssertionUserFieldName]];
+    user.userDisplayName = [YKFCBORFieldDecoder textStringFromData:data value:&values[YKFFIDO2GetAssertionUserFieldDisplayName]];
+    user.userIcon = [YKFCBORFieldDecoder textStringFromData:data value:&values[YKFFIDO2GetAssertionUserFieldIcon]];
+    
+    return user;
+}
+
 @end
@@ -14,7 +14,7 @@
 
 #import "YKFFIDO2GetInfoResponse.h"
 #import "YKFFIDO2GetInfoResponse+Private.h"
-#import "YKFCBORDecoder.h"
+#import "YKFCBORFieldDecoder.h"
 #import "YKFAssert.h"
 
 NSString* const YKFFIDO2GetInfoResponseOptionClientPin = @"clientPin";
@@ -34,6 +34,28 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetInfoResponseKey) {
 
 };
 
+typedef NS_ENUM(NSUInteger, YKFFIDO2GetInfoResponseField) {
+    YKFFIDO2GetInfoResponseFieldVersions,
+    YKFFIDO2GetInfoResponseFieldExtensions,
+    YKFFIDO2GetInfoResponseFieldAAGUID,
+    YKFFIDO2GetInfoResponseFieldOptions,
+    YKFFIDO2GetInfoResponseFieldMaxMsgSize,
+    YKFFIDO2GetInfoResponseFieldPinProtocols,
+    YKFFIDO2GetInfoResponseFieldMinPinLength,
+    YKFFIDO2GetInfoResponseFieldCount
+};
+
+// Only the known keys are decoded, the rest of the response is skipped.
+static const YKFCBORField YKFFIDO2GetInfoResponseFields[YKFFIDO2GetInfoResponseFieldCount] = {
+    [YKFFIDO2GetInfoResponseFieldVersions] = {.integerKey = YKFFIDO2GetInfoResponseKeyVersions, .type = YKFCBORFieldTypeArray, .required = YES},
+    [YKFFIDO2GetInfoResponseFieldExtensions] = {.integerKey = YKFFIDO2GetInfoResponseKeyExtensions, .type = YKFCBORFieldTypeArray},
+    [YKFFIDO2GetInfoResponseFieldAAGUID] = {.integerKey = YKFFIDO2GetInfoResponseKeyAAGUID, .type = YKFCBORFieldTypeByteString, .required = YES},
+    [YKFFIDO2GetInfoResponseFieldOptions] = {.integerKey = YKFFIDO2GetInfoResponseKeyOptions, .type = YKFCBORFieldTypeMap},
+    [YKFFIDO2GetInfoResponseFieldMaxMsgSize] = {.integerKey = YKFFIDO2GetInfoResponseKeyMaxMsgSize, .type = YKFCBORFieldTypeUnsignedInteger},
+    [YKFFIDO2GetInfoResponseFieldPinProtocols] = {.integerKey = YKFFIDO2GetInfoResponseKeyPinProtocols, .type = YKFCBORFieldTypeArray},
+    [YKFFIDO2GetInfoResponseFieldMinPinLength] = {.integerKey = YKFFIDO2GetInfoResponseKeyMinPinLength, .type = YKFCBORFieldTypeUnsignedInteger}
+};
+
 @interface YKFFIDO2GetInfoResponse()
 
 @property (nonatomic, readwrite) NSArray *versions;
@@ -51,16 +73,9 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetInfoResponseKey) {
 - (instancetype)initWithCBORData:(NSData *)cborData {
     self = [super init];
     if (self) {
-        YKFCBORMap *getInfoMap = nil;
+        YKFAssertAbortInit(cborData);
         
-        NSInputStream *decoderInputStream = [[NSInputStream alloc] initWithData:cborData];
-        [decoderInputStream open];
-        getInfoMap = [YKFCBORDecoder decodeObjectFrom:decoderInputStream];
-        [decoderInputStream close];
-        
-        YKFAssertAbortInit(getInfoMap);
-        
-        BOOL success = [self parseResponseMap:getInfoMap];
+        BOOL success = [self parseResponseData:[cborData copy]];
         YKFAssertAbortInit(success);
     }
     return self;
@@ -68,46 +83,46 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetInfoResponseKey) {
 
 #pragma mark - Private
 
-- (BOOL)parseResponseMap:(YKFCBORMap *)map {
-    id convertedObject = [YKFCBORDecoder convertCBORObjectToFoundationType:map];
-    if (!convertedObject || ![convertedObject isKindOfClass:NSDictionary.class]) {
-        return NO;
-    }
-    NSDictionary *response = (NSDictionary *)convertedObject;
+- (BOOL)parseResponseData:(NSData *)data {
+    YKFCBORFieldValue values[YKFFIDO2GetInfoResponseFieldCount];
+    BOOL success = [YKFCBORFieldDecoder decodeMapFromData:data fields:YKFFIDO2GetInfoResponseFields
+                                                    count:YKFFIDO2GetInfoResponseFieldCount values:values];
+    YKFAssertReturnValue(success, @"authenticatorGetInfo response is not valid.", NO);
     
     // versions
-    NSArray *versions = response[@(YKFFIDO2GetInfoResponseKeyVersions)];
-    YKFAssertReturnValue(versions, @"authenticatorGetInfo versions is required.", NO);
+    NSArray *versions = [YKFCBORFieldDecoder textStringArrayFromData:data value:&values[YKFFIDO2GetInfoResponseFieldVersions]];
+    YKFAssertReturnValue(versions, @"authenticatorGetInfo versions is not valid.", NO);
     self.versions = versions;
     
     // extensions
-    self.extensions = response[@(YKFFIDO2GetInfoResponseKeyExtensions)];
+    const YKFCBORFieldValue *extensions = &values[YKFFIDO2GetInfoResponseFieldExtensions];
+    self.extensions = [YKFCBORFieldDecoder textStringArrayFromData:data value:extensions];
+    YKFAssertReturnValue(self.extensions || !extensions->present, @"authenticatorGetInfo extensions is not valid.", NO);
     
     // aaguid
-    NSData *aaguid = response[@(YKFFIDO2GetInfoResponseKeyAAGUID)];
-    YKFAssertReturnValue(aaguid, @"authenticatorGetInfo aaguid is required.", NO);
+    NSData *aaguid = [YKFCBORFieldDecoder byteStringFromData:data value:&values[YKFFIDO2GetInfoResponseFieldAAGUID]];
     YKFAssertReturnValue(aaguid.length == 16, @"authenticatorGetInfo aaguid has the wrong value.", NO);
     self.aaguid = aaguid;
     
     // options
-    self.options = response[@(YKFFIDO2GetInfoResponseKeyOptions)];
+    const YKFCBORFieldValue *options = &values[YKFFIDO2GetInfoResponseFieldOptions];
+    self.options = [YKFCBORFieldDecoder boolMapFromData:data value:options];
+    YKFAssertReturnValue(self.options || !options->present, @"authenticatorGetInfo options is not valid.", NO);
     
     // maxMsgSize
-    NSNumber *maxMsgSize = response[@(YKFFIDO2GetInfoResponseKeyMaxMsgSize)];
-    if (maxMsgSize != nil) {
-        self.maxMsgSize = maxMsgSize.integerValue;
+    const YKFCBORFieldValue *maxMsgSize = &values[YKFFIDO2GetInfoResponseFieldMaxMsgSize];
+    if (maxMsgSize->present) {
+        self.maxMsgSize = (NSUInteger)maxMsgSize->integerValue;
     }
     
     // minPinLength
-    NSNumber *minPinLength = response[@(YKFFIDO2GetInfoResponseKeyMinPinLength)];
-    if (minPinLength != nil) {
-        self.minPinLength = minPinLength.integerValue;
-    } else {
-        self.minPinLength = 4;
-    }
+    const YKFCBORFieldValue *minPinLength = &values[YKFFIDO2GetInfoResponseFieldMinPinLength];
+    self.minPinLength = minPinLength->present ? (NSUInteger)minPinLength->integerValue : 4;
     
     // pin protocols
-    self.pinProtocols = response[@(YKFFIDO2GetInfoResponseKeyPinProtocols)];
+    const YKFCBORFieldValue *pinProtocols = &values[YKFFIDO2GetInfoResponseFieldPinProtocols];
+    self.pinProtocols = [YKFCBORFieldDecoder integerArrayFromData:data value:pinProtocols];
+    YKFAssertReturnValue(self.pinProtocols || !pinProtocols->present, @"authenticatorGetInfo pinProtocols is not valid.", NO);
         
     return YES;
 }
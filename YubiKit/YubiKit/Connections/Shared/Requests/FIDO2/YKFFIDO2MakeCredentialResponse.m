@@ -14,9 +14,10 @@
 
 #import "YKFFIDO2MakeCredentialResponse.h"
 #import "YKFFIDO2MakeCredentialResponse+Private.h"
-#import "YKFCBORDecoder.h"
+#import "YKFCBORFieldDecoder.h"
 #import "YKFCBOREncoder.h"
 #import "YKFAssert.h"
+#import "YKFByteSpan.h"
 
 typedef NS_ENUM(NSUInteger, YKFFIDO2MakeCredentialResponseKey) {
     YKFFIDO2GetInfoResponseKeyFmt        = 0x01,
@@ -33,6 +34,19 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2AuthenticatorDataFlag) {
 
 static NSString* const YKFFIDO2MakeCredentialResponsePackedAttStmtFmt = @"packed";
 
+typedef NS_ENUM(NSUInteger, YKFFIDO2MakeCredentialResponseField) {
+    YKFFIDO2MakeCredentialResponseFieldFmt,
+    YKFFIDO2MakeCredentialResponseFieldAuthData,
+    YKFFIDO2MakeCredentialResponseFieldAttStmt,
+    YKFFIDO2MakeCredentialResponseFieldCount
+};
+
+static const YKFCBORField YKFFIDO2MakeCredentialResponseFields[YKFFIDO2MakeCredentialResponseFieldCount] = {
+    [YKFFIDO2MakeCredentialResponseFieldFmt] = {.integerKey = YKFFIDO2GetInfoResponseKeyFmt, .type = YKFCBORFieldTypeTextString, .required = YES},
+    [YKFFIDO2MakeCredentialResponseFieldAuthData] = {.integerKey = YKFFIDO2GetInfoResponseKeyAuthData, .type = YKFCBORFieldTypeByteString, .required = YES},
+    [YKFFIDO2MakeCredentialResponseFieldAttStmt] = {.integerKey = YKFFIDO2GetInfoResponseKeyAttStmt, .type = YKFCBORFieldTypeMap, .required = YES}
+};
+
 @interface YKFFIDO2AuthenticatorData()
 
 @property (nonatomic, readwrite) NSData *rpIdHash;
@@ -66,74 +80,73 @@ static NSString* const YKFFIDO2MakeCredentialResponsePackedAttStmtFmt = @"packed
     if (self) {
         YKFAssertAbortInit(cborData);
         
-        self.rawResponse = cborData;
-        self.ctapAttestationObject = cborData;
-        
-        YKFCBORMap *attestationMap = nil;
+        // The decoded byte strings are slices of the response.
+        self.rawResponse = [cborData copy];
+        self.ctapAttestationObject = self.rawResponse;
         
-        NSInputStream *decoderInputStream = [[NSInputStream alloc] initWithData:cborData];
-        [decoderInputStream open];
-        attestationMap = [YKFCBORDecoder decodeObjectFrom:decoderInputStream];
-        [decoderInputStream close];
-        
-        YKFAssertAbortInit(attestationMap);
+        YKFCBORFieldValue values[YKFFIDO2MakeCredentialResponseFieldCount];
+        BOOL success = [YKFCBORFieldDecoder decodeMapFromData:self.rawResponse fields:YKFFIDO2MakeCredentialResponseFields
+                                                        count:YKFFIDO2MakeCredentialResponseFieldCount values:values];
+        YKFAssertAbortInit(success);
         
-        BOOL success = [self parseAttestationMap: attestationMap];
+        success = [self parseAttestationData:self.rawResponse values:values];
         YKFAssertAbortInit(success);
         
-        success = [self buildWebAuthnAttestationObjectFromMap:attestationMap];
+        success = [self buildWebAuthnAttestationObjectFromData:self.rawResponse values:values];
         YKFAssertAbortInit(success);
     }
     return self;
 }
 
-- (BOOL)parseAttestationMap:(YKFCBORMap *)map {
-    id convertedObject = [YKFCBORDecoder convertCBORObjectToFoundationType:map];
-    if (!convertedObject || ![convertedObject isKindOfClass:NSDictionary.class]) {
-        return NO;
-    }
-    NSDictionary *response = (NSDictionary *)convertedObject;
-    
+- (BOOL)parseAttestationData:(NSData *)data values:(const YKFCBORFieldValue *)values {
     // Auth Data
-    NSData *authData = response[@(YKFFIDO2GetInfoResponseKeyAuthData)];
-    YKFAssertReturnValue(authData, @"authenticatorMakeCredential authData is required.", NO);
-    self.authData = authData;
-
+    self.authData = [YKFCBORFieldDecoder byteStringFromData:data value:&values[YKFFIDO2MakeCredentialResponseFieldAuthData]];
+    
     // Fmt
-    NSString *fmt = response[@(YKFFIDO2GetInfoResponseKeyFmt)];
-    YKFAssertReturnValue(fmt, @"authenticatorMakeCredential fmt is required.", NO);
+    NSString *fmt = [YKFCBORFieldDecoder textStringFromData:data value:&values[YKFFIDO2MakeCredentialResponseFieldFmt]];
+    YKFAssertReturnValue(fmt, @"authenticatorMakeCredential fmt is not valid.", NO);
     self.fmt = fmt;
-
+    
     // AttStmt
+    const YKFCBORFieldValue *attStmt = &values[YKFFIDO2MakeCredentialResponseFieldAttStmt];
     if ([fmt isEqualToString:YKFFIDO2MakeCredentialResponsePackedAttStmtFmt]) {
-        YKFCBORMap *attStmtMap = map.value[YKFCBORInteger(YKFFIDO2GetInfoResponseKeyAttStmt)];
-        self.attStmt = [YKFCBOREncoder encodeMap:attStmtMap];
+        // The encoded attStmt map is a slice of the response, no need to decode and encode it again.
+        self.attStmt = [YKFCBORFieldDecoder encodedValueFromData:data value:attStmt];
     } else {
-        self.attStmt = response[@(YKFFIDO2GetInfoResponseKeyAttStmt)];
+        self.attStmt = [YKFCBORFieldDecoder objectFromData:data value:attStmt];
     }
-    YKFAssertReturnValue(self.attStmt, @"authenticatorGetInfo attStmt is required.", NO);
-
+    YKFAssertReturnValue(self.attStmt, @"authenticatorMakeCredential attStmt is not valid.", NO);
+    
     return YES;
 }
 
-- (BOOL)buildWebAuthnAttestationObjectFromMap:(YKFCBORMap *)map {
-    id authData = map.value[YKFCBORInteger(YKFFIDO2GetInfoResponseKeyAuthData)];
-    YKFAssertReturnValue(authData, @"authenticatorGetInfo authData is required.", NO);
+- (BOOL)buildWebAuthnAttestationObjectFromData:(NSData *)data values:(const YKFCBORFieldValue *)values {
+    NSRange fmt = values[YKFFIDO2MakeCredentialResponseFieldFmt].encodedRange;
+    NSRange attStmt = values[YKFFIDO2MakeCredentialResponseFieldAttStmt].encodedRange;
+    NSRange authData = values[YKFFIDO2MakeCredentialResponseFieldAuthData].encodedRange;
     
-    id fmt = map.value[YKFCBORInteger(YKFFIDO2GetInfoResponseKeyFmt)];
-    YKFAssertReturnValue(fmt, @"authenticatorGetInfo fmt is required.", NO);
+    // The values are already CBOR encoded by the authenticator, so only the map head and the keys are encoded here,
+    // in the CTAP2 canonical order: fmt, attStmt, authData.
+    NSData *fmtKey = [YKFCBOREncoder encodeTextString:YKFCBORTextString(@"fmt")];
+    NSData *attStmtKey = [YKFCBOREncoder encodeTextString:YKFCBORTextString(@"attStmt")];
+    NSData *authDataKey = [YKFCBOREncoder encodeTextString:YKFCBORTextString(@"authData")];
     
-    id attStmt = map.value[YKFCBORInteger(YKFFIDO2GetInfoResponseKeyAttStmt)];
-    YKFAssertReturnValue(attStmt, @"authenticatorGetInfo attStmt is required.", NO);
+    NSUInteger length = 1 + fmtKey.length + fmt.length + attStmtKey.length + attStmt.length + authDataKey.length + authData.length;
+    NSMutableData *attestationObject = [[NSMutableData alloc] initWithCapacity:length];
+    const UInt8 *bytes = data.bytes;
     
-    NSDictionary *attestationDictionary = @{YKFCBORTextString(@"authData"): authData,
-                                            YKFCBORTextString(@"fmt"): fmt,
-                                            YKFCBORTextString(@"attStmt"): attStmt};
-    YKFCBORMap *attestationMap = YKFCBORMap(attestationDictionary);
-    NSData *cborEncodedAttestationMap = [YKFCBOREncoder encodeMap:attestationMap];
-    self.webauthnAttestationObject = cborEncodedAttestationMap;
+    UInt8 mapHead = 0xA3; // Map with 3 pairs.
+    [attestationObject appendBytes:&mapHead length:1];
+    [attestationObject appendData:fmtKey];
+    [attestationObject appendBytes:bytes + fmt.location length:fmt.length];
+    [attestationObject appendData:attStmtKey];
+    [attestationObject appendBytes:bytes + attStmt.location length:attStmt.length];
+    [attestationObject appendData:authDataKey];
+    [attestationObject appendBytes:bytes + authData.location length:authData.length];
     
-    return cborEncodedAttestationMap != nil;
+    self.webauthnAttestationObject = attestationObject;
+    
+    return YES;
 }
 
 #pragma mark - Derived Properties
@@ -156,8 +169,7 @@ static NSString* const YKFFIDO2MakeCredentialResponsePackedAttStmtFmt = @"packed
         UInt8 *dataBytes = (UInt8 *)data.bytes;
         self.flags = dataBytes[32];
         
-        UInt32 bigEndianSignCount = *((UInt32 *)(&dataBytes[33]));
-        self.signCount = CFSwapInt32BigToHost(bigEndianSignCount);
+        self.signCount = YKFLoadBigEndianUInt32(&dataBytes[33]);
         
         if (self.flags & YKFFIDO2AuthenticatorDataFlagAttested) {
             NSUInteger attestedCredentialDataOffset = 37;
@@ -168,8 +180,7 @@ static NSString* const YKFFIDO2MakeCredentialResponsePackedAttStmtFmt = @"packed
             self.aaguid = [attestedCredentialData subdataWithRange:NSMakeRange(0, 16)];
             
             UInt8 *attestedCredentialDataBytes = (UInt8 *)attestedCredentialData.bytes;
-            UInt16 bigEndianCredentialIdLength = *((UInt16 *)(&attestedCredentialDataBytes[16]));
-            UInt16 credentialIdLength = CFSwapInt16BigToHost(bigEndianCredentialIdLength);
+            UInt16 credentialIdLength = YKFLoadBigEndianUInt16(&attestedCredentialDataBytes[16]);
             
             if (credentialIdLength > 0) {
                 NSUInteger coseKeyOffset = 18 + credentialIdLength;
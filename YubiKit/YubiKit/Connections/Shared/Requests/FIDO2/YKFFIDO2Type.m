@@ -14,28 +14,98 @@
 
 #import "YKFFIDO2Type.h"
 #import "YKFCBORType.h"
+#import "YKFCBORMapSchema.h"
 #import "YKFFIDO2Type+Private.h"
 
+#pragma mark - Entity Schemas
+
+// The fields of the entities, in CTAP2 canonical order of their keys.
+
+typedef NS_ENUM(NSUInteger, YKFFIDO2RpEntityField) {
+    YKFFIDO2RpEntityFieldId,
+    YKFFIDO2RpEntityFieldIcon,
+    YKFFIDO2RpEntityFieldName
+};
+
+typedef NS_ENUM(NSUInteger, YKFFIDO2UserEntityField) {
+    YKFFIDO2UserEntityFieldId,
+    YKFFIDO2UserEntityFieldIcon,
+    YKFFIDO2UserEntityFieldName,
+    YKFFIDO2UserEntityFieldDisplayName
+};
+
+typedef NS_ENUM(NSUInteger, YKFFIDO2CredentialParamField) {
+    YKFFIDO2CredentialParamFieldAlg,
+    YKFFIDO2CredentialParamFieldType
+};
+
+typedef NS_ENUM(NSUInteger, YKFFIDO2CredentialDescriptorField) {
+    YKFFIDO2CredentialDescriptorFieldId,
+    YKFFIDO2CredentialDescriptorFieldType,
+    YKFFIDO2CredentialDescriptorFieldTransports
+};
+
+static YKFCBORMapSchema *YKFFIDO2RpEntitySchema(void) {
+    static YKFCBORMapSchema *schema = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schema = [[YKFCBORMapSchema alloc] initWithKeys:@[YKFCBORTextString(@"id"),
+                                                          YKFCBORTextString(@"icon"),
+                                                          YKFCBORTextString(@"name")]];
+    });
+    return schema;
+}
+
+static YKFCBORMapSchema *YKFFIDO2UserEntitySchema(void) {
+    static YKFCBORMapSchema *schema = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schema = [[YKFCBORMapSchema alloc] initWithKeys:@[YKFCBORTextString(@"id"),
+                                                          YKFCBORTextString(@"icon"),
+                                                          YKFCBORTextString(@"name"),
+                                                          YKFCBORTextString(@"displayName")]];
+    });
+    return schema;
+}
+
+static YKFCBORMapSchema *YKFFIDO2CredentialParamSchema(void) {
+    static YKFCBORMapSchema *schema = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schema = [[YKFCBORMapSchema alloc] initWithKeys:@[YKFCBORTextString(@"alg"),
+                                                          YKFCBORTextString(@"type")]];
+    });
+    return schema;
+}
+
+static YKFCBORMapSchema *YKFFIDO2CredentialDescriptorSchema(void) {
+    static YKFCBORMapSchema *schema = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        schema = [[YKFCBORMapSchema alloc] initWithKeys:@[YKFCBORTextString(@"id"),
+                                                          YKFCBORTextString(@"type"),
+                                                          YKFCBORTextString(@"transports")]];
+    });
+    return schema;
+}
+
 #pragma mark - YKFFIDO2PublicKeyCredentialRpEntity
 
 @implementation YKFFIDO2PublicKeyCredentialRpEntity
 
 - (id)cborTypeObject {
-    NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] init];
+    YKFCBORSchemaMap *map = YKFCBORSchemaMap(YKFFIDO2RpEntitySchema());
     
-    YKFCBORTextString *idKey = YKFCBORTextString(@"id");
-    dictionary[idKey] = YKFCBORTextString(self.rpId);
+    map[YKFFIDO2RpEntityFieldId] = YKFCBORTextString(self.rpId);
     
     if (self.rpName) {
-        YKFCBORTextString *nameKey = YKFCBORTextString(@"name");
-        dictionary[nameKey] = YKFCBORTextString(self.rpName);
+        map[YKFFIDO2RpEntityFieldName] = YKFCBORTextString(self.rpName);
     }
     if (self.rpIcon) {
-        YKFCBORTextString *iconKey = YKFCBORTextString(@"icon");
-        dictionary[iconKey] = YKFCBORTextString(self.rpIcon);
+        map[YKFFIDO2RpEntityFieldIcon] = YKFCBORTextString(self.rpIcon);
     }
     
-    return YKFCBORMap([dictionary copy]);
+    return map;
 }
 
 @end
@@ -46,25 +116,21 @@
 @implementation YKFFIDO2PublicKeyCredentialUserEntity
 
 - (id)cborTypeObject {
-    NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] init];
+    YKFCBORSchemaMap *map = YKFCBORSchemaMap(YKFFIDO2UserEntitySchema());
     
-    YKFCBORTextString *idKey = YKFCBORTextString(@"id");
-    dictionary[idKey] = YKFCBORByteString(self.userId);
+    map[YKFFIDO2UserEntityFieldId] = YKFCBORByteString(self.userId);
     
     if (self.userName) {
-        YKFCBORTextString *nameKey = YKFCBORTextString(@"name");
-        dictionary[nameKey] = YKFCBORTextString(self.userName);
+        map[YKFFIDO2UserEntityFieldName] = YKFCBORTextString(self.userName);
     }
     if (self.userDisplayName) {
-        YKFCBORTextString *userDisplayNameKey = YKFCBORTextString(@"displayName");
-        dictionary[userDisplayNameKey] = YKFCBORTextString(self.userDisplayName);
+        map[YKFFIDO2UserEntityFieldDisplayName] = YKFCBORTextString(self.userDisplayName);
     }
     if (self.userIcon) {
-        YKFCBORTextString *userIconKey = YKFCBORTextString(@"icon");
-        dictionary[userIconKey] = YKFCBORTextString(self.userIcon);
+        map[YKFFIDO2UserEntityFieldIcon] = YKFCBORTextString(self.userIcon);
     }
     
-    return YKFCBORMap([dictionary copy]);
+    return map;
 }
 
 @end
@@ -86,9 +152,10 @@
 @implementation YKFFIDO2PublicKeyCredentialParam
 
 - (id)cborTypeObject {
-    NSDictionary *dictionary = @{YKFCBORTextString(@"alg"): YKFCBORInteger(self.alg),
-                                 YKFCBORTextString(@"type"): YKFCBORTextString(@"public-key")};
-    return YKFCBORMap(dictionary);
+    YKFCBORSchemaMap *map = YKFCBORSchemaMap(YKFFIDO2CredentialParamSchema());
+    map[YKFFIDO2CredentialParamFieldAlg] = YKFCBORInteger(self.alg);
+    map[YKFFIDO2CredentialParamFieldType] = YKFCBORTextString(@"public-key");
+    return map;
 }
 
 @end
@@ -114,24 +181,20 @@ NSString* const YKFFIDO2AuthenticatorTransportBLE = @"ble";
 @implementation YKFFIDO2PublicKeyCredentialDescriptor
 
 - (id)cborTypeObject {
-    NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] init];
+    YKFCBORSchemaMap *map = YKFCBORSchemaMap(YKFFIDO2CredentialDescriptorSchema());
     
-    YKFCBORTextString *idKey = YKFCBORTextString(@"id");
-    dictionary[idKey] = YKFCBORByteString(self.credentialId);
+    map[YKFFIDO2CredentialDescriptorFieldId] = YKFCBORByteString(self.credentialId);
+    map[YKFFIDO2CredentialDescriptorFieldType] = [self.credentialType cborTypeObject];
     
-    YKFCBORTextString *typeKey = YKFCBORTextString(@"type");
-    dictionary[typeKey] = [self.credentialType cborTypeObject];
-
     if (self.credentialTransports) {
-        YKFCBORTextString *transportsKey = YKFCBORTextString(@"transports");
         NSMutableArray *transportsArray = [[NSMutableArray alloc] initWithCapacity:self.credentialTransports.count];
         for (YKFFIDO2AuthenticatorTransport *transport in self.credentialTransports) {
             [transportsArray addObject:[transport cborTypeObject]];
         }
-        dictionary[transportsKey] = YKFCBORArray([transportsArray copy]);
+        map[YKFFIDO2CredentialDescriptorFieldTransports] = YKFCBORArray([transportsArray copy]);
     }
     
-    return YKFCBORMap([dictionary copy]);
+    return map;
 }
 
 @end
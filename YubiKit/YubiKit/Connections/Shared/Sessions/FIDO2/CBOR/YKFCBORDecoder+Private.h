@@ -0,0 +1,119 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFCBORDecoder.h"
+#import "YKFCBORTag.h"
+#import "YKFByteSpan.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ CTAP2 canonical CBOR allows a maximum nesting depth of 4. The limit is higher to be lenient with the authenticators
+ but still protect the stack from malformed input.
+ */
+static const NSUInteger YKFCBORDecoderMaxNestingDepth = 16;
+
+/*
+ Cursor used to walk a contiguous CBOR buffer. The data is kept to create no-copy slices for byte strings.
+ */
+typedef struct {
+    __unsafe_unretained NSData *data;
+    const UInt8 *bytes;
+    NSUInteger length;
+    NSUInteger offset;
+} YKFCBORDataCursor;
+
+/*
+ Creates a cursor at offset. The data must be immutable and must outlive the cursor.
+ */
+static inline YKFCBORDataCursor YKFCBORDataCursorMake(NSData *data, NSUInteger offset) {
+    YKFCBORDataCursor cursor = {data, data.bytes, data.length, offset};
+    return cursor;
+}
+
+static inline NSUInteger YKFCBORCursorRemainingLength(YKFCBORDataCursor *cursor) {
+    return cursor->length - cursor->offset;
+}
+
+static inline BOOL YKFCBORCursorReadByte(YKFCBORDataCursor *cursor, UInt8 *byte) {
+    if (cursor->offset >= cursor->length) {
+        return NO;
+    }
+    *byte = cursor->bytes[cursor->offset++];
+    return YES;
+}
+
+static inline BOOL YKFCBORCursorReadArgument(YKFCBORDataCursor *cursor, UInt8 additionalInfo, UInt64 *argument) {
+    if (additionalInfo < YKFCBORUInt8Tag) {
+        *argument = additionalInfo;
+        return YES;
+    }
+    
+    // Reserved values and indefinite lengths.
+    if (additionalInfo > YKFCBORUInt64Tag) {
+        return NO;
+    }
+    
+    // 24, 25, 26, 27 -> 1, 2, 4, 8 bytes.
+    NSUInteger size = 1 << (additionalInfo - YKFCBORUInt8Tag);
+    if (cursor->length - cursor->offset < size) {
+        return NO;
+    }
+    
+    *argument = YKFLoadBigEndian(cursor->bytes + cursor->offset, size);
+    cursor->offset += size;
+    return YES;
+}
+
+/*
+ Returns YES if the cursor decoder handles the item which starts with head: the definite-length integers, strings,
+ arrays and maps, and the booleans. The tags, the other simple values, the floats and the indefinite-length items
+ are decoded with YKFCBORStreamDecoder.
+ */
+static inline BOOL YKFCBORCursorDecodesHead(UInt8 head) {
+    if (head == 0xF4 || head == 0xF5) {
+        return YES;
+    }
+    return (head >> YKFCBORMajorTypeShift) < YKFCBORMajorTypeTag && (head & YKFCBORAdditionalInfoMask) != YKFCBORIndefiniteLengthInfo;
+}
+
+/*
+ Returns the shared instance of a well-known CTAP2/WebAuthn text string (e.g. "id", "type", "public-key") or nil if
+ the bytes are not one of the known strings. The known strings are ASCII, so a match does not need UTF-8 validation
+ or an allocation.
+ */
+NSString *_Nullable YKFCBORInternedTextString(const UInt8 *bytes, NSUInteger length);
+
+/*
+ Returns all the well-known text strings, in the order they are declared. Used by the tests to check that every string
+ can be looked up, since the table build only asserts the absence of collisions in debug builds.
+ */
+NSArray<NSString *> *YKFCBORInternedTextStrings(void);
+
+@interface YKFCBORDecoder()
+
+/*
+ Decodes the item at the cursor position and advances the cursor past it.
+ */
++ (nullable id)decodeObjectWithCursor:(YKFCBORDataCursor *)cursor depth:(NSUInteger)depth;
+
+/*
+ Advances the cursor past the item at the cursor position without decoding it. Returns NO if the item is malformed.
+ */
++ (BOOL)skipObjectWithCursor:(YKFCBORDataCursor *)cursor depth:(NSUInteger)depth;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -30,6 +30,25 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable id)decodeObjectFrom:(NSInputStream *)inputStream;
 
+/*!
+ @abstract
+    Decodes a CBOR type from a contiguous buffer by walking it with a cursor. Byte strings are returned
+    as slices which reference the input buffer without copying it. Tags, simple values, floats and
+    indefinite-length items are decoded with YKFCBORStreamDecoder.
+ @returns
+    The object or nil if the object could not be parsed.
+ */
++ (nullable id)decodeObjectFromData:(NSData *)data;
+
+/*!
+ @abstract
+    Decodes the CBOR type which starts at offset and advances the offset past the decoded item.
+    This allows decoding a sequence of CBOR items from the same buffer.
+ @returns
+    The object or nil if the object could not be parsed. The offset is not modified when decoding fails.
+ */
++ (nullable id)decodeObjectFromData:(NSData *)data offset:(NSUInteger *)offset;
+
 /*!
  @abstract
     Converts a CBOR type to a foundation type object (e.g. YKFCBORArray -> NSArray).
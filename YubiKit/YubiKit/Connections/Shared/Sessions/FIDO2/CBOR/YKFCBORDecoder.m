@@ -13,8 +13,11 @@
 // limitations under the License.
 
 #import "YKFCBORDecoder.h"
+#import "YKFCBORDecoder+Private.h"
+#import "YKFCBORStreamDecoder.h"
 #import "YKFCBORTag.h"
 #import "YKFAssert.h"
+#import "YKFNSDataAdditions+Private.h"
 
 @interface NSInputStream(YKFCBORDecoder)
 
@@ -62,6 +65,209 @@
     return nil;
 }
 
++ (nullable id)decodeObjectFromData:(NSData *)data {
+    NSUInteger offset = 0;
+    return [self decodeObjectFromData:data offset:&offset];
+}
+
++ (nullable id)decodeObjectFromData:(NSData *)data offset:(NSUInteger *)offset {
+    YKFAssertReturnValue(data, @"CBOR - Decoding data is nil.", nil);
+    YKFAssertReturnValue(offset, @"CBOR - Decoding offset is nil.", nil);
+    
+    // Byte strings are slices of the buffer, so decode from an immutable copy (a retain if the data is immutable).
+    NSData *buffer = [data copy];
+    if (*offset >= buffer.length) {
+        return nil;
+    }
+    
+    YKFCBORDataCursor cursor = YKFCBORDataCursorMake(buffer, *offset);
+    id object = [self decodeObjectWithCursor:&cursor depth:0];
+    if (object) {
+        *offset = cursor.offset;
+    }
+    return object;
+}
+
+#pragma mark - Buffer Decoding
+
++ (nullable id)decodeObjectWithCursor:(YKFCBORDataCursor *)cursor depth:(NSUInteger)depth {
+    if (depth > YKFCBORDecoderMaxNestingDepth) {
+        return nil;
+    }
+    
+    UInt8 head = 0;
+    if (!YKFCBORCursorReadByte(cursor, &head)) {
+        return nil;
+    }
+    if (!YKFCBORCursorDecodesHead(head)) {
+        return [self decodeObjectWithStreamDecoderFromCursor:cursor];
+    }
+    
+    // Bool
+    if (head == 0xF4 || head == 0xF5) {
+        return YKFCBORBool(head == 0xF5);
+    }
+    
+    UInt64 argument = 0;
+    if (!YKFCBORCursorReadArgument(cursor, head & YKFCBORAdditionalInfoMask, &argument)) {
+        return nil;
+    }
+    NSUInteger remainingLength = YKFCBORCursorRemainingLength(cursor);
+    
+    YKFCBORMajorType majorType = head >> YKFCBORMajorTypeShift;
+    switch (majorType) {
+        // MT 0: Positive Integer
+        case YKFCBORMajorTypePositiveInteger: {
+            YKFAssertReturnValue(argument <= INT64_MAX, @"CBOR - Cannot decode integer value. The value is too large.", nil);
+            return YKFCBORInteger((NSInteger)argument);
+        }
+        
+        // MT 1: Negative Integer
+        case YKFCBORMajorTypeNegativeInteger: {
+            YKFAssertReturnValue(argument <= INT64_MAX, @"CBOR - Cannot decode integer value. The value is too large.", nil);
+            return YKFCBORInteger(-(NSInteger)argument - 1);
+        }
+        
+        // MT 2: Byte String
+        case YKFCBORMajorTypeByteString: {
+            if (argument > remainingLength) {
+                return nil;
+            }
+            NSData *value = [cursor->data ykf_noCopySubdataWithRange:NSMakeRange(cursor->offset, (NSUInteger)argument)];
+            cursor->offset += (NSUInteger)argument;
+            return YKFCBORByteString(value);
+        }
+        
+        // MT 3: Text String
+        case YKFCBORMajorTypeTextString: {
+            if (argument > remainingLength) {
+                return nil;
+            }
+            NSString *value = @"";
+            if (argument) {
+                const UInt8 *bytes = cursor->bytes + cursor->offset;
+                value = YKFCBORInternedTextString(bytes, (NSUInteger)argument);
+                if (!value) {
+                    value = [[NSString alloc] initWithBytes:bytes length:(NSUInteger)argument encoding:NSUTF8StringEncoding];
+                }
+                YKFAssertReturnValue(value, @"CBOR - Cannot decode UTF8 string data.", nil);
+            }
+            cursor->offset += (NSUInteger)argument;
+            return YKFCBORTextString(value);
+        }
+        
+        // MT 4: Array
+        case YKFCBORMajorTypeArray: {
+            // Each element takes at least one byte.
+            if (argument > remainingLength) {
+                return nil;
+            }
+            NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)argument];
+            for (UInt64 i = 0; i < argument; ++i) {
+                id element = [self decodeObjectWithCursor:cursor depth:depth + 1];
+                if (!element) {
+                    return nil;
+                }
+                [array addObject:element];
+            }
+            return YKFCBORArray([array copy]);
+        }
+        
+        // MT 5: Map
+        case YKFCBORMajorTypeMap: {
+            // Each pair takes at least two bytes.
+            if (argument > remainingLength / 2) {
+                return nil;
+            }
+            NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] initWithCapacity:(NSUInteger)argument];
+            for (UInt64 i = 0; i < argument; ++i) {
+                id key = [self decodeObjectWithCursor:cursor depth:depth + 1];
+                if (!key) {
+                    return nil;
+                }
+                id value = [self decodeObjectWithCursor:cursor depth:depth + 1];
+                if (!value) {
+                    return nil;
+                }
+                
+                // Security check: Verify if the key already exists in the decoded map. A map with duplicated keys is invalid.
+                YKFAssertReturnValue(!dictionary[key], @"CBOR - The key already exists in the map.", nil);
+                dictionary[key] = value;
+            }
+            return YKFCBORMap([dictionary copy]);
+        }
+            
+        default:
+            return nil;
+    }
+}
+
++ (BOOL)skipObjectWithCursor:(YKFCBORDataCursor *)cursor depth:(NSUInteger)depth {
+    if (depth > YKFCBORDecoderMaxNestingDepth) {
+        return NO;
+    }
+    
+    UInt8 head = 0;
+    if (!YKFCBORCursorReadByte(cursor, &head)) {
+        return NO;
+    }
+    if (!YKFCBORCursorDecodesHead(head)) {
+        return [self decodeObjectWithStreamDecoderFromCursor:cursor] != nil;
+    }
+    if (head == 0xF4 || head == 0xF5) {
+        return YES;
+    }
+    
+    UInt64 argument = 0;
+    if (!YKFCBORCursorReadArgument(cursor, head & YKFCBORAdditionalInfoMask, &argument)) {
+        return NO;
+    }
+    
+    YKFCBORMajorType majorType = head >> YKFCBORMajorTypeShift;
+    switch (majorType) {
+        case YKFCBORMajorTypePositiveInteger:
+        case YKFCBORMajorTypeNegativeInteger:
+            return YES;
+            
+        case YKFCBORMajorTypeByteString:
+        case YKFCBORMajorTypeTextString:
+            if (argument > YKFCBORCursorRemainingLength(cursor)) {
+                return NO;
+            }
+            cursor->offset += (NSUInteger)argument;
+            return YES;
+            
+        case YKFCBORMajorTypeArray:
+        case YKFCBORMajorTypeMap: {
+            if (argument > YKFCBORCursorRemainingLength(cursor)) {
+                return NO;
+            }
+            UInt64 numberOfItems = majorType == YKFCBORMajorTypeMap ? argument * 2 : argument;
+            for (UInt64 i = 0; i < numberOfItems; ++i) {
+                if (![self skipObjectWithCursor:cursor depth:depth + 1]) {
+                    return NO;
+                }
+            }
+            return YES;
+        }
+            
+        default:
+            return NO;
+    }
+}
+
+/*
+ Decodes the item whose head was just read from the cursor with the stream decoder and advances the cursor past it.
+ */
++ (nullable id)decodeObjectWithStreamDecoderFromCursor:(YKFCBORDataCursor *)cursor {
+    NSUInteger offset = cursor->offset - 1;
+    id object = [YKFCBORStreamDecoder decodeObjectFromData:cursor->data offset:&offset];
+    if (object) {
+        cursor->offset = offset;
+    }
+    return object;
+}
+
 #pragma mark - Helpers
 
 + (YKFCBORInteger *)decodeIntegerFromInputStream:(NSInputStream *)inputStream header:(UInt8)header {
@@ -168,40 +374,30 @@
 + (YKFCBORInteger *)decodeInteger:(nonnull NSData *)data {
     YKFAssertReturnValue(data.length, @"CBOR - Cannot decode from empty data.", nil);
     
-    UInt8 *bytes = (UInt8 *)data.bytes;
-    
-    BOOL isNegative = bytes[0] & YKFCBORNegativeIntegerTagMask;
-    bytes[0] = bytes[0] & ~YKFCBORNegativeIntegerTagMask; // remove sign.
-    
-    NSInteger value = 0;
+    YKFByteReader reader = YKFByteReaderMakeWithData(data);
+    UInt8 header = YKFByteReaderReadUInt8(&reader);
+    BOOL isNegative = header & YKFCBORNegativeIntegerTagMask;
     
+    UInt64 parsedValue = 0;
     switch (data.length) {
         case 1:
-            value = bytes[0];
+            parsedValue = header & ~YKFCBORNegativeIntegerTagMask; // remove sign.
             break;
         case 2:
-            value = bytes[1];
-            break;
         case 3:
-            value = CFSwapInt16BigToHost(*((UInt16 *)(&bytes[1])));
-            break;
         case 5:
-            value = CFSwapInt32BigToHost(*((UInt32 *)(&bytes[1])));
+        case 9:
+            parsedValue = YKFByteReaderReadBigEndian(&reader, data.length - 1);
             break;
             
-        case 9: {
-            UInt64 parsedValue = CFSwapInt64BigToHost(*((UInt64 *)(&bytes[1])));
-            
-            // Avoid overflow for values which cannot be represented on a NSInteger.
-            YKFAssertReturnValue(parsedValue <= INT64_MAX, @"CBOR - Cannot decode integer value. The value is too large.", nil);
-            value = (NSInteger)parsedValue;
-        }
-        break;
-            
         default:
             return nil;
     }
     
+    // Avoid overflow for values which cannot be represented on a NSInteger.
+    YKFAssertReturnValue(parsedValue <= INT64_MAX, @"CBOR - Cannot decode integer value. The value is too large.", nil);
+    NSInteger value = (NSInteger)parsedValue;
+    
     value = isNegative ? -(value + 1) : value;
     return YKFCBORInteger(value);
 }
@@ -221,13 +417,114 @@
         return YKFCBORTextString(@"");
     }
     
-    NSData *textStringData = [data subdataWithRange:NSMakeRange(1, data.length -1)];
-    NSString *stringValue = [[NSString alloc] initWithData:textStringData encoding:NSUTF8StringEncoding];
+    NSString *stringValue = YKFCBORInternedTextString((const UInt8 *)data.bytes + 1, data.length - 1);
+    if (!stringValue) {
+        NSData *textStringData = [data subdataWithRange:NSMakeRange(1, data.length -1)];
+        stringValue = [[NSString alloc] initWithData:textStringData encoding:NSUTF8StringEncoding];
+    }
     YKFAssertReturnValue(stringValue, @"CBOR - Cannot decode UTF8 string data.", nil);
     
     return YKFCBORTextString(stringValue);
 }
 
+#pragma mark - Interned Text Strings
+
+/*
+ The size of the interned strings table. Must be a power of 2.
+ */
+static const NSUInteger YKFCBORInternTableSize = 64;
+
+/*
+ The longest interned string. Longer strings are not looked up.
+ */
+static const NSUInteger YKFCBORInternMaxLength = 16;
+
+typedef struct {
+    const char *bytes;
+    NSUInteger length;
+    __unsafe_unretained NSString *string;
+} YKFCBORInternEntry;
+
+#define YKFCBORInterned(value) {value, sizeof(value) - 1, @value}
+
+/*
+ The keys and values which repeat in the CTAP2 responses: the WebAuthn entities and credential descriptors, the
+ GetInfo versions, extensions and options and the attestation statements.
+ */
+static const YKFCBORInternEntry YKFCBORInternedStrings[] = {
+    YKFCBORInterned("id"),
+    YKFCBORInterned("type"),
+    YKFCBORInterned("name"),
+    YKFCBORInterned("displayName"),
+    YKFCBORInterned("icon"),
+    YKFCBORInterned("transports"),
+    YKFCBORInterned("public-key"),
+    YKFCBORInterned("usb"),
+    YKFCBORInterned("nfc"),
+    YKFCBORInterned("ble"),
+    YKFCBORInterned("internal"),
+    YKFCBORInterned("alg"),
+    YKFCBORInterned("fmt"),
+    YKFCBORInterned("packed"),
+    YKFCBORInterned("sig"),
+    YKFCBORInterned("x5c"),
+    YKFCBORInterned("up"),
+    YKFCBORInterned("uv"),
+    YKFCBORInterned("rk"),
+    YKFCBORInterned("plat"),
+    YKFCBORInterned("clientPin"),
+    YKFCBORInterned("FIDO_2_0"),
+    YKFCBORInterned("FIDO_2_1_PRE"),
+    YKFCBORInterned("U2F_V2"),
+    YKFCBORInterned("hmac-secret"),
+    YKFCBORInterned("credProtect")
+};
+
+/*
+ The multipliers were chosen so that the strings in YKFCBORInternedStrings do not collide (perfect hash), which
+ means a lookup is one hash and one comparison. Adding a string may require new multipliers.
+ */
+static inline NSUInteger YKFCBORInternHash(const UInt8 *bytes, NSUInteger length) {
+    return (length + bytes[0] * 19 + bytes[length - 1] * 48) & (YKFCBORInternTableSize - 1);
+}
+
+static const YKFCBORInternEntry *YKFCBORInternTable(void) {
+    static YKFCBORInternEntry table[YKFCBORInternTableSize];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSUInteger count = sizeof(YKFCBORInternedStrings) / sizeof(YKFCBORInternEntry);
+        for (NSUInteger i = 0; i < count; ++i) {
+            const YKFCBORInternEntry *entry = &YKFCBORInternedStrings[i];
+            NSCAssert(entry->length <= YKFCBORInternMaxLength, @"CBOR - Interned string too long.");
+            
+            NSUInteger hash = YKFCBORInternHash((const UInt8 *)entry->bytes, entry->length);
+            NSCAssert(!table[hash].string, @"CBOR - Interned strings hash collision.");
+            table[hash] = *entry;
+        }
+    });
+    return table;
+}
+
+NSString *YKFCBORInternedTextString(const UInt8 *bytes, NSUInteger length) {
+    if (!length || length > YKFCBORInternMaxLength) {
+        return nil;
+    }
+    const YKFCBORInternEntry *entry = &YKFCBORInternTable()[YKFCBORInternHash(bytes, length)];
+    if (entry->length != length || memcmp(entry->bytes, bytes, length) != 0) {
+        return nil;
+    }
+    return entry->string;
+}
+
+NSArray<NSString *> *YKFCBORInternedTextStrings(void) {
+    NSUInteger count = sizeof(YKFCBORInternedStrings) / sizeof(YKFCBORInternEntry);
+    NSMutableArray<NSString *> *strings = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        [strings addObject:YKFCBORInternedStrings[i].string];
+    }
+    return strings;
+}
+
 #pragma mark - CBOR to Foundation
 
 + (id)convertCBORObjectToFoundationType:(id)cborObject {
@@ -280,6 +577,23 @@
         return [tempDictionary copy];
     }
     
+    if ([cborObject isKindOfClass:YKFCBORFloat.class]) {
+        return @(((YKFCBORFloat *)cborObject).value);
+    }
+    
+    if ([cborObject isKindOfClass:YKFCBORSimpleValue.class]) {
+        UInt8 value = ((YKFCBORSimpleValue *)cborObject).value;
+        if (value == YKFCBORSimpleValueNull || value == YKFCBORSimpleValueUndefined) {
+            return [NSNull null];
+        }
+        return @(value);
+    }
+    
+    // The tags are informational, the application receives the tagged item.
+    if ([cborObject isKindOfClass:YKFCBORTaggedItem.class]) {
+        return [self convertCBORObjectToFoundationType:((YKFCBORTaggedItem *)cborObject).item];
+    }
+    
     return nil;
 }
 
@@ -0,0 +1,88 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFCBOREncoder.h"
+#import "YKFCBORTag.h"
+#import "YKFByteSpan.h"
+
+/*
+ The longest head: the initial byte followed by a 64 bit argument.
+ */
+static const NSUInteger YKFCBORMaxHeadLength = 9;
+
+/*
+ Returns the size exponent of the argument bytes: 0, 1, 2, 3 for 1, 2, 4, 8 bytes. The additional information
+ of the head is YKFCBORUInt8Tag + the exponent. The comparisons are evaluated without branches.
+ */
+static inline UInt8 YKFCBORArgumentSizeExponent(UInt64 argument) {
+    return (UInt8)((argument > UINT8_MAX) + (argument > UINT16_MAX) + (argument > UINT32_MAX));
+}
+
+/*
+ Returns the length of the head (initial byte + argument bytes) required to encode the argument: 1, 2, 3, 5 or 9.
+ */
+static inline NSUInteger YKFCBORHeadLength(UInt64 argument) {
+    if (argument < YKFCBORUInt8Tag) {
+        return 1;
+    }
+    return 1 + ((NSUInteger)1 << YKFCBORArgumentSizeExponent(argument));
+}
+
+/*
+ Writes the head for the major type tag mask and argument in the shortest form and returns the number of bytes written.
+ The buffer must have at least YKFCBORHeadLength(argument) bytes available.
+ */
+static inline NSUInteger YKFCBORWriteHead(UInt8 *buffer, UInt8 tagMask, UInt64 argument) {
+    if (argument < YKFCBORUInt8Tag) {
+        buffer[0] = tagMask | (UInt8)argument;
+        return 1;
+    }
+    
+    UInt8 exponent = YKFCBORArgumentSizeExponent(argument);
+    NSUInteger size = (NSUInteger)1 << exponent;
+    buffer[0] = tagMask | (YKFCBORUInt8Tag + exponent);
+    
+    YKFStoreBigEndian(buffer + 1, argument, size);
+    return 1 + size;
+}
+
+/*
+ Returns the major type tag mask and the argument which encode an integer. The negative integers (major type 1)
+ encode -1 - value, which is ~value in two's complement and covers the whole signed range, including INT64_MIN.
+ */
+static inline UInt64 YKFCBORIntegerArgument(SInt64 value, UInt8 *tagMask) {
+    // All ones for negative values, 0 otherwise.
+    UInt64 sign = (UInt64)(value >> 63);
+    *tagMask = (UInt8)(sign & YKFCBORNegativeIntegerTagMask);
+    return (UInt64)value ^ sign;
+}
+
+/*
+ Returns the length of the encoded integer.
+ */
+static inline NSUInteger YKFCBORIntegerLength(SInt64 value) {
+    UInt8 tagMask = 0;
+    return YKFCBORHeadLength(YKFCBORIntegerArgument(value, &tagMask));
+}
+
+/*
+ Writes the integer in the shortest form and returns the number of bytes written. The buffer must have at least
+ YKFCBORIntegerLength(value) bytes available.
+ */
+static inline NSUInteger YKFCBORWriteInteger(UInt8 *buffer, SInt64 value) {
+    UInt8 tagMask = 0;
+    UInt64 argument = YKFCBORIntegerArgument(value, &tagMask);
+    return YKFCBORWriteHead(buffer, tagMask, argument);
+}
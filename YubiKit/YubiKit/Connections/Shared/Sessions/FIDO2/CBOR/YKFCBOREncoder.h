@@ -34,6 +34,18 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable NSData *)encodeObject:(id)object;
 
+/*!
+ Returns the exact number of bytes required to encode the object or 0 if the object cannot be encoded.
+ */
++ (NSUInteger)encodedLengthOfObject:(id)object;
+
+/*!
+ Generic encoding method which computes the exact encoded size of the object first and then writes the
+ whole object tree into one preallocated buffer without intermediate allocations. Maps with a fixed shape
+ (YKFCBORSchemaMap) are written in the order of their schema, without sorting the keys.
+ */
++ (nullable NSData *)encodeObjectInSingleBuffer:(id)object;
+
 @end
 
 /*!
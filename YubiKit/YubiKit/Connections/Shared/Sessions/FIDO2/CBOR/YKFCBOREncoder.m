@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #import "YKFCBOREncoder.h"
+#import "YKFCBOREncoder+Private.h"
 #import "YKFCBORTag.h"
+#import "YKFCBORMapSchema.h"
 #import "YKFAssert.h"
 
 @implementation YKFCBOREncoder
@@ -23,28 +25,9 @@
 + (NSData *)encodeInteger:(YKFCBORInteger *)cborInteger {
     YKFAssertReturnValue(cborInteger, @"CBOR Encoding - Cannot encode empty CBOR integer.", nil);
     
-    NSInteger value = cborInteger.value;
-    
-    if (labs(value) <= INT8_MAX) {
-        return [self encodeSInt8:(SInt8)value];
-    }
-    if (labs(value) <= UINT8_MAX) {
-        return value < 0 ? [self encodeSInt16:(SInt16)value] : [self encodeUInt8:(UInt8)value];
-    }
-    if (labs(value) <= INT16_MAX) {
-        return [self encodeSInt16:(SInt16)value];
-    }
-    if (labs(value) <= UINT16_MAX) {
-        return value < 0 ? [self encodeSInt32:(SInt32)value] : [self encodeUInt16:(UInt16)value];
-    }
-    if (labs(value) <= INT32_MAX) {
-        return [self encodeSInt32:(SInt32)value];
-    }
-    if (labs(value) <= UINT32_MAX) {
-        return value < 0 ? [self encodeSInt64:(SInt64)value] : [self encodeUInt32:(UInt32)value];
-    }
-
-    return [self encodeSInt64:(SInt64)value];
+    UInt8 buffer[YKFCBORMaxHeadLength];
+    NSUInteger length = YKFCBORWriteInteger(buffer, cborInteger.value);
+    return [NSData dataWithBytes:buffer length:length];
 }
 
 #pragma mark - Byte String (Major Type 2)
@@ -76,13 +59,9 @@
 
     NSArray *array = cborArray.value;
     
-    YKFCBORInteger *arrayLength = YKFCBORInteger(array.count);
-    NSData *encodedLength = [self encodeInteger:arrayLength];
-    NSMutableData *encodedArray = [[NSMutableData alloc] initWithData:encodedLength];
-    
-    // Set major type 4.
-    UInt8 *encodedValueBytes = encodedArray.mutableBytes;
-    encodedValueBytes[0] = encodedValueBytes[0] | YKFCBORArrayTagMask;
+    UInt8 head[YKFCBORMaxHeadLength];
+    NSUInteger headLength = YKFCBORWriteHead(head, YKFCBORArrayTagMask, array.count);
+    NSMutableData *encodedArray = [[NSMutableData alloc] initWithBytes:head length:headLength];
 
     // Append the elements.
     for (id element in array) {
@@ -106,13 +85,9 @@
     NSDictionary *map = cborMap.value;
     YKFAssertReturnValue(map, @"CBOR Encoding - Cannot encode nil dictionary.", nil);
     
-    YKFCBORInteger *mapPairs = YKFCBORInteger(map.count);
-    NSData *encodedPairs = [self encodeInteger:mapPairs];
-    NSMutableData *encodedMap = [[NSMutableData alloc] initWithData:encodedPairs];
-    
-    // Set major type 5.
-    UInt8 *encodedValueBytes = encodedMap.mutableBytes;
-    encodedValueBytes[0] = encodedValueBytes[0] | YKFCBORMapTagMask;
+    UInt8 head[YKFCBORMaxHeadLength];
+    NSUInteger headLength = YKFCBORWriteHead(head, YKFCBORMapTagMask, map.count);
+    NSMutableData *encodedMap = [[NSMutableData alloc] initWithBytes:head length:headLength];
 
     // Append the pairs sorted by keys.
     NSArray *keys = [map.allKeys sortedArrayUsingSelector:@selector(compare:)];
@@ -150,121 +125,16 @@
 
 #pragma mark - Helpers
 
-+ (NSData *)encodeUInt8:(UInt8)value {
-    if (value < 24) {
-        return [NSData dataWithBytes:&value length:1];
-    }
-    const UInt8 bytes[] = {YKFCBORUInt8Tag, value};
-    return [NSData dataWithBytes:bytes length:2];
-}
-
-+ (NSData *)encodeUInt16:(UInt16)value {
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt16 bigUInt16 = CFSwapInt16HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORUInt16Tag length:1];
-    [buffer appendBytes:&bigUInt16 length:sizeof(UInt16)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeUInt32:(UInt32)value {
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt32 bigUInt32 = CFSwapInt32HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORUInt32Tag length:1];
-    [buffer appendBytes:&bigUInt32 length:sizeof(UInt32)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeUInt64:(UInt64)value {
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt64 bigUInt64 = CFSwapInt64HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORUInt64Tag length:1];
-    [buffer appendBytes:&bigUInt64 length:sizeof(UInt64)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeSInt8:(SInt8)value {
-    if (value >= 0) {
-        return [self encodeUInt8:value];
-    }
-    value = -1 - value;
-    
-    if (value < 24) {
-        value |= YKFCBORNegativeIntegerTagMask;
-        return [NSData dataWithBytes:&value length:1];
-    }
-    
-    const UInt8 bytes[] = {YKFCBORSInt8Tag, value};
-    return [NSData dataWithBytes:bytes length:2];
-}
-
-+ (NSData *)encodeSInt16:(SInt16)value {
-    if (value >= 0) {
-        return [self encodeUInt16:value];
-    }
-    value = -1 - value;
-    
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt16 bigUInt16 = CFSwapInt16HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORSInt16Tag length:1];
-    [buffer appendBytes:&bigUInt16 length:sizeof(UInt16)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeSInt32:(SInt32)value {
-    if (value >= 0) {
-        return [self encodeUInt32:value];
-    }
-    value = -1 - value;
-    
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt32 bigUInt32 = CFSwapInt32HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORSInt32Tag length:1];
-    [buffer appendBytes:&bigUInt32 length:sizeof(UInt32)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeSInt64:(SInt64)value {
-    if (value >= 0) {
-        return [self encodeUInt64:value];
-    }
-    value = -1 - value;
-    
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt64 bigUInt64 = CFSwapInt64HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORSInt64Tag length:1];
-    [buffer appendBytes:&bigUInt64 length:sizeof(UInt64)];
-    
-    return [buffer copy];
-}
-
 + (NSData *)encodeData:(NSData *)value tagMask:(UInt8)tagMask {
     YKFAssertReturnValue(value, @"CBOR Encoding - Cannot encode nil data.", nil);
     
-    YKFCBORInteger *dataLength = YKFCBORInteger(value.length);
-    NSMutableData *encodedValue = nil;
-    if (dataLength) {
-        NSData *encodedLength = [self encodeInteger:dataLength];
-        encodedValue = [[NSMutableData alloc] initWithData:encodedLength];
-        [encodedValue appendData:value];
-        
-        // Set the major type 2.
-        UInt8 *encodedValueBytes = encodedValue.mutableBytes;
-        encodedValueBytes[0] = encodedValueBytes[0] | tagMask;
-    } else {
-        // Set only the major type.
-        encodedValue = [[NSMutableData alloc] initWithCapacity:1];
-        [encodedValue appendBytes:&tagMask length:1];
+    NSUInteger headLength = YKFCBORHeadLength(value.length);
+    NSMutableData *encodedValue = [[NSMutableData alloc] initWithLength:headLength + value.length];
+    UInt8 *encodedValueBytes = encodedValue.mutableBytes;
+    
+    YKFCBORWriteHead(encodedValueBytes, tagMask, value.length);
+    if (value.length) {
+        memcpy(encodedValueBytes + headLength, value.bytes, value.length);
     }
     
     return [encodedValue copy];
@@ -297,8 +167,228 @@
         YKFCBORBool *boolean = (YKFCBORBool *)object;
         return [self encodeBool:boolean];
     }
+    if ([object isKindOfClass:YKFCBORSchemaMap.class]) {
+        // Schema maps are only written in the single buffer encoding.
+        return [self encodeObjectInSingleBuffer:object];
+    }
     
     return nil;
 }
 
+#pragma mark - Single Buffer Encoding
+
++ (NSUInteger)encodedLengthOfObject:(id)object {
+    YKFAssertReturnValue(object, @"CBOR Encoding - Cannot compute the length of a nil object.", 0);
+    
+    if ([object isKindOfClass:YKFCBORInteger.class]) {
+        return YKFCBORIntegerLength(((YKFCBORInteger *)object).value);
+    }
+    if ([object isKindOfClass:YKFCBORByteString.class]) {
+        NSUInteger length = ((YKFCBORByteString *)object).value.length;
+        return YKFCBORHeadLength(length) + length;
+    }
+    if ([object isKindOfClass:YKFCBORTextString.class]) {
+        NSUInteger length = [((YKFCBORTextString *)object).value lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        return YKFCBORHeadLength(length) + length;
+    }
+    if ([object isKindOfClass:YKFCBORArray.class]) {
+        NSArray *array = ((YKFCBORArray *)object).value;
+        NSUInteger length = YKFCBORHeadLength(array.count);
+        for (id element in array) {
+            NSUInteger elementLength = [self encodedLengthOfObject:element];
+            if (!elementLength) {
+                return 0;
+            }
+            length += elementLength;
+        }
+        return length;
+    }
+    if ([object isKindOfClass:YKFCBORMap.class]) {
+        NSDictionary *map = ((YKFCBORMap *)object).value;
+        __block NSUInteger length = YKFCBORHeadLength(map.count);
+        [map enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            NSUInteger keyLength = [self encodedLengthOfObject:key];
+            NSUInteger valueLength = [self encodedLengthOfObject:value];
+            if (!keyLength || !valueLength) {
+                length = 0;
+                *stop = YES;
+                return;
+            }
+            length += keyLength + valueLength;
+        }];
+        return length;
+    }
+    if ([object isKindOfClass:YKFCBORBool.class]) {
+        return 1;
+    }
+    if ([object isKindOfClass:YKFCBORSchemaMap.class]) {
+        YKFCBORSchemaMap *map = (YKFCBORSchemaMap *)object;
+        YKFCBORMapSchema *schema = map.schema;
+        NSUInteger length = YKFCBORHeadLength(map.count);
+        for (NSUInteger i = 0; i < schema.count; ++i) {
+            id value = map[i];
+            if (!value) {
+                continue;
+            }
+            NSUInteger valueLength = [self encodedLengthOfObject:value];
+            if (!valueLength) {
+                return 0;
+            }
+            length += [schema rangeOfEncodedKeyAtIndex:i].length + valueLength;
+        }
+        return length;
+    }
+    
+    return 0;
+}
+
++ (NSData *)encodeObjectInSingleBuffer:(id)object {
+    YKFAssertReturnValue(object, @"CBOR Encoding - Cannot encode a nil object.", nil);
+    
+    NSUInteger length = [self encodedLengthOfObject:object];
+    YKFAssertReturnValue(length, @"CBOR Encoding - Cannot encode an object of unknown type.", nil);
+    
+    UInt8 *buffer = malloc(length);
+    if (!buffer) {
+        return nil;
+    }
+    
+    NSUInteger writtenLength = [self writeObject:object toBuffer:buffer capacity:length];
+    if (writtenLength != length) {
+        free(buffer);
+        return nil;
+    }
+    
+    return [NSData dataWithBytesNoCopy:buffer length:length freeWhenDone:YES];
+}
+
+/*
+ Writes the object into the buffer and returns the number of bytes written or 0 if the object does not fit or
+ cannot be encoded.
+ */
++ (NSUInteger)writeObject:(id)object toBuffer:(UInt8 *)buffer capacity:(NSUInteger)capacity {
+    if ([object isKindOfClass:YKFCBORInteger.class]) {
+        NSInteger value = ((YKFCBORInteger *)object).value;
+        if (capacity < YKFCBORIntegerLength(value)) {
+            return 0;
+        }
+        return YKFCBORWriteInteger(buffer, value);
+    }
+    
+    if ([object isKindOfClass:YKFCBORByteString.class]) {
+        NSData *data = ((YKFCBORByteString *)object).value;
+        if (!data || capacity < YKFCBORHeadLength(data.length) + data.length) {
+            return 0;
+        }
+        NSUInteger headLength = YKFCBORWriteHead(buffer, YKFCBORByteStringTagMask, data.length);
+        if (data.length) {
+            memcpy(buffer + headLength, data.bytes, data.length);
+        }
+        return headLength + data.length;
+    }
+    
+    if ([object isKindOfClass:YKFCBORTextString.class]) {
+        NSString *string = ((YKFCBORTextString *)object).value;
+        if (!string) {
+            return 0;
+        }
+        NSUInteger length = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        if (capacity < YKFCBORHeadLength(length) + length) {
+            return 0;
+        }
+        NSUInteger headLength = YKFCBORWriteHead(buffer, YKFCBORTextStringTagMask, length);
+        if (length) {
+            NSUInteger usedLength = 0;
+            BOOL converted = [string getBytes:buffer + headLength maxLength:length usedLength:&usedLength
+                                     encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, string.length) remainingRange:NULL];
+            if (!converted || usedLength != length) {
+                return 0;
+            }
+        }
+        return headLength + length;
+    }
+    
+    if ([object isKindOfClass:YKFCBORArray.class]) {
+        NSArray *array = ((YKFCBORArray *)object).value;
+        if (!array || capacity < YKFCBORHeadLength(array.count)) {
+            return 0;
+        }
+        NSUInteger offset = YKFCBORWriteHead(buffer, YKFCBORArrayTagMask, array.count);
+        for (id element in array) {
+            NSUInteger elementLength = [self writeObject:element toBuffer:buffer + offset capacity:capacity - offset];
+            if (!elementLength) {
+                return 0;
+            }
+            offset += elementLength;
+        }
+        return offset;
+    }
+    
+    if ([object isKindOfClass:YKFCBORMap.class]) {
+        NSDictionary *map = ((YKFCBORMap *)object).value;
+        if (!map || capacity < YKFCBORHeadLength(map.count)) {
+            return 0;
+        }
+        NSUInteger offset = YKFCBORWriteHead(buffer, YKFCBORMapTagMask, map.count);
+        
+        // Append the pairs sorted by keys.
+        NSArray *keys = [map.allKeys sortedArrayUsingSelector:@selector(compare:)];
+        for (id key in keys) {
+            NSUInteger keyLength = [self writeObject:key toBuffer:buffer + offset capacity:capacity - offset];
+            if (!keyLength) {
+                return 0;
+            }
+            offset += keyLength;
+            
+            NSUInteger valueLength = [self writeObject:map[key] toBuffer:buffer + offset capacity:capacity - offset];
+            if (!valueLength) {
+                return 0;
+            }
+            offset += valueLength;
+        }
+        return offset;
+    }
+    
+    if ([object isKindOfClass:YKFCBORBool.class]) {
+        if (capacity < 1) {
+            return 0;
+        }
+        buffer[0] = ((YKFCBORBool *)object).value ? 0xF5 : 0xF4;
+        return 1;
+    }
+    
+    if ([object isKindOfClass:YKFCBORSchemaMap.class]) {
+        YKFCBORSchemaMap *map = (YKFCBORSchemaMap *)object;
+        YKFCBORMapSchema *schema = map.schema;
+        if (capacity < YKFCBORHeadLength(map.count)) {
+            return 0;
+        }
+        NSUInteger offset = YKFCBORWriteHead(buffer, YKFCBORMapTagMask, map.count);
+        
+        // The schema keys are already encoded and in canonical order.
+        const UInt8 *encodedKeys = schema.encodedKeys.bytes;
+        for (NSUInteger i = 0; i < schema.count; ++i) {
+            id value = map[i];
+            if (!value) {
+                continue;
+            }
+            NSRange keyRange = [schema rangeOfEncodedKeyAtIndex:i];
+            if (capacity - offset < keyRange.length) {
+                return 0;
+            }
+            memcpy(buffer + offset, encodedKeys + keyRange.location, keyRange.length);
+            offset += keyRange.length;
+            
+            NSUInteger valueLength = [self writeObject:value toBuffer:buffer + offset capacity:capacity - offset];
+            if (!valueLength) {
+                return 0;
+            }
+            offset += valueLength;
+        }
+        return offset;
+    }
+    
+    return 0;
+}
+
 @end
@@ -0,0 +1,138 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ The maximum number of pairs in a map decoded with a field table. The CTAP2 responses have less than 32 keys.
+ */
+static const NSUInteger YKFCBORFieldDecoderMaxPairCount = 64;
+
+/*!
+ The expected type of a field value.
+ */
+typedef NS_ENUM(UInt8, YKFCBORFieldType) {
+    /// Major type 0.
+    YKFCBORFieldTypeUnsignedInteger,
+    /// Major types 0 and 1.
+    YKFCBORFieldTypeInteger,
+    /// Major type 2.
+    YKFCBORFieldTypeByteString,
+    /// Major type 3.
+    YKFCBORFieldTypeTextString,
+    /// Major type 4.
+    YKFCBORFieldTypeArray,
+    /// Major type 5.
+    YKFCBORFieldTypeMap,
+    /// Simple values true and false.
+    YKFCBORFieldTypeBool
+};
+
+/*!
+ Describes a known key of a map. The field tables are static and the order of the fields in a table defines the
+ order of the decoded values.
+ */
+typedef struct {
+    /// The key of the field when the map has integer keys (textKey is NULL).
+    SInt64 integerKey;
+    /// The UTF-8 key of the field when the map has text keys.
+    const char *_Nullable textKey;
+    /// The expected type of the value. A value with a different type fails the decoding.
+    YKFCBORFieldType type;
+    /// When YES, a map which does not contain the field fails the decoding.
+    BOOL required;
+} YKFCBORField;
+
+/*!
+ The location of a decoded field value in the buffer.
+ */
+typedef struct {
+    /// YES if the map contains the field.
+    BOOL present;
+    /// The range of the encoded value (head and content).
+    NSRange encodedRange;
+    /// The range of the string bytes for strings or of the elements for arrays and maps.
+    NSRange contentRange;
+    /// The value of integers and booleans or the number of items for arrays and maps.
+    SInt64 integerValue;
+} YKFCBORFieldValue;
+
+/*!
+ @abstract
+    Decodes CBOR maps described by static field tables in one pass over the buffer.
+
+ @discussion
+    The decoder validates the type of each known field, rejects duplicated keys and missing required fields and
+    skips the unknown keys. Strings, arrays and maps are not materialized: the decoded values are ranges in the
+    buffer which can be converted to foundation types or decoded as nested maps when needed.
+ */
+@interface YKFCBORFieldDecoder: NSObject
+
+/*!
+ @abstract
+    Decodes the map at the beginning of range.
+ @param values
+    An array with the same number of elements as the fields table. The value at index i describes the field at index i.
+ @returns
+    YES if the map is well-formed and matches the field table.
+ */
++ (BOOL)decodeMapFromData:(NSData *)data range:(NSRange)range fields:(const YKFCBORField *)fields count:(NSUInteger)count values:(YKFCBORFieldValue *)values;
+
+/*!
+ Decodes the map at the beginning of the data.
+ */
++ (BOOL)decodeMapFromData:(NSData *)data fields:(const YKFCBORField *)fields count:(NSUInteger)count values:(YKFCBORFieldValue *)values;
+
+/*!
+ Returns the byte string value as a slice of data or nil if the field is not present.
+ */
++ (nullable NSData *)byteStringFromData:(NSData *)data value:(const YKFCBORFieldValue *)value;
+
+/*!
+ Returns the text string value or nil if the field is not present or the string is not valid UTF-8.
+ */
++ (nullable NSString *)textStringFromData:(NSData *)data value:(const YKFCBORFieldValue *)value;
+
+/*!
+ Returns the encoded value as a slice of data or nil if the field is not present.
+ */
++ (nullable NSData *)encodedValueFromData:(NSData *)data value:(const YKFCBORFieldValue *)value;
+
+/*!
+ Returns the elements of an array of text strings or nil if the field is not present or an element is not a text string.
+ */
++ (nullable NSArray<NSString *> *)textStringArrayFromData:(NSData *)data value:(const YKFCBORFieldValue *)value;
+
+/*!
+ Returns the elements of an array of integers or nil if the field is not present or an element is not an integer.
+ */
++ (nullable NSArray<NSNumber *> *)integerArrayFromData:(NSData *)data value:(const YKFCBORFieldValue *)value;
+
+/*!
+ Returns the pairs of a map with text keys and boolean values or nil if the field is not present or a pair has
+ different types.
+ */
++ (nullable NSDictionary<NSString *, NSNumber *> *)boolMapFromData:(NSData *)data value:(const YKFCBORFieldValue *)value;
+
+/*!
+ Decodes the value as a foundation type (e.g. NSDictionary, NSArray). Used for values which are passed as a whole
+ to the application, like COSE keys.
+ */
++ (nullable id)objectFromData:(NSData *)data value:(const YKFCBORFieldValue *)value;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,342 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFCBORFieldDecoder.h"
+#import "YKFCBORDecoder.h"
+#import "YKFCBORDecoder+Private.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFAssert.h"
+
+#pragma mark - Item Reading
+
+/*
+ Reads the item at the cursor position, records its location in value and advances the cursor past it.
+ The content of arrays and maps is validated but not decoded.
+ */
+static BOOL YKFCBORFieldReadItem(YKFCBORDataCursor *cursor, UInt8 *head, YKFCBORFieldValue *value) {
+    NSUInteger itemOffset = cursor->offset;
+    if (!YKFCBORCursorReadByte(cursor, head)) {
+        return NO;
+    }
+    
+    if (*head == 0xF4 || *head == 0xF5) {
+        value->integerValue = *head == 0xF5;
+        value->contentRange = NSMakeRange(cursor->offset, 0);
+        value->encodedRange = NSMakeRange(itemOffset, 1);
+        return YES;
+    }
+    
+    // Tags, simple values, floats and indefinite-length items can only be the values of unknown keys since they do
+    // not match any field type. They are validated by the decoder and skipped.
+    if (!YKFCBORCursorDecodesHead(*head)) {
+        cursor->offset = itemOffset;
+        if (![YKFCBORDecoder skipObjectWithCursor:cursor depth:1]) {
+            return NO;
+        }
+        value->contentRange = NSMakeRange(itemOffset, cursor->offset - itemOffset);
+        value->encodedRange = value->contentRange;
+        return YES;
+    }
+    
+    UInt64 argument = 0;
+    if (!YKFCBORCursorReadArgument(cursor, *head & YKFCBORAdditionalInfoMask, &argument)) {
+        return NO;
+    }
+    NSUInteger contentOffset = cursor->offset;
+    
+    YKFCBORMajorType majorType = *head >> YKFCBORMajorTypeShift;
+    switch (majorType) {
+        case YKFCBORMajorTypePositiveInteger:
+        case YKFCBORMajorTypeNegativeInteger:
+            if (argument > INT64_MAX) {
+                return NO;
+            }
+            value->integerValue = majorType == YKFCBORMajorTypePositiveInteger ? (SInt64)argument : -(SInt64)argument - 1;
+            break;
+        
+        case YKFCBORMajorTypeByteString:
+        case YKFCBORMajorTypeTextString:
+            if (argument > YKFCBORCursorRemainingLength(cursor)) {
+                return NO;
+            }
+            cursor->offset += (NSUInteger)argument;
+            value->integerValue = (SInt64)argument;
+            break;
+        
+        case YKFCBORMajorTypeArray:
+        case YKFCBORMajorTypeMap: {
+            // Each item takes at least one byte.
+            if (argument > YKFCBORCursorRemainingLength(cursor)) {
+                return NO;
+            }
+            UInt64 numberOfItems = majorType == YKFCBORMajorTypeMap ? argument * 2 : argument;
+            for (UInt64 i = 0; i < numberOfItems; ++i) {
+                if (![YKFCBORDecoder skipObjectWithCursor:cursor depth:1]) {
+                    return NO;
+                }
+            }
+            value->integerValue = (SInt64)argument;
+            break;
+        }
+        
+        default:
+            return NO;
+    }
+    
+    value->contentRange = NSMakeRange(contentOffset, cursor->offset - contentOffset);
+    value->encodedRange = NSMakeRange(itemOffset, cursor->offset - itemOffset);
+    return YES;
+}
+
+static BOOL YKFCBORFieldTypeMatchesHead(YKFCBORFieldType type, UInt8 head) {
+    if (!YKFCBORCursorDecodesHead(head)) {
+        return NO;
+    }
+    YKFCBORMajorType majorType = head >> YKFCBORMajorTypeShift;
+    switch (type) {
+        case YKFCBORFieldTypeUnsignedInteger:
+            return majorType == YKFCBORMajorTypePositiveInteger;
+        case YKFCBORFieldTypeInteger:
+            return majorType == YKFCBORMajorTypePositiveInteger || majorType == YKFCBORMajorTypeNegativeInteger;
+        case YKFCBORFieldTypeByteString:
+            return majorType == YKFCBORMajorTypeByteString;
+        case YKFCBORFieldTypeTextString:
+            return majorType == YKFCBORMajorTypeTextString;
+        case YKFCBORFieldTypeArray:
+            return majorType == YKFCBORMajorTypeArray;
+        case YKFCBORFieldTypeMap:
+            return majorType == YKFCBORMajorTypeMap;
+        case YKFCBORFieldTypeBool:
+            return head == 0xF4 || head == 0xF5;
+    }
+    return NO;
+}
+
+/*
+ Returns the index of the field with the key or NSNotFound if the key is not in the table.
+ */
+static NSUInteger YKFCBORFieldIndexOfKey(const YKFCBORField *fields, NSUInteger count, const UInt8 *bytes, UInt8 keyHead, const YKFCBORFieldValue *key) {
+    BOOL isTextKey = (keyHead >> YKFCBORMajorTypeShift) == YKFCBORMajorTypeTextString;
+    
+    for (NSUInteger i = 0; i < count; ++i) {
+        const YKFCBORField *field = &fields[i];
+        if (isTextKey) {
+            if (field->textKey && strlen(field->textKey) == key->contentRange.length &&
+                memcmp(field->textKey, bytes + key->contentRange.location, key->contentRange.length) == 0) {
+                return i;
+            }
+        } else if (!field->textKey && field->integerKey == key->integerValue) {
+            return i;
+        }
+    }
+    return NSNotFound;
+}
+
+@implementation YKFCBORFieldDecoder
+
+#pragma mark - Map Decoding
+
++ (BOOL)decodeMapFromData:(NSData *)data fields:(const YKFCBORField *)fields count:(NSUInteger)count values:(YKFCBORFieldValue *)values {
+    return [self decodeMapFromData:data range:NSMakeRange(0, data.length) fields:fields count:count values:values];
+}
+
++ (BOOL)decodeMapFromData:(NSData *)data range:(NSRange)range fields:(const YKFCBORField *)fields count:(NSUInteger)count values:(YKFCBORFieldValue *)values {
+    YKFAssertReturnValue(data, @"CBOR - Decoding data is nil.", NO);
+    YKFAssertReturnValue(fields && values, @"CBOR - Missing field table.", NO);
+    YKFAssertReturnValue(NSMaxRange(range) <= data.length, @"CBOR - Decoding range out of bounds.", NO);
+    
+    memset(values, 0, count * sizeof(YKFCBORFieldValue));
+    
+    YKFCBORDataCursor cursor = YKFCBORDataCursorMake(data, range.location);
+    cursor.length = NSMaxRange(range);
+    
+    UInt8 head = 0;
+    if (!YKFCBORCursorReadByte(&cursor, &head) || (head >> YKFCBORMajorTypeShift) != YKFCBORMajorTypeMap) {
+        return NO;
+    }
+    UInt64 numberOfPairs = 0;
+    if (!YKFCBORCursorReadArgument(&cursor, head & YKFCBORAdditionalInfoMask, &numberOfPairs)) {
+        return NO;
+    }
+    if (numberOfPairs > YKFCBORFieldDecoderMaxPairCount) {
+        return NO;
+    }
+    
+    NSRange keyRanges[YKFCBORFieldDecoderMaxPairCount];
+    
+    for (NSUInteger i = 0; i < numberOfPairs; ++i) {
+        UInt8 keyHead = 0;
+        YKFCBORFieldValue key = {0};
+        if (!YKFCBORFieldReadItem(&cursor, &keyHead, &key)) {
+            return NO;
+        }
+        YKFCBORMajorType keyType = keyHead >> YKFCBORMajorTypeShift;
+        if (keyType != YKFCBORMajorTypePositiveInteger && keyType != YKFCBORMajorTypeNegativeInteger && keyType != YKFCBORMajorTypeTextString) {
+            return NO;
+        }
+        
+        // Security check: A map with duplicated keys is invalid.
+        for (NSUInteger j = 0; j < i; ++j) {
+            if (keyRanges[j].length == key.encodedRange.length &&
+                memcmp(cursor.bytes + keyRanges[j].location, cursor.bytes + key.encodedRange.location, key.encodedRange.length) == 0) {
+                return NO;
+            }
+        }
+        keyRanges[i] = key.encodedRange;
+        
+        UInt8 valueHead = 0;
+        YKFCBORFieldValue value = {0};
+        if (!YKFCBORFieldReadItem(&cursor, &valueHead, &value)) {
+            return NO;
+        }
+        
+        // Unknown keys are skipped for forward compatibility.
+        NSUInteger fieldIndex = YKFCBORFieldIndexOfKey(fields, count, cursor.bytes, keyHead, &key);
+        if (fieldIndex == NSNotFound) {
+            continue;
+        }
+        if (values[fieldIndex].present || !YKFCBORFieldTypeMatchesHead(fields[fieldIndex].type, valueHead)) {
+            return NO;
+        }
+        value.present = YES;
+        values[fieldIndex] = value;
+    }
+    
+    for (NSUInteger i = 0; i < count; ++i) {
+        if (fields[i].required && !values[i].present) {
+            return NO;
+        }
+    }
+    
+    return YES;
+}
+
+#pragma mark - Value Conversion
+
++ (NSData *)byteStringFromData:(NSData *)data value:(const YKFCBORFieldValue *)value {
+    if (!value->present) {
+        return nil;
+    }
+    return [data ykf_noCopySubdataWithRange:value->contentRange];
+}
+
++ (NSString *)textStringFromData:(NSData *)data value:(const YKFCBORFieldValue *)value {
+    if (!value->present) {
+        return nil;
+    }
+    if (!value->contentRange.length) {
+        return @"";
+    }
+    const UInt8 *bytes = (const UInt8 *)data.bytes + value->contentRange.location;
+    NSString *internedString = YKFCBORInternedTextString(bytes, value->contentRange.length);
+    if (internedString) {
+        return internedString;
+    }
+    return [[NSString alloc] initWithBytes:bytes length:value->contentRange.length encoding:NSUTF8StringEncoding];
+}
+
++ (NSData *)encodedValueFromData:(NSData *)data value:(const YKFCBORFieldValue *)value {
+    if (!value->present) {
+        return nil;
+    }
+    return [data ykf_noCopySubdataWithRange:value->encodedRange];
+}
+
++ (NSArray<NSString *> *)textStringArrayFromData:(NSData *)data value:(const YKFCBORFieldValue *)value {
+    if (!value->present) {
+        return nil;
+    }
+    YKFCBORDataCursor cursor = YKFCBORDataCursorMake(data, value->contentRange.location);
+    cursor.length = NSMaxRange(value->contentRange);
+    
+    NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)value->integerValue];
+    for (SInt64 i = 0; i < value->integerValue; ++i) {
+        UInt8 head = 0;
+        YKFCBORFieldValue element = {0};
+        if (!YKFCBORFieldReadItem(&cursor, &head, &element) || !YKFCBORFieldTypeMatchesHead(YKFCBORFieldTypeTextString, head)) {
+            return nil;
+        }
+        element.present = YES;
+        NSString *string = [self textStringFromData:data value:&element];
+        if (!string) {
+            return nil;
+        }
+        [array addObject:string];
+    }
+    return [array copy];
+}
+
++ (NSArray<NSNumber *> *)integerArrayFromData:(NSData *)data value:(const YKFCBORFieldValue *)value {
+    if (!value->present) {
+        return nil;
+    }
+    YKFCBORDataCursor cursor = YKFCBORDataCursorMake(data, value->contentRange.location);
+    cursor.length = NSMaxRange(value->contentRange);
+    
+    NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)value->integerValue];
+    for (SInt64 i = 0; i < value->integerValue; ++i) {
+        UInt8 head = 0;
+        YKFCBORFieldValue element = {0};
+        if (!YKFCBORFieldReadItem(&cursor, &head, &element) || !YKFCBORFieldTypeMatchesHead(YKFCBORFieldTypeInteger, head)) {
+            return nil;
+        }
+        [array addObject:@(element.integerValue)];
+    }
+    return [array copy];
+}
+
++ (NSDictionary<NSString *, NSNumber *> *)boolMapFromData:(NSData *)data value:(const YKFCBORFieldValue *)value {
+    if (!value->present) {
+        return nil;
+    }
+    YKFCBORDataCursor cursor = YKFCBORDataCursorMake(data, value->contentRange.location);
+    cursor.length = NSMaxRange(value->contentRange);
+    
+    NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] initWithCapacity:(NSUInteger)value->integerValue];
+    for (SInt64 i = 0; i < value->integerValue; ++i) {
+        UInt8 keyHead = 0;
+        UInt8 valueHead = 0;
+        YKFCBORFieldValue pairKey = {0};
+        YKFCBORFieldValue pairValue = {0};
+        if (!YKFCBORFieldReadItem(&cursor, &keyHead, &pairKey) || !YKFCBORFieldTypeMatchesHead(YKFCBORFieldTypeTextString, keyHead)) {
+            return nil;
+        }
+        if (!YKFCBORFieldReadItem(&cursor, &valueHead, &pairValue) || !YKFCBORFieldTypeMatchesHead(YKFCBORFieldTypeBool, valueHead)) {
+            return nil;
+        }
+        pairKey.present = YES;
+        NSString *key = [self textStringFromData:data value:&pairKey];
+        
+        // Security check: A map with duplicated keys is invalid.
+        if (!key || dictionary[key]) {
+            return nil;
+        }
+        dictionary[key] = @(pairValue.integerValue != 0);
+    }
+    return [dictionary copy];
+}
+
++ (id)objectFromData:(NSData *)data value:(const YKFCBORFieldValue *)value {
+    if (!value->present) {
+        return nil;
+    }
+    NSUInteger offset = value->encodedRange.location;
+    id cborObject = [YKFCBORDecoder decodeObjectFromData:data offset:&offset];
+    if (!cborObject) {
+        return nil;
+    }
+    return [YKFCBORDecoder convertCBORObjectToFoundationType:cborObject];
+}
+
+@end
@@ -0,0 +1,128 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFCBORType.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ The maximum number of keys in a map schema.
+ */
+static const NSUInteger YKFCBORMapSchemaMaxKeyCount = 16;
+
+/*
+ YKFCBORMapSchema
+ */
+
+/*!
+ Describes a map with a fixed set of keys, like the CTAP2 request parameters or the WebAuthn entities.
+
+ @discussion
+    The keys are encoded once, when the schema is created, and must be provided in the CTAP2 canonical order
+    (shorter encoded keys first, then lexicographic order of the encoded bytes). A schema is immutable and
+    is meant to be created once and shared by all the maps with the same shape.
+ */
+@interface YKFCBORMapSchema: NSObject
+
+/*!
+ The number of keys in the schema.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ The keys (CBOR types) in canonical order.
+ */
+@property (nonatomic, readonly) NSArray *keys;
+
+/*!
+ The encoded keys, concatenated in canonical order.
+ */
+@property (nonatomic, readonly) NSData *encodedKeys;
+
+/*!
+ @abstract
+    Creates a schema for the list of keys.
+ @returns
+    The schema or nil if the keys cannot be encoded, are not in canonical order or are more than
+    YKFCBORMapSchemaMaxKeyCount.
+ */
+- (nullable instancetype)initWithKeys:(NSArray *)keys NS_DESIGNATED_INITIALIZER;
+
+/*!
+ Creates a schema with the integer keys 1...count, the layout used by all the CTAP2 command parameters.
+ */
+- (nullable instancetype)initWithIntegerKeyCount:(NSUInteger)count;
+
+/*!
+ Returns the range of the encoded key at index in encodedKeys.
+ */
+- (NSRange)rangeOfEncodedKeyAtIndex:(NSUInteger)index;
+
+/*
+ Not available: use [initWithKeys:].
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/*
+ YKFCBORSchemaMap
+ */
+
+#define YKFCBORSchemaMap(schema) [YKFCBORSchemaMap cborSchemaMapWithSchema:schema]
+
+/*!
+ A CBOR map with the shape described by a schema. The values are stored by the index of their key in the schema
+ and the encoder writes them in the schema order, without sorting or hashing the keys.
+ */
+@interface YKFCBORSchemaMap: NSObject
+
+/*!
+ The schema of the map.
+ */
+@property (nonatomic, readonly) YKFCBORMapSchema *schema;
+
+/*!
+ The number of keys which have a value.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
++ (YKFCBORSchemaMap *)cborSchemaMapWithSchema:(YKFCBORMapSchema *)schema;
+
+- (instancetype)initWithSchema:(YKFCBORMapSchema *)schema NS_DESIGNATED_INITIALIZER;
+
+/*!
+ Returns the value (CBOR type) for the key at index in the schema or nil if the value was not set.
+ */
+- (nullable id)objectAtIndexedSubscript:(NSUInteger)index;
+
+/*!
+ Sets the value (CBOR type) for the key at index in the schema. Setting nil removes the value.
+ */
+- (void)setObject:(nullable id)object atIndexedSubscript:(NSUInteger)index;
+
+/*!
+ Sets the value for an integer key in a schema created with [initWithIntegerKeyCount:].
+ */
+- (void)setObject:(nullable id)object forIntegerKey:(NSUInteger)key;
+
+/*
+ Not available: use [initWithSchema:].
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
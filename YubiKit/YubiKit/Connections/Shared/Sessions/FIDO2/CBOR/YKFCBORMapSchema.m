@@ -0,0 +1,152 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFCBORMapSchema.h"
+#import "YKFCBOREncoder.h"
+#import "YKFAssert.h"
+
+#pragma mark - YKFCBORMapSchema
+
+@interface YKFCBORMapSchema() {
+    // Offsets of the encoded keys in encodedKeys. The last entry is the total length.
+    NSUInteger keyOffsets[YKFCBORMapSchemaMaxKeyCount + 1];
+}
+
+@property (nonatomic, readwrite) NSUInteger count;
+@property (nonatomic, readwrite) NSArray *keys;
+@property (nonatomic, readwrite) NSData *encodedKeys;
+
+// YES when the keys are the integers 1...count.
+@property (nonatomic) BOOL hasIntegerKeys;
+
+@end
+
+@implementation YKFCBORMapSchema
+
+- (instancetype)initWithKeys:(NSArray *)keys {
+    YKFAssertAbortInit(keys);
+    YKFAssertAbortInit(keys.count <= YKFCBORMapSchemaMaxKeyCount);
+    
+    self = [super init];
+    if (self) {
+        NSMutableData *encodedKeys = [[NSMutableData alloc] init];
+        NSData *previousKey = nil;
+        
+        for (NSUInteger i = 0; i < keys.count; ++i) {
+            NSData *encodedKey = [YKFCBOREncoder encodeObjectInSingleBuffer:keys[i]];
+            YKFAssertAbortInit(encodedKey);
+            
+            // The schema defines the encoding order, so it must be the canonical one.
+            if (previousKey) {
+                BOOL isShorter = previousKey.length < encodedKey.length;
+                BOOL isSmaller = previousKey.length == encodedKey.length && memcmp(previousKey.bytes, encodedKey.bytes, encodedKey.length) < 0;
+                YKFAssertAbortInit(isShorter || isSmaller);
+            }
+            
+            keyOffsets[i] = encodedKeys.length;
+            [encodedKeys appendData:encodedKey];
+            previousKey = encodedKey;
+        }
+        keyOffsets[keys.count] = encodedKeys.length;
+        
+        self.count = keys.count;
+        self.keys = [keys copy];
+        self.encodedKeys = [encodedKeys copy];
+    }
+    return self;
+}
+
+- (instancetype)initWithIntegerKeyCount:(NSUInteger)count {
+    YKFAssertAbortInit(count <= YKFCBORMapSchemaMaxKeyCount);
+    
+    NSMutableArray *keys = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger key = 1; key <= count; ++key) {
+        [keys addObject:YKFCBORInteger(key)];
+    }
+    
+    self = [self initWithKeys:keys];
+    if (self) {
+        self.hasIntegerKeys = YES;
+    }
+    return self;
+}
+
+- (NSRange)rangeOfEncodedKeyAtIndex:(NSUInteger)index {
+    YKFAssertReturnValue(index < self.count, @"CBOR Schema - Key index out of bounds.", NSMakeRange(NSNotFound, 0));
+    return NSMakeRange(keyOffsets[index], keyOffsets[index + 1] - keyOffsets[index]);
+}
+
+@end
+
+#pragma mark - YKFCBORSchemaMap
+
+@interface YKFCBORSchemaMap() {
+    __strong id values[YKFCBORMapSchemaMaxKeyCount];
+}
+
+@property (nonatomic, readwrite) YKFCBORMapSchema *schema;
+@property (nonatomic, readwrite) NSUInteger count;
+
+@end
+
+@implementation YKFCBORSchemaMap
+
++ (YKFCBORSchemaMap *)cborSchemaMapWithSchema:(YKFCBORMapSchema *)schema {
+    return [[YKFCBORSchemaMap alloc] initWithSchema:schema];
+}
+
+- (instancetype)initWithSchema:(YKFCBORMapSchema *)schema {
+    NSParameterAssert(schema);
+    self = [super init];
+    if (self) {
+        self.schema = schema;
+    }
+    return self;
+}
+
+- (id)objectAtIndexedSubscript:(NSUInteger)index {
+    YKFAssertReturnValue(index < self.schema.count, @"CBOR Schema - Key index out of bounds.", nil);
+    return values[index];
+}
+
+- (void)setObject:(id)object atIndexedSubscript:(NSUInteger)index {
+    YKFAssertReturn(index < self.schema.count, @"CBOR Schema - Key index out of bounds.");
+    
+    if (values[index] && !object) {
+        --self.count;
+    } else if (!values[index] && object) {
+        ++self.count;
+    }
+    values[index] = object;
+}
+
+- (void)setObject:(id)object forIntegerKey:(NSUInteger)key {
+    YKFAssertReturn(self.schema.hasIntegerKeys, @"CBOR Schema - The schema does not have integer keys.");
+    YKFAssertReturn(key >= 1, @"CBOR Schema - Integer keys start from 1.");
+    
+    self[key - 1] = object;
+}
+
+- (NSString *)description {
+    NSMutableArray *pairs = [[NSMutableArray alloc] initWithCapacity:self.count];
+    for (NSUInteger i = 0; i < self.schema.count; ++i) {
+        if (values[i]) {
+            [pairs addObject:[NSString stringWithFormat:@"%@: %@", self.schema.keys[i], values[i]]];
+        }
+    }
+    NSString *className = NSStringFromClass(self.class);
+    return [NSString stringWithFormat:@"%@: {%@}", className, [pairs componentsJoinedByString:@", "]];
+}
+
+@end
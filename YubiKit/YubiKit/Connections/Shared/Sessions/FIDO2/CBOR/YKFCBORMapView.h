@@ -0,0 +1,100 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFCBORType.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Lazy view over a CBOR encoded map. The top level map is indexed once when the view is created, recording the
+ location of each value in the buffer. Values are decoded only when they are read and byte strings are returned
+ as slices of the buffer.
+
+ @discussion
+    The keys are CBOR types (e.g. YKFCBORInteger, YKFCBORTextString) like the keys of a decoded YKFCBORMap.
+ */
+@interface YKFCBORMapView: NSObject
+
+/*!
+ The buffer which contains the encoded map.
+ */
+@property (nonatomic, readonly) NSData *data;
+
+/*!
+ The number of pairs in the map.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ The keys of the map, in the order in which they are encoded.
+ */
+@property (nonatomic, readonly) NSArray *keys;
+
+/*!
+ @abstract
+    Creates a view for the CBOR map at the beginning of the data.
+ @returns
+    The view or nil if the data does not start with a well-formed map or the map contains duplicated keys.
+ */
+- (nullable instancetype)initWithData:(NSData *)data NS_DESIGNATED_INITIALIZER;
+
+/*!
+ Returns YES if the map contains the key.
+ */
+- (BOOL)containsKey:(id)key;
+
+/*!
+ Returns the range of the encoded value in data or {NSNotFound, 0} if the map does not contain the key.
+ */
+- (NSRange)rangeOfEncodedObjectForKey:(id)key;
+
+/*!
+ Returns the encoded value (head + content) as a slice of data, without decoding it.
+ */
+- (nullable NSData *)encodedObjectForKey:(id)key;
+
+/*!
+ Decodes the value as a CBOR type (e.g. YKFCBORByteString).
+ */
+- (nullable id)cborObjectForKey:(id)key;
+
+/*!
+ Decodes the value as a foundation type (e.g. NSData, NSDictionary).
+ */
+- (nullable id)objectForKey:(id)key;
+
+/*!
+ Returns the content of a byte string value as a slice of data or nil if the value is not a byte string.
+ */
+- (nullable NSData *)byteStringForKey:(id)key;
+
+/*!
+ Returns a text string value or nil if the value is not a text string.
+ */
+- (nullable NSString *)textStringForKey:(id)key;
+
+/*!
+ Returns a lazy view for a map value or nil if the value is not a map.
+ */
+- (nullable YKFCBORMapView *)mapViewForKey:(id)key;
+
+/*
+ Not available: use [initWithData:].
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,178 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFCBORMapView.h"
+#import "YKFCBORDecoder.h"
+#import "YKFCBORDecoder+Private.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFAssert.h"
+
+@interface YKFCBORMapView()
+
+@property (nonatomic, readwrite) NSData *data;
+@property (nonatomic, readwrite) NSArray *keys;
+
+// Key -> NSValue(NSRange) of the encoded value in data.
+@property (nonatomic) NSDictionary *index;
+
+@end
+
+@implementation YKFCBORMapView
+
+- (instancetype)initWithData:(NSData *)data {
+    YKFAssertAbortInit(data);
+    
+    self = [super init];
+    if (self) {
+        // The values are slices of the buffer, so keep an immutable copy (a retain if the data is immutable).
+        self.data = [data copy];
+        
+        YKFCBORDataCursor cursor = YKFCBORDataCursorMake(self.data, 0);
+        
+        UInt8 head = 0;
+        YKFAbortInitWhen(!YKFCBORCursorReadByte(&cursor, &head));
+        YKFAbortInitWhen((head >> YKFCBORMajorTypeShift) != YKFCBORMajorTypeMap);
+        
+        UInt64 numberOfPairs = 0;
+        YKFAbortInitWhen(!YKFCBORCursorReadArgument(&cursor, head & YKFCBORAdditionalInfoMask, &numberOfPairs));
+        YKFAbortInitWhen(numberOfPairs > YKFCBORCursorRemainingLength(&cursor) / 2);
+        
+        NSMutableArray *keys = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)numberOfPairs];
+        NSMutableDictionary *index = [[NSMutableDictionary alloc] initWithCapacity:(NSUInteger)numberOfPairs];
+        
+        for (UInt64 i = 0; i < numberOfPairs; ++i) {
+            id key = [YKFCBORDecoder decodeObjectWithCursor:&cursor depth:1];
+            YKFAbortInitWhen(!key);
+            
+            NSUInteger valueOffset = cursor.offset;
+            YKFAbortInitWhen(![YKFCBORDecoder skipObjectWithCursor:&cursor depth:1]);
+            
+            // Security check: A map with duplicated keys is invalid.
+            YKFAbortInitWhen(index[key] != nil);
+            
+            index[key] = [NSValue valueWithRange:NSMakeRange(valueOffset, cursor.offset - valueOffset)];
+            [keys addObject:key];
+        }
+        
+        self.keys = [keys copy];
+        self.index = [index copy];
+    }
+    return self;
+}
+
+#pragma mark - Properties
+
+- (NSUInteger)count {
+    return self.index.count;
+}
+
+#pragma mark - Lookup
+
+- (BOOL)containsKey:(id)key {
+    return self.index[key] != nil;
+}
+
+- (NSRange)rangeOfEncodedObjectForKey:(id)key {
+    NSValue *range = self.index[key];
+    return range ? range.rangeValue : NSMakeRange(NSNotFound, 0);
+}
+
+- (NSData *)encodedObjectForKey:(id)key {
+    NSRange range = [self rangeOfEncodedObjectForKey:key];
+    if (range.location == NSNotFound) {
+        return nil;
+    }
+    return [self.data ykf_noCopySubdataWithRange:range];
+}
+
+- (id)cborObjectForKey:(id)key {
+    NSRange range = [self rangeOfEncodedObjectForKey:key];
+    if (range.location == NSNotFound) {
+        return nil;
+    }
+    NSUInteger offset = range.location;
+    return [YKFCBORDecoder decodeObjectFromData:self.data offset:&offset];
+}
+
+- (id)objectForKey:(id)key {
+    id cborObject = [self cborObjectForKey:key];
+    if (!cborObject) {
+        return nil;
+    }
+    return [YKFCBORDecoder convertCBORObjectToFoundationType:cborObject];
+}
+
+- (NSData *)byteStringForKey:(id)key {
+    NSRange contentRange = [self contentRangeOfObjectForKey:key majorType:YKFCBORMajorTypeByteString];
+    if (contentRange.location == NSNotFound) {
+        return nil;
+    }
+    return [self.data ykf_noCopySubdataWithRange:contentRange];
+}
+
+- (NSString *)textStringForKey:(id)key {
+    NSRange contentRange = [self contentRangeOfObjectForKey:key majorType:YKFCBORMajorTypeTextString];
+    if (contentRange.location == NSNotFound) {
+        return nil;
+    }
+    if (!contentRange.length) {
+        return @"";
+    }
+    const UInt8 *bytes = (const UInt8 *)self.data.bytes + contentRange.location;
+    NSString *internedString = YKFCBORInternedTextString(bytes, contentRange.length);
+    if (internedString) {
+        return internedString;
+    }
+    return [[NSString alloc] initWithBytes:bytes length:contentRange.length encoding:NSUTF8StringEncoding];
+}
+
+- (YKFCBORMapView *)mapViewForKey:(id)key {
+    NSRange range = [self rangeOfEncodedObjectForKey:key];
+    if (range.location == NSNotFound) {
+        return nil;
+    }
+    UInt8 head = ((const UInt8 *)self.data.bytes)[range.location];
+    if ((head >> YKFCBORMajorTypeShift) != YKFCBORMajorTypeMap) {
+        return nil;
+    }
+    return [[YKFCBORMapView alloc] initWithData:[self.data ykf_noCopySubdataWithRange:range]];
+}
+
+#pragma mark - Helpers
+
+/*
+ Returns the range of the content of a string value (without the head) or {NSNotFound, 0} if the map does not
+ contain the key or the value has a different major type.
+ */
+- (NSRange)contentRangeOfObjectForKey:(id)key majorType:(YKFCBORMajorType)majorType {
+    NSRange range = [self rangeOfEncodedObjectForKey:key];
+    if (range.location == NSNotFound) {
+        return range;
+    }
+    
+    YKFCBORDataCursor cursor = YKFCBORDataCursorMake(self.data, range.location);
+    UInt8 head = 0;
+    UInt64 length = 0;
+    if (!YKFCBORCursorReadByte(&cursor, &head) || (head >> YKFCBORMajorTypeShift) != majorType) {
+        return NSMakeRange(NSNotFound, 0);
+    }
+    if (!YKFCBORCursorReadArgument(&cursor, head & YKFCBORAdditionalInfoMask, &length)) {
+        return NSMakeRange(NSNotFound, 0);
+    }
+    
+    // The value was validated when the map was indexed, so the content fits in the value range.
+    return NSMakeRange(cursor.offset, (NSUInteger)length);
+}
+
+@end
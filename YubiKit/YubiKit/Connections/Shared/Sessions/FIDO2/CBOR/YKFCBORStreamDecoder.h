@@ -0,0 +1,112 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFCBORType.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class YKFCBORStreamDecoder;
+
+/*!
+ Receives the items decoded by a YKFCBORStreamDecoder as soon as they are complete.
+ */
+@protocol YKFCBORStreamDecoderDelegate<NSObject>
+
+/*!
+ Called when a top level item is complete. The object is a CBOR type (e.g. YKFCBORMap).
+ */
+- (void)streamDecoder:(YKFCBORStreamDecoder *)decoder didDecodeObject:(id)object;
+
+@optional
+
+/*!
+ Called when an element of an array or a value of a map is complete, before the enclosing container is complete.
+ The depth is 1 for the elements of a top level container. Allows processing the elements of a large list before
+ the rest of the list was received.
+ */
+- (void)streamDecoder:(YKFCBORStreamDecoder *)decoder didDecodeNestedObject:(id)object depth:(NSUInteger)depth;
+
+/*!
+ Called with the bytes of a byte or text string as they arrive, before the string is complete. For indefinite-length
+ strings the bytes of all the chunks are reported in order. The data is a slice of the appended data.
+ */
+- (void)streamDecoder:(YKFCBORStreamDecoder *)decoder didReceiveStringData:(NSData *)data depth:(NSUInteger)depth;
+
+@end
+
+/*!
+ @abstract
+    Incremental (push) CBOR decoder.
+ 
+ @discussion
+    The data is appended in chunks of any size, as it is received from the transport, and each item is reported
+    to the delegate as soon as its last byte was appended. The decoder keeps only the partial head of the current
+    item and the stack of open containers, so a response does not need to be buffered before decoding it.
+    
+    All the major types are decoded, including the indefinite-length strings, arrays and maps, the tags (decoded as
+    YKFCBORTaggedItem), the simple values (YKFCBORBool, YKFCBORSimpleValue) and the half, single and double precision
+    floats (YKFCBORFloat). The map keys must be integers or strings.
+    
+    The decoder stops at the first malformed item and must be reset before decoding new data.
+ */
+@interface YKFCBORStreamDecoder: NSObject
+
+/*!
+ The delegate which receives the decoded items.
+ */
+@property (nonatomic, weak, nullable) id<YKFCBORStreamDecoderDelegate> delegate;
+
+/*!
+ YES after the decoder received a malformed item.
+ */
+@property (nonatomic, readonly) BOOL failed;
+
+/*!
+ YES when the decoder received the beginning of an item which is not complete yet.
+ */
+@property (nonatomic, readonly) BOOL hasPartialObject;
+
+- (instancetype)initWithDelegate:(nullable id<YKFCBORStreamDecoderDelegate>)delegate NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract
+    Decodes the next chunk of data. The delegate is called synchronously for every item completed by the chunk.
+ @returns
+    NO if the data contains a malformed item or if the decoder failed before.
+ */
+- (BOOL)appendData:(NSData *)data;
+
+/*!
+ Discards the partial item and the failed state.
+ */
+- (void)reset;
+
+/*!
+ @abstract
+    Decodes the single item which starts at offset in a complete buffer and advances the offset past the decoded
+    item. Used by YKFCBORDecoder for the items which are not handled by its cursor decoder.
+ @returns
+    The object or nil if the item is malformed or incomplete. The offset is not modified when decoding fails.
+ */
++ (nullable id)decodeObjectFromData:(NSData *)data offset:(NSUInteger *)offset;
+
+/*
+ Not available: use [initWithDelegate:].
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
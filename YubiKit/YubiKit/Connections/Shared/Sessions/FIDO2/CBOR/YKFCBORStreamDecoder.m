@@ -0,0 +1,539 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <math.h>
+#import "YKFCBORStreamDecoder.h"
+#import "YKFCBORDecoder+Private.h"
+#import "YKFCBORTag.h"
+#import "YKFAssert.h"
+#import "YKFNSDataAdditions+Private.h"
+
+/*
+ The string buffers are preallocated with the declared length, up to this size. Longer strings grow while their
+ bytes are received, so a malformed length cannot allocate a large buffer upfront.
+ */
+static const NSUInteger YKFCBORStreamDecoderMaxPreallocatedLength = 4096;
+
+typedef NS_ENUM(NSUInteger, YKFCBORStreamDecoderState) {
+    /// Waiting for the first byte of an item.
+    YKFCBORStreamDecoderStateHead,
+    /// Waiting for the remaining bytes of the argument (length, value or tag number).
+    YKFCBORStreamDecoderStateArgument,
+    /// Waiting for the remaining bytes of a definite-length string.
+    YKFCBORStreamDecoderStateStringData
+};
+
+/*
+ Converts an IEEE 754 half precision float (RFC 8949, Appendix D).
+ */
+static double YKFCBORHalfPrecisionToDouble(UInt16 half) {
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+    
+    double value = 0;
+    if (exponent == 0) {
+        value = ldexp(mantissa, -24);
+    } else if (exponent != 31) {
+        value = ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        value = mantissa == 0 ? INFINITY : NAN;
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+#pragma mark - YKFCBORStreamFrame
+
+/*
+ An open container (array, map, tag or indefinite-length string) on the decoder stack.
+ */
+@interface YKFCBORStreamFrame: NSObject
+
+@property (nonatomic) YKFCBORMajorType majorType;
+@property (nonatomic) BOOL indefinite;
+
+/// The number of items left for definite-length arrays and maps. A map has two items per pair.
+@property (nonatomic) UInt64 remainingCount;
+
+@property (nonatomic) NSMutableArray *elements;
+@property (nonatomic) NSMutableDictionary *pairs;
+@property (nonatomic) id pendingKey;
+@property (nonatomic) UInt64 tag;
+@property (nonatomic) NSMutableData *chunks;
+
+@end
+
+@implementation YKFCBORStreamFrame
+@end
+
+#pragma mark - YKFCBORStreamDecoder
+
+@interface YKFCBORStreamDecoder() {
+    YKFCBORStreamDecoderState state;
+    UInt8 pendingHead;
+    UInt64 argument;
+    NSUInteger remainingArgumentLength;
+    UInt64 remainingStringLength;
+    
+    // When set, the decoding stops after the first top level item, which is kept in decodedObject.
+    BOOL stopsAfterObject;
+    id decodedObject;
+}
+
+@property (nonatomic, readwrite) BOOL failed;
+
+@property (nonatomic) NSMutableArray<YKFCBORStreamFrame *> *frames;
+
+// The buffer which receives the bytes of the current string. For the chunks of an indefinite-length string
+// this is the buffer of the enclosing frame, so the chunks are concatenated without copies.
+@property (nonatomic) NSMutableData *stringData;
+
+@end
+
+@implementation YKFCBORStreamDecoder
+
+- (instancetype)initWithDelegate:(id<YKFCBORStreamDecoderDelegate>)delegate {
+    self = [super init];
+    if (self) {
+        self.delegate = delegate;
+        self.frames = [[NSMutableArray alloc] initWithCapacity:YKFCBORDecoderMaxNestingDepth];
+    }
+    return self;
+}
+
+- (BOOL)hasPartialObject {
+    return state != YKFCBORStreamDecoderStateHead || self.frames.count > 0;
+}
+
+- (void)reset {
+    state = YKFCBORStreamDecoderStateHead;
+    pendingHead = 0;
+    argument = 0;
+    remainingArgumentLength = 0;
+    remainingStringLength = 0;
+    
+    [self.frames removeAllObjects];
+    self.stringData = nil;
+    self.failed = NO;
+    decodedObject = nil;
+}
+
++ (id)decodeObjectFromData:(NSData *)data offset:(NSUInteger *)offset {
+    YKFAssertReturnValue(data, @"CBOR - Decoding data is nil.", nil);
+    YKFAssertReturnValue(offset, @"CBOR - Decoding offset is nil.", nil);
+    if (*offset >= data.length) {
+        return nil;
+    }
+    
+    YKFCBORStreamDecoder *decoder = [[YKFCBORStreamDecoder alloc] initWithDelegate:nil];
+    decoder->stopsAfterObject = YES;
+    
+    NSData *remainingData = [data ykf_noCopySubdataWithRange:NSMakeRange(*offset, data.length - *offset)];
+    NSUInteger decodedLength = 0;
+    if (![decoder decodeData:remainingData decodedLength:&decodedLength] || !decoder->decodedObject) {
+        return nil;
+    }
+    
+    *offset += decodedLength;
+    return decoder->decodedObject;
+}
+
+#pragma mark - Input
+
+- (BOOL)appendData:(NSData *)data {
+    return [self decodeData:data decodedLength:NULL];
+}
+
+- (BOOL)decodeData:(NSData *)data decodedLength:(NSUInteger *)decodedLength {
+    if (self.failed) {
+        return NO;
+    }
+    
+    const UInt8 *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger offset = 0;
+    
+    while (offset < length && !(stopsAfterObject && decodedObject)) {
+        switch (state) {
+            case YKFCBORStreamDecoderStateHead:
+                if (![self processHead:bytes[offset++]]) {
+                    return [self fail];
+                }
+                break;
+            
+            case YKFCBORStreamDecoderStateArgument:
+                while (offset < length && remainingArgumentLength) {
+                    argument = (argument << 8) | bytes[offset++];
+                    --remainingArgumentLength;
+                }
+                if (!remainingArgumentLength) {
+                    state = YKFCBORStreamDecoderStateHead;
+                    if (![self processArgument]) {
+                        return [self fail];
+                    }
+                }
+                break;
+            
+            case YKFCBORStreamDecoderStateStringData: {
+                NSUInteger size = (NSUInteger)MIN((UInt64)(length - offset), remainingStringLength);
+                [self.stringData appendBytes:bytes + offset length:size];
+                
+                if ([self.delegate respondsToSelector:@selector(streamDecoder:didReceiveStringData:depth:)]) {
+                    NSData *chunk = [data ykf_noCopySubdataWithRange:NSMakeRange(offset, size)];
+                    [self.delegate streamDecoder:self didReceiveStringData:chunk depth:[self depthOfCurrentString]];
+                }
+                
+                offset += size;
+                remainingStringLength -= size;
+                if (!remainingStringLength) {
+                    state = YKFCBORStreamDecoderStateHead;
+                    if (![self completeString]) {
+                        return [self fail];
+                    }
+                }
+                break;
+            }
+        }
+    }
+    
+    if (decodedLength) {
+        *decodedLength = offset;
+    }
+    return YES;
+}
+
+- (BOOL)fail {
+    self.failed = YES;
+    return NO;
+}
+
+#pragma mark - Heads
+
+- (BOOL)processHead:(UInt8)head {
+    YKFCBORMajorType majorType = head >> YKFCBORMajorTypeShift;
+    UInt8 additionalInfo = head & YKFCBORAdditionalInfoMask;
+    
+    // An indefinite-length string contains only definite-length strings of the same type.
+    YKFCBORStreamFrame *frame = self.frames.lastObject;
+    if ([self isIndefiniteStringFrame:frame] && head != YKFCBORBreakCode) {
+        if (majorType != frame.majorType || additionalInfo == YKFCBORIndefiniteLengthInfo) {
+            return NO;
+        }
+    }
+    
+    pendingHead = head;
+    argument = 0;
+    
+    if (additionalInfo < YKFCBORUInt8Tag) {
+        argument = additionalInfo;
+        return [self processArgument];
+    }
+    if (additionalInfo <= YKFCBORUInt64Tag) {
+        // 24, 25, 26, 27 -> 1, 2, 4, 8 bytes.
+        remainingArgumentLength = 1 << (additionalInfo - YKFCBORUInt8Tag);
+        state = YKFCBORStreamDecoderStateArgument;
+        return YES;
+    }
+    if (additionalInfo == YKFCBORIndefiniteLengthInfo) {
+        return [self processIndefiniteLengthHead:majorType];
+    }
+    
+    // Reserved values 28, 29, 30.
+    return NO;
+}
+
+- (BOOL)processIndefiniteLengthHead:(YKFCBORMajorType)majorType {
+    switch (majorType) {
+        case YKFCBORMajorTypeByteString:
+        case YKFCBORMajorTypeTextString: {
+            YKFCBORStreamFrame *frame = [self pushFrameWithMajorType:majorType];
+            frame.indefinite = YES;
+            frame.chunks = [[NSMutableData alloc] init];
+            return frame != nil;
+        }
+        
+        case YKFCBORMajorTypeArray:
+        case YKFCBORMajorTypeMap: {
+            YKFCBORStreamFrame *frame = [self pushFrameWithMajorType:majorType];
+            frame.indefinite = YES;
+            return frame != nil;
+        }
+        
+        case YKFCBORMajorTypeSimpleValue:
+            return [self processBreak];
+        
+        default:
+            return NO;
+    }
+}
+
+- (BOOL)processArgument {
+    YKFCBORMajorType majorType = pendingHead >> YKFCBORMajorTypeShift;
+    
+    switch (majorType) {
+        case YKFCBORMajorTypePositiveInteger:
+            if (argument > INT64_MAX) {
+                return NO;
+            }
+            return [self completeObject:YKFCBORInteger((NSInteger)argument)];
+        
+        case YKFCBORMajorTypeNegativeInteger:
+            if (argument > INT64_MAX) {
+                return NO;
+            }
+            return [self completeObject:YKFCBORInteger(-(NSInteger)argument - 1)];
+        
+        case YKFCBORMajorTypeByteString:
+        case YKFCBORMajorTypeTextString: {
+            YKFCBORStreamFrame *frame = self.frames.lastObject;
+            if ([self isIndefiniteStringFrame:frame]) {
+                self.stringData = frame.chunks;
+            } else {
+                NSUInteger capacity = (NSUInteger)MIN(argument, (UInt64)YKFCBORStreamDecoderMaxPreallocatedLength);
+                self.stringData = [[NSMutableData alloc] initWithCapacity:capacity];
+            }
+            if (!argument) {
+                return [self completeString];
+            }
+            remainingStringLength = argument;
+            state = YKFCBORStreamDecoderStateStringData;
+            return YES;
+        }
+        
+        case YKFCBORMajorTypeArray:
+        case YKFCBORMajorTypeMap: {
+            if (!argument) {
+                id object = majorType == YKFCBORMajorTypeArray ? YKFCBORArray(@[]) : YKFCBORMap(@{});
+                return [self completeObject:object];
+            }
+            // A map has a key and a value for each pair.
+            if (majorType == YKFCBORMajorTypeMap && argument > UINT64_MAX / 2) {
+                return NO;
+            }
+            YKFCBORStreamFrame *frame = [self pushFrameWithMajorType:majorType];
+            frame.remainingCount = majorType == YKFCBORMajorTypeMap ? argument * 2 : argument;
+            return frame != nil;
+        }
+        
+        case YKFCBORMajorTypeTag: {
+            YKFCBORStreamFrame *frame = [self pushFrameWithMajorType:majorType];
+            frame.tag = argument;
+            return frame != nil;
+        }
+        
+        case YKFCBORMajorTypeSimpleValue:
+            return [self processSimpleValue];
+    }
+    return NO;
+}
+
+- (BOOL)processSimpleValue {
+    UInt8 additionalInfo = pendingHead & YKFCBORAdditionalInfoMask;
+    
+    // false, true
+    if (additionalInfo == 20 || additionalInfo == 21) {
+        return [self completeObject:YKFCBORBool(additionalInfo == 21)];
+    }
+    if (additionalInfo < YKFCBORUInt8Tag) {
+        return [self completeObject:YKFCBORSimpleValue(additionalInfo)];
+    }
+    
+    switch (additionalInfo) {
+        // Simple values 32...255 in the extended form. The lower values must use the short form.
+        case 24:
+            if (argument < 32) {
+                return NO;
+            }
+            return [self completeObject:YKFCBORSimpleValue((UInt8)argument)];
+        
+        // Half precision float
+        case 25:
+            return [self completeObject:YKFCBORFloat(YKFCBORHalfPrecisionToDouble((UInt16)argument))];
+        
+        // Single precision float
+        case 26: {
+            UInt32 bits = (UInt32)argument;
+            float value = 0;
+            memcpy(&value, &bits, sizeof(value));
+            return [self completeObject:YKFCBORFloat(value)];
+        }
+        
+        // Double precision float
+        case 27: {
+            UInt64 bits = argument;
+            double value = 0;
+            memcpy(&value, &bits, sizeof(value));
+            return [self completeObject:YKFCBORFloat(value)];
+        }
+        
+        default:
+            return NO;
+    }
+}
+
+- (BOOL)processBreak {
+    YKFCBORStreamFrame *frame = self.frames.lastObject;
+    if (!frame.indefinite) {
+        return NO;
+    }
+    
+    switch (frame.majorType) {
+        case YKFCBORMajorTypeByteString:
+            [self.frames removeLastObject];
+            return [self completeObject:YKFCBORByteString(frame.chunks)];
+        
+        case YKFCBORMajorTypeTextString: {
+            [self.frames removeLastObject];
+            NSString *value = [[NSString alloc] initWithData:frame.chunks encoding:NSUTF8StringEncoding];
+            if (!value) {
+                return NO;
+            }
+            return [self completeObject:YKFCBORTextString(value)];
+        }
+        
+        case YKFCBORMajorTypeArray:
+            [self.frames removeLastObject];
+            return [self completeObject:YKFCBORArray(frame.elements)];
+        
+        case YKFCBORMajorTypeMap:
+            // A key without value.
+            if (frame.pendingKey) {
+                return NO;
+            }
+            [self.frames removeLastObject];
+            return [self completeObject:YKFCBORMap(frame.pairs)];
+        
+        default:
+            return NO;
+    }
+}
+
+#pragma mark - Items
+
+- (BOOL)completeString {
+    NSMutableData *data = self.stringData;
+    self.stringData = nil;
+    
+    // The chunks of an indefinite-length string are complete when the break code is received.
+    if ([self isIndefiniteStringFrame:self.frames.lastObject]) {
+        return YES;
+    }
+    
+    if ((pendingHead >> YKFCBORMajorTypeShift) == YKFCBORMajorTypeByteString) {
+        return [self completeObject:YKFCBORByteString(data)];
+    }
+    
+    NSString *value = YKFCBORInternedTextString(data.bytes, data.length);
+    if (!value) {
+        value = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    }
+    if (!value) {
+        return NO;
+    }
+    return [self completeObject:YKFCBORTextString(value)];
+}
+
+/*
+ Adds the completed item to the enclosing container. Completing the last item of a container completes the
+ container, so this walks up the stack until a container still expects items.
+ */
+- (BOOL)completeObject:(id)object {
+    while (YES) {
+        YKFCBORStreamFrame *frame = self.frames.lastObject;
+        if (!frame) {
+            if (stopsAfterObject) {
+                decodedObject = object;
+            }
+            [self.delegate streamDecoder:self didDecodeObject:object];
+            return YES;
+        }
+        
+        switch (frame.majorType) {
+            case YKFCBORMajorTypeArray:
+                [frame.elements addObject:object];
+                [self notifyNestedObject:object];
+                break;
+            
+            case YKFCBORMajorTypeMap:
+                if (!frame.pendingKey) {
+                    // The keys are hashed by the dictionary, only the types used as CTAP2 keys are accepted.
+                    if (![object isKindOfClass:YKFCBORInteger.class] && ![object isKindOfClass:YKFCBORTextString.class] && ![object isKindOfClass:YKFCBORByteString.class]) {
+                        return NO;
+                    }
+                    frame.pendingKey = object;
+                } else {
+                    // Security check: A map with duplicated keys is invalid.
+                    if (frame.pairs[frame.pendingKey]) {
+                        return NO;
+                    }
+                    frame.pairs[frame.pendingKey] = object;
+                    frame.pendingKey = nil;
+                    [self notifyNestedObject:object];
+                }
+                break;
+            
+            case YKFCBORMajorTypeTag:
+                [self.frames removeLastObject];
+                object = YKFCBORTaggedItem(frame.tag, object);
+                continue;
+            
+            default:
+                // Only strings can be nested in indefinite-length strings and they are not completed here.
+                return NO;
+        }
+        
+        if (frame.indefinite || --frame.remainingCount) {
+            return YES;
+        }
+        
+        [self.frames removeLastObject];
+        object = frame.majorType == YKFCBORMajorTypeArray ? YKFCBORArray(frame.elements) : YKFCBORMap(frame.pairs);
+    }
+}
+
+#pragma mark - Helpers
+
+- (YKFCBORStreamFrame *)pushFrameWithMajorType:(YKFCBORMajorType)majorType {
+    if (self.frames.count >= YKFCBORDecoderMaxNestingDepth) {
+        return nil;
+    }
+    
+    YKFCBORStreamFrame *frame = [[YKFCBORStreamFrame alloc] init];
+    frame.majorType = majorType;
+    if (majorType == YKFCBORMajorTypeArray) {
+        frame.elements = [[NSMutableArray alloc] init];
+    } else if (majorType == YKFCBORMajorTypeMap) {
+        frame.pairs = [[NSMutableDictionary alloc] init];
+    }
+    
+    [self.frames addObject:frame];
+    return frame;
+}
+
+- (BOOL)isIndefiniteStringFrame:(YKFCBORStreamFrame *)frame {
+    return frame.chunks != nil;
+}
+
+- (void)notifyNestedObject:(id)object {
+    if ([self.delegate respondsToSelector:@selector(streamDecoder:didDecodeNestedObject:depth:)]) {
+        [self.delegate streamDecoder:self didDecodeNestedObject:object depth:self.frames.count];
+    }
+}
+
+- (NSUInteger)depthOfCurrentString {
+    // The chunks of an indefinite-length string are reported at the depth of the enclosing string.
+    NSUInteger depth = self.frames.count;
+    return [self isIndefiniteStringFrame:self.frames.lastObject] ? depth - 1 : depth;
+}
+
+@end
@@ -12,6 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+/*
+ The head of a CBOR item stores the major type in the first 3 bits and the additional information in the last 5 bits.
+ */
+typedef NS_ENUM(UInt8, YKFCBORMajorType) {
+    YKFCBORMajorTypePositiveInteger = 0,
+    YKFCBORMajorTypeNegativeInteger = 1,
+    YKFCBORMajorTypeByteString      = 2,
+    YKFCBORMajorTypeTextString      = 3,
+    YKFCBORMajorTypeArray           = 4,
+    YKFCBORMajorTypeMap             = 5,
+    YKFCBORMajorTypeTag             = 6,
+    YKFCBORMajorTypeSimpleValue     = 7
+};
+
+static const UInt8 YKFCBORMajorTypeShift      = 5;
+static const UInt8 YKFCBORAdditionalInfoMask  = 0b00011111;
+
 /*
  Positive Integer Tags - Major type 0
  First 3 bits of the major type are 0 (0b000_00000). No mask is required for major type 0.
@@ -56,3 +73,10 @@ static const UInt8 YKFCBORArrayTagMask = 0b10000000;
  First 3 bits of the major type are 5 (0b101_00000).
  */
 static const UInt8 YKFCBORMapTagMask = 0b10100000;
+
+/*
+ Indefinite Length - Major types 2, 3, 4, 5
+ The additional information 31 starts an indefinite-length item which ends with the break code.
+ */
+static const UInt8 YKFCBORIndefiniteLengthInfo = 31;
+static const UInt8 YKFCBORBreakCode = 0xFF;
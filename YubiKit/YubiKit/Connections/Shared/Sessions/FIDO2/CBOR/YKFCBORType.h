@@ -106,3 +106,58 @@
 + (YKFCBORBool *)cborBoolWithValue:(BOOL)value;
 
 @end
+
+/*
+ YKFCBORSimpleValue
+ */
+
+/// The simple value null (major type 7, value 22).
+static const UInt8 YKFCBORSimpleValueNull = 22;
+/// The simple value undefined (major type 7, value 23).
+static const UInt8 YKFCBORSimpleValueUndefined = 23;
+
+#define YKFCBORSimpleValue(value) [YKFCBORSimpleValue cborSimpleValueWithValue:value]
+#define YKFCBORNull() [YKFCBORSimpleValue cborSimpleValueWithValue:YKFCBORSimpleValueNull]
+
+/*!
+ A simple value (major type 7) other than false and true, which are decoded as YKFCBORBool.
+ */
+@interface YKFCBORSimpleValue: NSObject<NSCopying, YKFCBORTypeProtocol>
+
+@property (nonatomic) UInt8 value;
++ (YKFCBORSimpleValue *)cborSimpleValueWithValue:(UInt8)value;
+
+@end
+
+/*
+ YKFCBORFloat
+ */
+
+#define YKFCBORFloat(value) [YKFCBORFloat cborFloatWithValue:value]
+
+/*!
+ A half, single or double precision floating point number. The value is widened to double when decoded.
+ */
+@interface YKFCBORFloat: NSObject<NSCopying, YKFCBORTypeProtocol>
+
+@property (nonatomic) double value;
++ (YKFCBORFloat *)cborFloatWithValue:(double)value;
+
+@end
+
+/*
+ YKFCBORTaggedItem
+ */
+
+#define YKFCBORTaggedItem(tag, item) [YKFCBORTaggedItem cborTaggedItemWithTag:tag item:item]
+
+/*!
+ An item with a semantic tag (major type 6). The tag is preserved but not interpreted.
+ */
+@interface YKFCBORTaggedItem: NSObject<NSCopying, YKFCBORTypeProtocol>
+
+@property (nonatomic) UInt64 tag;
+@property (nonatomic) id item;
++ (YKFCBORTaggedItem *)cborTaggedItemWithTag:(UInt64)tag item:(id)item;
+
+@end
@@ -250,3 +250,124 @@
 }
 
 @end
+
+#pragma mark - YKFCBORSimpleValue
+
+@implementation YKFCBORSimpleValue
+
++ (YKFCBORSimpleValue *)cborSimpleValueWithValue:(UInt8)value {
+    YKFCBORSimpleValue *simpleValue = [[YKFCBORSimpleValue alloc] init];
+    simpleValue.value = value;
+    return simpleValue;
+}
+
+- (NSUInteger)hash {
+    NSAssert(NO, @"Cannot hash simple values. Simple values should not be used as keys.");
+    return 0;
+}
+
+- (nonnull id)copyWithZone:(nullable NSZone *)zone {
+    return [YKFCBORSimpleValue cborSimpleValueWithValue:self.value];
+}
+
+- (NSComparisonResult)compare:(id)other {
+    NSAssert(NO, @"Cannot compare simple values. Simple values should not be used as keys.");
+    return NSOrderedSame;
+}
+
+- (BOOL)isEqual:(id)object {
+    NSParameterAssert([object isKindOfClass:self.class]);
+    YKFCBORSimpleValue *otherSimpleValue = (YKFCBORSimpleValue *)object;
+    
+    return self.value == otherSimpleValue.value;
+}
+
+- (NSString *)description {
+    NSString *className = NSStringFromClass(self.class);
+    if (self.value == YKFCBORSimpleValueNull) {
+        return [NSString stringWithFormat:@"%@: null", className];
+    }
+    if (self.value == YKFCBORSimpleValueUndefined) {
+        return [NSString stringWithFormat:@"%@: undefined", className];
+    }
+    return [NSString stringWithFormat:@"%@: %d", className, self.value];
+}
+
+@end
+
+#pragma mark - YKFCBORFloat
+
+@implementation YKFCBORFloat
+
++ (YKFCBORFloat *)cborFloatWithValue:(double)value {
+    YKFCBORFloat *cborFloat = [[YKFCBORFloat alloc] init];
+    cborFloat.value = value;
+    return cborFloat;
+}
+
+- (NSUInteger)hash {
+    NSAssert(NO, @"Cannot hash floats. Floats should not be used as keys.");
+    return 0;
+}
+
+- (nonnull id)copyWithZone:(nullable NSZone *)zone {
+    return [YKFCBORFloat cborFloatWithValue:self.value];
+}
+
+- (NSComparisonResult)compare:(id)other {
+    NSAssert(NO, @"Cannot compare floats. Floats should not be used as keys.");
+    return NSOrderedSame;
+}
+
+- (BOOL)isEqual:(id)object {
+    NSParameterAssert([object isKindOfClass:self.class]);
+    YKFCBORFloat *otherFloat = (YKFCBORFloat *)object;
+    
+    return self.value == otherFloat.value;
+}
+
+- (NSString *)description {
+    NSString *className = NSStringFromClass(self.class);
+    return [NSString stringWithFormat:@"%@: %g", className, self.value];
+}
+
+@end
+
+#pragma mark - YKFCBORTaggedItem
+
+@implementation YKFCBORTaggedItem
+
++ (YKFCBORTaggedItem *)cborTaggedItemWithTag:(UInt64)tag item:(id)item {
+    YKFCBORTaggedItem *taggedItem = [[YKFCBORTaggedItem alloc] init];
+    taggedItem.tag = tag;
+    taggedItem.item = item;
+    return taggedItem;
+}
+
+- (NSUInteger)hash {
+    NSAssert(NO, @"Cannot hash tagged items. Tagged items should not be used as keys.");
+    return 0;
+}
+
+- (nonnull id)copyWithZone:(nullable NSZone *)zone {
+    return [YKFCBORTaggedItem cborTaggedItemWithTag:self.tag item:self.item];
+}
+
+- (NSComparisonResult)compare:(id)other {
+    NSAssert(NO, @"Cannot compare tagged items. Tagged items should not be used as keys.");
+    return NSOrderedSame;
+}
+
+- (BOOL)isEqual:(id)object {
+    NSParameterAssert([object isKindOfClass:self.class]);
+    YKFCBORTaggedItem *otherTaggedItem = (YKFCBORTaggedItem *)object;
+    
+    return self.tag == otherTaggedItem.tag && [self.item isEqual:otherTaggedItem.item];
+}
+
+- (NSString *)description {
+    NSString *className = NSStringFromClass(self.class);
+    return [NSString stringWithFormat:@"%@: %llu(%@)", className, self.tag, self.item];
+}
+
+@end
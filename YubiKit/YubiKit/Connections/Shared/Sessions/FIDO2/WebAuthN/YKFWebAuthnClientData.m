@@ -14,6 +14,8 @@
 
 #import "YKFWebAuthnClientData.h"
 #import "YKFNSDataAdditions.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFNSMutableDataAdditions.h"
 #import "YKFAssert.h"
 
 @interface YKFWebAuthnClientData()
@@ -27,9 +29,6 @@
 @implementation YKFWebAuthnClientData
 
 - (NSData *)jsonData {
-    NSString *websafeChallenge = self.challenge.ykf_websafeBase64EncodedString;
-    YKFAssertReturnValue(websafeChallenge, @"Could not websafeBase64 encode the challenge data.", nil);
-    
     NSString *webauthnType = nil;
     switch (self.type) {
         case YKFWebAuthnClientDataTypeCreate:
@@ -40,12 +39,16 @@
     }
     YKFAssertReturnValue(webauthnType, @"Invalid WebAuthN method type.", nil);
     
-    NSDictionary *jsonDictionary = @{@"type": webauthnType,
-                                     @"challenge": websafeChallenge,
-                                     @"origin": self.origin};
-    NSError *error = nil;
-    NSData *result = [NSJSONSerialization dataWithJSONObject:jsonDictionary options:0 error:&error];
-    YKFAssertReturnValue(!error && result, @"Could not serialize the clientDataJson.", nil);
+    // The JSON is written in one pass, in the member order of the WebAuthn client data serialization.
+    NSUInteger capacity = 64 + YKFBase64URLEncodedLength(self.challenge.length) + self.origin.length * 3;
+    NSMutableData *result = [[NSMutableData alloc] initWithCapacity:capacity];
+    [result ykf_appendUTF8String:@"{\"type\":"];
+    [result ykf_appendJSONString:webauthnType];
+    [result ykf_appendUTF8String:@",\"challenge\":\""];
+    [result ykf_appendWebsafeBase64EncodedData:self.challenge];
+    [result ykf_appendUTF8String:@"\",\"origin\":"];
+    [result ykf_appendJSONString:self.origin];
+    [result ykf_appendUTF8String:@"}"];
     
     return result;
 }
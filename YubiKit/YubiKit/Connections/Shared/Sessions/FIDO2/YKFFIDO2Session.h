@@ -15,6 +15,8 @@
 #import <Foundation/Foundation.h>
 #import "YKFSession.h"
 
+@class YKFTouchPollingSchedule;
+
 @class YKFFIDO2MakeCredentialRequest, YKFFIDO2GetAssertionRequest, YKFFIDO2VerifyPinRequest, YKFFIDO2SetPinRequest, YKFFIDO2ChangePinRequest, YKFFIDO2GetInfoResponse, YKFFIDO2MakeCredentialResponse, YKFFIDO2GetAssertionResponse, YKFFIDO2PublicKeyCredentialRpEntity, YKFFIDO2PublicKeyCredentialUserEntity;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -161,7 +163,8 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2SessionKeyState) {
     This delegate protocol provides the contextual state of the key when performing FIDO2 requests.
  
  @discussion
-    This delegate will be called with the new key state when the status of the Yubikey changes.
+    This delegate will be called with the new key state when the status of the Yubikey changes. The delegate is
+    called on the communication queue of the connection, not on the main thread.
  */
 @protocol YKFFIDO2SessionKeyStateDelegate
 
@@ -208,6 +211,16 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2SessionKeyState) {
  */
 @property (nonatomic, assign, readonly) YKFFIDO2SessionKeyState keyState;
 
+/*!
+ @abstract
+    The intervals at which the session checks the key while waiting for the user to touch it.
+ 
+ @discussion
+    Defaults to [YKFTouchPollingSchedule defaultSchedule]. The checks are scheduled on the communication queue of
+    the connection and do not block it between two checks. Cancelling the commands of the connection stops the wait.
+ */
+@property (nonatomic, copy) YKFTouchPollingSchedule *touchPollingSchedule;
+
 /*!
  @method getInfoWithCompletion:
  
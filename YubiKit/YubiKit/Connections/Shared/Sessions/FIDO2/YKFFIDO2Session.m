@@ -48,9 +48,8 @@
 
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFTouchPollingSchedule.h"
 
-static const int YKFFIDO2RequestMaxRetries = 30; // times
-static const NSTimeInterval YKFFIDO2RequestRetryTimeInterval = 0.5; // seconds
 NSString* const YKFFIDO2OptionRK = @"rk";
 NSString* const YKFFIDO2OptionUV = @"uv";
 NSString* const YKFFIDO2OptionUP = @"up";
@@ -76,6 +75,8 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
 @property NSData *pinToken;
 // Keeps the state of the application selection to avoid reselecting the application.
 @property BOOL applicationSelected;
+// The system uptime when the key asked for the touch in the current request.
+@property (nonatomic, assign) NSTimeInterval touchPollingStartTime;
 
 @end
 
@@ -87,6 +88,7 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
                                completion:(YKFFIDO2SessionCompletion _Nonnull)completion {
     
     YKFFIDO2Session *session = [YKFFIDO2Session new];
+    session.touchPollingSchedule = [YKFTouchPollingSchedule defaultSchedule];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
 
     YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameFIDO2];
@@ -589,7 +591,13 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
     YKFParameterAssertReturn(apdu);
     YKFParameterAssertReturn(completion);
     
-    if (retryCount >= YKFFIDO2RequestMaxRetries) {
+    YKFTouchPollingSchedule *schedule = self.touchPollingSchedule ?: [YKFTouchPollingSchedule defaultSchedule];
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    if (retryCount == 0) {
+        self.touchPollingStartTime = now;
+    }
+    
+    if (now - self.touchPollingStartTime >= schedule.timeout) {
         YKFSessionError *timeoutError = [YKFSessionError errorWithCode:YKFSessionErrorTouchTimeoutCode];
         completion(nil, timeoutError);
 
@@ -598,15 +606,17 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
     }
     
     [self updateKeyState:YKFFIDO2SessionKeyStateTouchKey];
+    NSTimeInterval interval = [schedule intervalForPollCount:retryCount];
     retryCount += 1;
 
+    // The check is scheduled on the communication queue, which stays free for other commands until then.
     ykf_weak_self();
-    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, YKFFIDO2RequestRetryTimeInterval * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
+    [self.smartCardInterface dispatchAfterCurrentCommands:^{
         ykf_safe_strong_self();
 
         YKFAPDU* apdu = [[YKFFIDO2TouchPoolingAPDU alloc] init];
         [strongSelf executeFIDO2Command:apdu retryCount:retryCount completion:completion];
-    });
+    } delay:interval];
 }
 
 @end
@@ -23,6 +23,7 @@
 #import "YKFFeature.h"
 #import "NSArray+YKFTLVRecord.h"
 #import "YKFTLVRecord.h"
+#import "YKFTLVCursor.h"
 
 NSString* const YKFManagementErrorDomain = @"com.yubico.management";
 
@@ -50,6 +51,9 @@ NSString* const YKFManagementErrorDomain = @"com.yubico.management";
             completion(nil, error);
         } else {
             session.version = [session versionFromResponse:data];
+            if (session.version) {
+                [session.smartCardInterface configureWithVersion:session.version];
+            }
             completion(session, nil);
         }
     }];
@@ -88,9 +92,23 @@ typedef void (^YKFManagementSessionReadPagedDeviceInfoBlock)
             completion(result, nil);
             return;
         }
-        NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:[data subdataWithRange:NSMakeRange(1, data.length -  1)]];
-        [result addObjectsFromArray:records];
-        if ([records ykfTLVRecordWithTag:0x10] != nil) {
+        // Walk the page in place, skipping the length byte. The record values are slices of the response.
+        NSData *pageData = [data copy];
+        YKFTLVCursor cursor = YKFTLVCursorMake(pageData);
+        cursor.offset = 1;
+        NSUInteger pageStart = result.count;
+        BOOL hasMorePages = NO;
+        YKFTLVView view;
+        while (YKFTLVCursorNext(&cursor, &view)) {
+            [result addObject:[[YKFTLVRecord alloc] initWithTag:view.tag value:YKFTLVCursorValue(&cursor, &view)]];
+            hasMorePages = hasMorePages || view.tag == 0x10;
+        }
+        if (!YKFTLVCursorIsAtEnd(&cursor)) {
+            // A malformed page does not contribute any record.
+            [result removeObjectsInRange:NSMakeRange(pageStart, result.count - pageStart)];
+            hasMorePages = NO;
+        }
+        if (hasMorePages) {
             [self readPagedDeviceInfoWithCompletion:completion result:result page:page + 1];
             return;
         } else {
@@ -96,6 +96,9 @@ typedef void (^YKFOATHServiceResultCompletionBlock)(NSData* _Nullable  result, N
             completion(nil, error);
         } else {
             session.cachedSelectApplicationResponse = [[YKFOATHSelectApplicationResponse alloc] initWithResponseData:data];
+            if (session.cachedSelectApplicationResponse.version) {
+                [session.smartCardInterface configureWithVersion:session.cachedSelectApplicationResponse.version];
+            }
             completion(session, nil);
         }
     }];
@@ -207,6 +210,7 @@ static const UInt8 YKFOATHRenameAPDUNameTag = 0x71;
     YKFParameterAssertReturn(completion);
     
     YKFAPDU *apdu = [[YKFOATHCalculateAllAPDU alloc] initWithTimestamp:timestamp];
+    apdu.mayReturnLongResponse = YES;
     
     [self executeOATHCommand:apdu completion:^(NSData * _Nullable result, NSError * _Nullable error) {
         if (error) {
@@ -228,6 +232,7 @@ static const UInt8 YKFOATHRenameAPDUNameTag = 0x71;
 - (void)listCredentialsWithCompletion:(YKFOATHSessionListCompletionBlock)completion {
     YKFParameterAssertReturn(completion);
     YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xA1 p1:0x00 p2:0x00 data:[NSData data] type:YKFAPDUTypeShort];
+    apdu.mayReturnLongResponse = YES;
     
     [self executeOATHCommand:apdu completion:^(NSData * _Nullable result, NSError * _Nullable error) {
         if (error) {
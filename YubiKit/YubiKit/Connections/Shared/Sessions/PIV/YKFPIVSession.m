@@ -38,6 +38,9 @@
 #import "YKFPIVPadding+Private.h"
 #import "TKTLVRecordAdditions+Private.h"
 #import "YKFTLVRecord.h"
+#import "YKFTLVCursor.h"
+#import "YKFTLVWriter.h"
+#import "YKFByteSpan.h"
 #import "NSData+GZIP.h"
 
 NSString* const YKFPIVErrorDomain = @"com.yubico.piv";
@@ -151,6 +154,7 @@ int maxPinAttempts = 3;
                     }
                     UInt8 *versionBytes = (UInt8 *)data.bytes;
                     session.version = [[YKFVersion alloc] initWithBytes:versionBytes[0] minor:versionBytes[1] micro:versionBytes[2]];
+                    [session.smartCardInterface configureWithVersion:session.version];
                     completion(session, nil);
                 }
             }];
@@ -209,11 +213,12 @@ int maxPinAttempts = 3;
 }
 
 - (void)usePrivateKeyInSlot:(YKFPIVSlot)slot type:(YKFPIVKeyType)type message:(NSData *)message exponentiation:(BOOL)exponentiation completion:(YKFPIVSessionDataCompletionBlock)completion {
-    NSMutableData *recordsData = [NSMutableData data];
-    [recordsData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagAuthResponse value:[NSData data]].data];
-    [recordsData appendData:[[YKFTLVRecord alloc] initWithTag:exponentiation ? YKFPIVTagExponentiation : YKFPIVTagChallenge value:message].data];
-    NSData *data = [[YKFTLVRecord alloc] initWithTag:YKFPIVTagDynAuth value:recordsData].data;
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsAuthenticate p1:type p2:slot data:data type:YKFAPDUTypeExtended];
+    YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:message.length + 16];
+    [writer beginConstructedWithTag:YKFPIVTagDynAuth];
+    [writer appendTag:YKFPIVTagAuthResponse bytes:NULL length:0];
+    [writer appendTag:exponentiation ? YKFPIVTagExponentiation : YKFPIVTagChallenge value:message];
+    [writer endConstructed];
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsAuthenticate p1:type p2:slot data:writer.data type:YKFAPDUTypeExtended];
     [self.smartCardInterface executeCommand:apdu timeout:120.0  completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -481,25 +486,33 @@ int maxPinAttempts = 3;
 }
 
 - (void)putCertificate:(SecCertificateRef)certificate inSlot:(YKFPIVSlot)slot compress:(bool)compress completion:(YKFPIVSessionGenericCompletionBlock)completion {
-    NSMutableData *mutableData = [NSMutableData data];
     NSData *certData = (__bridge NSData *)SecCertificateCopyData(certificate);
     if (compress) {
         certData = [certData gzippedData];
     }
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagCertificate value:certData].data];
+    NSData *objectId = [self objectIdForSlot:slot];
+    
+    // The certificate is written once, directly into the PUT DATA payload.
+    YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:certData.length + objectId.length + 32];
+    [writer appendTag:YKFPIVTagObjectId value:objectId];
+    [writer beginConstructedWithTag:YKFPIVTagObjectData];
+    [writer appendTag:YKFPIVTagCertificate value:certData];
     UInt8 isCompressed = compress ? 1 : 0;
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagCertificateInfo value:[NSData dataWithBytes:&isCompressed length:1]].data];
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagLRC value:[NSData data]].data];
-    [self putObject:mutableData objectId:[self objectIdForSlot:slot] completion:^(NSError * _Nullable error) {
-        completion(error);
-    }];
+    [writer appendTag:YKFPIVTagCertificateInfo bytes:&isCompressed length:1];
+    [writer appendTag:YKFPIVTagLRC bytes:NULL length:0];
+    [writer endConstructed];
+    [self putObjectData:writer.data completion:completion];
 }
 
 - (void)putObject:(NSData *)object objectId:(NSData *)objectId completion:(YKFPIVSessionGenericCompletionBlock)completion  {
-    NSMutableData *mutableData = [NSMutableData data];
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagObjectId value:objectId].data];
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagObjectData value:object].data];
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsPutData p1:0x3f p2:0xff data:mutableData type:YKFAPDUTypeExtended];
+    YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:object.length + objectId.length + 16];
+    [writer appendTag:YKFPIVTagObjectId value:objectId];
+    [writer appendTag:YKFPIVTagObjectData value:object];
+    [self putObjectData:writer.data completion:completion];
+}
+
+- (void)putObjectData:(NSData *)data completion:(YKFPIVSessionGenericCompletionBlock)completion  {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsPutData p1:0x3f p2:0xff data:data type:YKFAPDUTypeExtended];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         completion(error);
     }];
@@ -513,13 +526,21 @@ int maxPinAttempts = 3;
         if (error != nil) {
             completion(nil, error);
         } else {
-            NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
-            NSData *objectData = [records ykfTLVRecordWithTag:YKFPIVTagObjectData].value;
-            NSArray<YKFTLVRecord*> *subRecords = [YKFTLVRecord sequenceOfRecordsFromData:objectData];
+            // Walk the response in place and descend into the object data without copying the certificate.
+            NSData *certificateData = nil;
+            NSData *certificateInfo = nil;
+            YKFTLVCursor cursor = YKFTLVCursorMake(data);
+            YKFTLVView objectData;
+            if (YKFTLVCursorReadTags(&cursor, (YKFTLVTag[]){YKFPIVTagObjectData}, 1, &objectData)) {
+                YKFTLVCursor objectCursor = YKFTLVCursorMakeWithValue(&cursor, &objectData);
+                YKFTLVTag objectTags[] = {YKFPIVTagCertificate, YKFPIVTagCertificateInfo};
+                YKFTLVView objectViews[2];
+                if (YKFTLVCursorReadTags(&objectCursor, objectTags, 2, objectViews)) {
+                    certificateData = YKFTLVCursorValue(&objectCursor, &objectViews[0]);
+                    certificateInfo = YKFTLVCursorValue(&objectCursor, &objectViews[1]);
+                }
+            }
             
-            NSData *certificateData = [subRecords ykfTLVRecordWithTag:YKFPIVTagCertificate].value;
-            NSData *certificateInfo = [subRecords ykfTLVRecordWithTag:YKFPIVTagCertificateInfo].value;
-
             if (certificateInfo && certificateInfo.length > 0 && ((UInt8 *)(certificateInfo.bytes))[0] == 1 && [certificateData isGzippedData]) {
                 certificateData = [certificateData gunzippedData];
             }
@@ -659,7 +680,7 @@ int maxPinAttempts = 3;
                 completion(-1, [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeInvalidResponse userInfo:@{NSLocalizedDescriptionKey: @"Invalid response when reading serial number."}]);
                 return;
             }
-            UInt32 serialNumber = CFSwapInt32BigToHost(*(UInt32*)([data bytes]));
+            UInt32 serialNumber = YKFLoadBigEndianUInt32(data.bytes);
             completion(serialNumber, nil);
         } else {
             completion(-1, error);
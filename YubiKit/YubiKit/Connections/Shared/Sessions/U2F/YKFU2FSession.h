@@ -15,6 +15,8 @@
 #import <Foundation/Foundation.h>
 #import "YKFSession.h"
 
+@class YKFTouchPollingSchedule;
+
 @class YKFU2FSignRequest, YKFU2FSignResponse, YKFU2FRegisterRequest, YKFU2FRegisterResponse;
 /**
  * ---------------------------------------------------------------------------------------------------------------------
@@ -108,6 +110,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, assign, readonly) YKFU2FSessionKeyState keyState;
 
+/*!
+ @abstract
+    The intervals at which the session checks the key while waiting for the user to touch it.
+ 
+ @discussion
+    Defaults to [YKFTouchPollingSchedule defaultSchedule]. The checks are scheduled on the communication queue of
+    the connection and do not block it between two checks. Cancelling the commands of the connection stops the wait.
+ */
+@property (nonatomic, copy) YKFTouchPollingSchedule *touchPollingSchedule;
+
 /*!
  @method registerWithChallenge:appId:completion:
  
@@ -34,18 +34,19 @@
 
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFTouchPollingSchedule.h"
 
 typedef void (^YKFU2FServiceResultCompletionBlock)(NSData* _Nullable  result, NSError* _Nullable error);
 
 NSString* const YKFU2FServiceProtocolKeyStatePropertyKey = @"keyState";
 
-static const int YKFU2FMaxRetries = 30; // times
-static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
-
 @interface YKFU2FSession()
 
 @property (nonatomic, assign, readwrite) YKFU2FSessionKeyState keyState;
 
+// The system uptime when the key asked for the touch in the current request.
+@property (nonatomic, assign) NSTimeInterval touchPollingStartTime;
+
 @end
 
 @implementation YKFU2FSession
@@ -53,6 +54,7 @@ static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
 + (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
                                completion:(YKFU2FSessionCompletion _Nonnull)completion {
     YKFU2FSession *session = [YKFU2FSession new];
+    session.touchPollingSchedule = [YKFTouchPollingSchedule defaultSchedule];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
     YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameU2F];
@@ -164,7 +166,13 @@ static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
 - (void)handleTouchRequired:(YKFAPDU *)apdu retryCount:(int)retryCount completion:(YKFU2FServiceResultCompletionBlock)completion {
     YKFParameterAssertReturn(completion);
     
-    if (retryCount >= YKFU2FMaxRetries) {
+    YKFTouchPollingSchedule *schedule = self.touchPollingSchedule ?: [YKFTouchPollingSchedule defaultSchedule];
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    if (retryCount == 0) {
+        self.touchPollingStartTime = now;
+    }
+    
+    if (now - self.touchPollingStartTime >= schedule.timeout) {
         YKFSessionError *timeoutError = [YKFSessionError errorWithCode:YKFSessionErrorTouchTimeoutCode];
         completion(nil, timeoutError);
         
@@ -172,14 +180,16 @@ static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
         return;
     }
     
-    [self updateKeyState:YKFU2FSessionKeyStateTouchKey];    
+    [self updateKeyState:YKFU2FSessionKeyStateTouchKey];
+    NSTimeInterval interval = [schedule intervalForPollCount:retryCount];
     retryCount += 1;
     
+    // The check is scheduled on the communication queue, which stays free for other commands until then.
     ykf_weak_self();
-    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, YKFU2FRetryTimeInterval * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
+    [self.smartCardInterface dispatchAfterCurrentCommands:^{
         ykf_safe_strong_self();
         [strongSelf executeU2FCommand:apdu retryCount:retryCount completion:completion];
-    });
+    } delay:interval];
 }
 
 #pragma mark - Key responses
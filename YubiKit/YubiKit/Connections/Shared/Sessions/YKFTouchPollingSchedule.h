@@ -0,0 +1,71 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFTouchPollingSchedule
+ 
+ @abstract
+    The intervals at which the FIDO2 and U2F sessions check the key while they wait for the user to touch it.
+ 
+ @discussion
+    The key is checked every initialInterval during the first fastPollingDuration seconds, when the user is most likely
+    to touch it. After that the interval grows by backoffFactor with every check, up to maximumInterval. The request
+    fails with YKFSessionErrorTouchTimeoutCode when the key was not touched after timeout seconds.
+    
+    The checks are scheduled on the communication queue of the connection and are cancelled by cancelCommands.
+ */
+@interface YKFTouchPollingSchedule: NSObject<NSCopying>
+
+/*!
+ The interval between the checks at the beginning of the wait. 0.1 seconds by default.
+ */
+@property (nonatomic, assign) NSTimeInterval initialInterval;
+
+/*!
+ How long the key is checked every initialInterval. 1 second by default.
+ */
+@property (nonatomic, assign) NSTimeInterval fastPollingDuration;
+
+/*!
+ The factor applied to the interval after every check past the fastPollingDuration. 1.5 by default.
+ */
+@property (nonatomic, assign) double backoffFactor;
+
+/*!
+ The longest interval between two checks. 0.5 seconds by default.
+ */
+@property (nonatomic, assign) NSTimeInterval maximumInterval;
+
+/*!
+ How long to wait for the touch before failing the request. 15 seconds by default.
+ */
+@property (nonatomic, assign) NSTimeInterval timeout;
+
+/*!
+ Returns a new schedule with the default values.
+ */
++ (instancetype)defaultSchedule;
+
+/*!
+ Returns the interval before the check with the index pollCount (starting at 0).
+ */
+- (NSTimeInterval)intervalForPollCount:(NSUInteger)pollCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
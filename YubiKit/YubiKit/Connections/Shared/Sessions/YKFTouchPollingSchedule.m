@@ -0,0 +1,63 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFTouchPollingSchedule.h"
+
+static NSTimeInterval const YKFTouchPollingScheduleDefaultInitialInterval = 0.1; // seconds
+static NSTimeInterval const YKFTouchPollingScheduleDefaultFastPollingDuration = 1; // seconds
+static double const YKFTouchPollingScheduleDefaultBackoffFactor = 1.5;
+static NSTimeInterval const YKFTouchPollingScheduleDefaultMaximumInterval = 0.5; // seconds
+static NSTimeInterval const YKFTouchPollingScheduleDefaultTimeout = 15; // seconds
+
+@implementation YKFTouchPollingSchedule
+
++ (instancetype)defaultSchedule {
+    return [[self alloc] init];
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.initialInterval = YKFTouchPollingScheduleDefaultInitialInterval;
+        self.fastPollingDuration = YKFTouchPollingScheduleDefaultFastPollingDuration;
+        self.backoffFactor = YKFTouchPollingScheduleDefaultBackoffFactor;
+        self.maximumInterval = YKFTouchPollingScheduleDefaultMaximumInterval;
+        self.timeout = YKFTouchPollingScheduleDefaultTimeout;
+    }
+    return self;
+}
+
+- (NSTimeInterval)intervalForPollCount:(NSUInteger)pollCount {
+    NSTimeInterval initialInterval = MAX(self.initialInterval, 0);
+    NSUInteger fastPollCount = initialInterval > 0 ? (NSUInteger)ceil(self.fastPollingDuration / initialInterval) : 0;
+    if (pollCount < fastPollCount) {
+        return MIN(initialInterval, self.maximumInterval);
+    }
+    NSTimeInterval interval = initialInterval * pow(MAX(self.backoffFactor, 1), pollCount - fastPollCount + 1);
+    return MIN(interval, self.maximumInterval);
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone {
+    YKFTouchPollingSchedule *schedule = [[YKFTouchPollingSchedule allocWithZone:zone] init];
+    schedule.initialInterval = self.initialInterval;
+    schedule.fastPollingDuration = self.fastPollingDuration;
+    schedule.backoffFactor = self.backoffFactor;
+    schedule.maximumInterval = self.maximumInterval;
+    schedule.timeout = self.timeout;
+    return schedule;
+}
+
+@end
@@ -19,17 +19,52 @@ NS_ASSUME_NONNULL_BEGIN
 typedef void (^YKFConnectionControllerCommandResponseBlock)(NSData* _Nullable, NSError* _Nullable, NSTimeInterval);
 typedef void (^YKFConnectionControllerCompletionBlock)(void);
 typedef void (^YKFConnectionControllerCommunicationQueueBlock)(NSOperation *operation);
+typedef void (^YKFConnectionControllerBatchResponseBlock)(NSArray<NSData *> *, NSError* _Nullable, NSTimeInterval);
 
 @protocol YKFConnectionControllerProtocol
 
 - (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion;
 - (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion;
 
+/*!
+ Executes the commands in order, in a single operation on the communication queue. The execution stops after the first
+ command which fails or which returns a status other than 0x9000 (e.g. 61XX when the key has more data to send).
+ 
+ The completion receives the responses (data and status) of the executed commands, the error of the command which failed
+ if any, and the total execution time. The timeout applies to each command. The completion is not called when the
+ commands are cancelled.
+ */
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands completion:(YKFConnectionControllerBatchResponseBlock)completion;
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerBatchResponseBlock)completion;
+
 - (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block;
 
+/*!
+ Dispatches the block on the communication queue after the delay, without blocking the queue in the meantime.
+ The delayed blocks which did not start yet are cancelled by cancelAllCommands.
+ */
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block delay:(NSTimeInterval)delay;
+
 - (void)closeConnectionWithCompletion:(YKFConnectionControllerCompletionBlock)completion;
 - (void)cancelAllCommands;
 
+/*!
+ When YES, YKFSmartCardInterface sends the commands which have more data than commandChainingBlockSize as a chain
+ of short APDUs (ISO 7816-4 command chaining) instead of a single extended APDU. NO by default.
+ */
+@property (nonatomic, assign) BOOL commandChainingEnabled;
+
+/*!
+ The maximum data length of a block when a command is chained, tuned for the transport (at most 255 bytes).
+ */
+@property (nonatomic, readonly) NSUInteger commandChainingBlockSize;
+
+/*!
+ YES if the transport can exchange extended APDUs, which allows YKFSmartCardInterface to ask for long responses in one
+ exchange instead of reading them with GET RESPONSE commands.
+ */
+@property (nonatomic, readonly) BOOL supportsExtendedLength;
+
 @end
 
 NS_ASSUME_NONNULL_END
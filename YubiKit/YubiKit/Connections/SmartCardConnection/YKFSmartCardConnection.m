@@ -37,6 +37,8 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
 
 @implementation YKFSmartCardConnection
 
+@synthesize commandChainingEnabled = _commandChainingEnabled;
+
 - (nullable instancetype)initWithDelegate:(nonnull id<YKFSmartCardConnectionDelegate>)delegate {
     self = [super init];
     if (self) {
@@ -50,6 +52,11 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
     return self.connectionController != nil ? YKFSmartCardConnectionStateOpen : YKFSmartCardConnectionStateClosed;
 }
 
+- (void)setCommandChainingEnabled:(BOOL)commandChainingEnabled {
+    _commandChainingEnabled = commandChainingEnabled;
+    self.connectionController.commandChainingEnabled = commandChainingEnabled;
+}
+
 - (void)updateConnections API_AVAILABLE(ios(16.0)) {
     // creating the smart card has to be done on the main thread and after a slight delay
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 0.1 * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
@@ -63,6 +70,7 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
             }
             [YKFSmartCardConnectionController smartCardControllerWithSmartCard:smartCard completion:^(YKFSmartCardConnectionController * controller, NSError * error) {
                 if (controller != nil) {
+                    controller.commandChainingEnabled = self.commandChainingEnabled;
                     self.connectionController = controller;
                     [self.delegate didConnectSmartCard:self];
                 } else {
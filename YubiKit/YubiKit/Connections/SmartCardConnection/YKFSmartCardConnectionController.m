@@ -17,21 +17,31 @@
 #import "YKFSmartCardConnectionController.h"
 #import "YKFAPDU+Private.h"
 #import "YKFBlockMacros.h"
+#import "YKFDispatch.h"
 #import "YKFSessionError.h"
 #import "YKFSessionError+Private.h"
 #import "YKFAssert.h"
+#import "YKFAPDUError.h"
+#import "YKFNSDataAdditions+Private.h"
 
 static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
 
+// CCID readers exchange short APDUs in a single transfer, so the blocks are as large as a short APDU allows.
+static NSUInteger const YKFSmartCardConnectionCommandChainingBlockSize = 255; // bytes
+static NSUInteger const YKFSmartCardConnectionShortResponseLength = 258; // bytes
+
 @interface YKFSmartCardConnectionController()
 
 @property (nonatomic, readwrite) TKSmartCard *smartCard;
 @property (nonatomic) NSOperationQueue *communicationQueue;
+@property (nonatomic) NSMutableDictionary *delayedDispatches;
 
 @end
 
 @implementation YKFSmartCardConnectionController
 
+@synthesize commandChainingEnabled;
+
 - (instancetype)init {
     self = [super init];
     if (self) {
@@ -40,6 +50,7 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
         dispatch_queue_attr_t dispatchQueueAttributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, DISPATCH_QUEUE_PRIORITY_HIGH, -1);
         dispatch_queue_t dispatchQueue = dispatch_queue_create("com.yubico.SmartCard", dispatchQueueAttributes);
         self.communicationQueue.underlyingQueue = dispatchQueue;
+        self.delayedDispatches = [[NSMutableDictionary alloc] init];
     }
     return self;
 }
@@ -60,6 +71,15 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
     }];
 }
 
+- (NSUInteger)commandChainingBlockSize {
+    return YKFSmartCardConnectionCommandChainingBlockSize;
+}
+
+- (BOOL)supportsExtendedLength {
+    // The slot reports the longest response the reader can transfer, a short response has at most 256 + 2 bytes.
+    return self.smartCard.slot.maxOutputLength > YKFSmartCardConnectionShortResponseLength;
+}
+
 - (void)endSession {
     [self.smartCard endSession];
 }
@@ -68,6 +88,7 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
     self.communicationQueue.suspended = YES;
     dispatch_suspend(self.communicationQueue.underlyingQueue);
     [self.communicationQueue cancelAllOperations];
+    ykf_dispatch_cancel_delayed_blocks(self.delayedDispatches);
     dispatch_resume(self.communicationQueue.underlyingQueue);
     self.communicationQueue.suspended = NO;
 }
@@ -93,6 +114,21 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
     [self.communicationQueue addOperation:operation];;
 }
 
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block delay:(NSTimeInterval)delay {
+    YKFParameterAssertReturn(block);
+    
+    if (delay <= 0) {
+        [self dispatchBlockOnCommunicationQueue:block];
+        return;
+    }
+    
+    ykf_weak_self();
+    ykf_dispatch_after_cancellable(delay, self.communicationQueue, self.delayedDispatches, ^{
+        ykf_safe_strong_self();
+        [strongSelf dispatchBlockOnCommunicationQueue:block];
+    });
+}
+
 - (void)execute:(nonnull YKFAPDU *)command completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
     [self execute:command timeout:YKFSmartCardConnectionDefaultTimeout completion:completion];
 }
@@ -102,52 +138,105 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
     ykf_weak_self();
     [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
         ykf_safe_strong_self();
+        uint64_t commandStartTime = ykf_monotonic_time();
+        
+        NSError *executionError = nil;
+        NSData *executionResult = [strongSelf transmitCommand:command timeout:timeout operation:operation error:&executionError];
         
-        // Do not wait for the command to process if the operation was canceled.
+        // Do not notify if the operation was canceled.
         if (operation.isCancelled) {
             return;
         }
         
-        // Verify that the smart card is still valid
-        if (!strongSelf.smartCard.valid) {
-            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost], 0);
-            return;
-        }
+        NSTimeInterval executionTime = ykf_elapsed_time_since(commandStartTime);
+        completion(executionResult, executionError, executionTime);
+    }];
+}
+
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    [self executeBatch:commands timeout:YKFSmartCardConnectionDefaultTimeout completion:completion];
+}
+
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    YKFParameterAssertReturn(commands);
+    YKFParameterAssertReturn(completion);
+    
+    ykf_weak_self();
+    [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+        ykf_safe_strong_self();
+        uint64_t batchStartTime = ykf_monotonic_time();
+        NSMutableArray<NSData *> *responses = [[NSMutableArray alloc] initWithCapacity:commands.count];
+        NSError *executionError = nil;
         
-        __block NSError *executionError = nil;
-        __block NSData *executionResult = nil;
-        NSDate *commandStartDate = [NSDate date];
-        dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
-
-        [strongSelf.smartCard transmitRequest:[command apduData] reply:^(NSData * _Nullable response, NSError * _Nullable error) {
-            if (error) {
-                executionError = error;
-                dispatch_semaphore_signal(executionSemaphore);
+        for (YKFAPDU *command in commands) {
+            NSData *executionResult = [strongSelf transmitCommand:command timeout:timeout operation:operation error:&executionError];
+            if (operation.isCancelled) {
                 return;
             }
-            
-            executionResult = [response copy];
-            dispatch_semaphore_signal(executionSemaphore);
-        }];
-        
-        // Lock the async call to enforce the sequential execution using the library dispatch queue.
-        if(dispatch_semaphore_wait(executionSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0) {
-            executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
+            if (!executionResult) {
+                break;
+            }
+            [responses addObject:executionResult];
+            if (![executionResult ykf_isSuccessfulAPDUResponse]) {
+                break;
+            }
         }
         
-        // Do not notify if the operation was canceled.
-        if (operation.isCancelled) {
+        NSTimeInterval executionTime = ykf_elapsed_time_since(batchStartTime);
+        completion(responses, executionError, executionTime);
+    }];
+}
+
+/*
+ Sends the command to the smart card and waits for the response on the communication queue. Returns the data and
+ status of the response, or nil when the command failed or was cancelled. The error is not set when the command was
+ cancelled.
+ */
+- (NSData *)transmitCommand:(YKFAPDU *)command timeout:(NSTimeInterval)timeout operation:(NSOperation *)operation error:(NSError **)error {
+    // Do not wait for the command to process if the operation was canceled.
+    if (operation.isCancelled) {
+        return nil;
+    }
+    
+    // Verify that the smart card is still valid
+    if (!self.smartCard.valid) {
+        if (error) {
+            *error = [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost];
+        }
+        return nil;
+    }
+    
+    __block NSError *executionError = nil;
+    __block NSData *executionResult = nil;
+    dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
+
+    [self.smartCard transmitRequest:[command apduData] reply:^(NSData * _Nullable response, NSError * _Nullable error) {
+        if (error) {
+            executionError = error;
+            dispatch_semaphore_signal(executionSemaphore);
             return;
         }
         
-        NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-        if (executionError) {
-            completion(nil, executionError, executionTime);
-        } else {
-            YKFAssertReturn(executionResult, @"The command did not return any response data when error was not nil.");
-            completion(executionResult, nil, executionTime);
-        }
+        executionResult = [response copy];
+        dispatch_semaphore_signal(executionSemaphore);
     }];
+    
+    // Lock the async call to enforce the sequential execution using the library dispatch queue.
+    if(dispatch_semaphore_wait(executionSemaphore, ykf_dispatch_deadline(timeout)) != 0) {
+        executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
+    }
+    
+    if (operation.isCancelled) {
+        return nil;
+    }
+    if (executionError) {
+        if (error) {
+            *error = executionError;
+        }
+        return nil;
+    }
+    YKFAssertReturnValue(executionResult, @"The command did not return any response data when error was not nil.", nil);
+    return executionResult;
 }
 
 - (void)dealloc {
@@ -18,7 +18,7 @@
 #ifndef YKFSmartCardInterface_h
 #define YKFSmartCardInterface_h
 
-@class YKFAPDU, YKFSelectApplicationAPDU;
+@class YKFAPDU, YKFSelectApplicationAPDU, YKFVersion;
 @protocol YKFConnectionControllerProtocol;
 
 typedef void (^YKFSmartCardInterfaceResponseBlock)
@@ -43,6 +43,26 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype)initWithConnectionController:(id<YKFConnectionControllerProtocol>)connectionController NS_DESIGNATED_INITIALIZER;
 
+/// @abstract Enables the extended APDUs for the responses if the key and the transport accept them.
+/// @discussion With extended APDUs the commands ask for the whole response in one exchange (extended Le) instead of
+///             reading it in chunks of 256 bytes with GET RESPONSE. YubiKeys accept extended APDUs from firmware 4.0.0.
+///             Only the commands which can return more than 256 bytes are sent as extended APDUs. A command which the
+///             key or the reader rejects as extended is sent again as a short command, and extended APDUs are disabled.
+///             The commands fall back to reading the remaining data in chunks when the key still has more data to send.
+- (void)configureWithVersion:(YKFVersion *)version;
+
+/// @abstract YES when the commands ask for the whole response in one exchange.
+@property (nonatomic, readonly) BOOL usesExtendedLength;
+
+/// @abstract The number of exchanges with the key used to read the response of the last command.
+@property (nonatomic, readonly) NSUInteger lastCommandRoundTrips;
+
+/// @abstract The number of exchanges saved by the last command compared to reading its response in chunks of 256 bytes.
+@property (nonatomic, readonly) NSUInteger lastCommandSavedRoundTrips;
+
+/// @abstract The total number of exchanges saved by the commands executed by the interface.
+@property (nonatomic, readonly) NSUInteger savedRoundTrips;
+
 - (void)selectApplication:(YKFSelectApplicationAPDU *)apdu completion:(YKFSmartCardInterfaceResponseBlock)completion;
 
 - (void)executeCommand:(YKFAPDU *)apdu completion:(YKFSmartCardInterfaceResponseBlock)completion;
@@ -55,6 +75,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)dispatchAfterCurrentCommands:(YKFSmartCardInterfaceCommandBlock)block;
 
+/// @abstract Executes the block on the communication queue after the delay, without holding the queue while waiting.
+/// @discussion The block is not executed if the commands of the connection are cancelled in the meantime.
+- (void)dispatchAfterCurrentCommands:(YKFSmartCardInterfaceCommandBlock)block delay:(NSTimeInterval)delay;
+
 NS_ASSUME_NONNULL_END
 
 @end
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #import <Foundation/Foundation.h>
+#import <CoreNFC/CoreNFC.h>
 #import "YKFSmartCardInterface.h"
 #import "YKFConnectionControllerProtocol.h"
 #import "YKFAssert.h"
@@ -34,14 +35,23 @@
 #import "YKFNSDataAdditions+Private.h"
 #import "YKFOATHSendRemainingAPDU.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFVersion.h"
+#import "YKFResponseBuffer.h"
 
 
 static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
+static UInt8 const YKFSmartCardInterfaceCommandChainingMask = 0x10;
+static NSUInteger const YKFSmartCardInterfaceShortResponseLength = 256;
 
 @interface YKFSmartCardInterface()
 
 @property (nonatomic, readwrite) id<YKFConnectionControllerProtocol> connectionController;
 
+@property (nonatomic, assign) BOOL keySupportsExtendedLength;
+@property (nonatomic, readwrite) NSUInteger lastCommandRoundTrips;
+@property (nonatomic, readwrite) NSUInteger lastCommandSavedRoundTrips;
+@property (nonatomic, readwrite) NSUInteger savedRoundTrips;
+
 - (NSData *)dataFromKeyResponse:(NSData *)response;
 - (UInt16)statusCodeFromKeyResponse:(NSData *)response;
 
@@ -57,6 +67,16 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
     return self;
 }
 
+- (void)configureWithVersion:(YKFVersion *)version {
+    YKFParameterAssertReturn(version);
+    self.keySupportsExtendedLength = version.major >= 4;
+}
+
+- (BOOL)usesExtendedLength {
+    // Connections set to chain commands are used with readers which do not handle extended APDUs well.
+    return self.keySupportsExtendedLength && self.connectionController.supportsExtendedLength && !self.connectionController.commandChainingEnabled;
+}
+
 - (void)selectApplication:(YKFSelectApplicationAPDU *)apdu completion:(YKFSmartCardInterfaceResponseBlock)completion {
     [self executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
@@ -79,41 +99,85 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
     }];
 }
 
-- (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns  timeout:(NSTimeInterval)timeout data:(NSMutableData *)data completion:(YKFSmartCardInterfaceResponseBlock)completion {
-    [self.connectionController execute:apdu
-                         timeout:timeout
-                            completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+/*
+ Reads the response of a command. When the response does not fit in one exchange the key replies 61xx, with the number
+ of remaining bytes in SW2 (00 for 256 or more), and the rest is read with the send remaining command until the key
+ replies 9000.
+ 
+ The exchanges run one after the other on the communication queue: the response block queues the next exchange with
+ itself as completion and returns, so the stack does not grow with the number of parts. The parts are appended to one
+ buffer which is sized from SW2 and handed over to the completion without a copy.
+ 
+ shortApdu is the original command when apdu is its extended rewrite. If the key or the reader rejects the extended
+ command, extended APDUs are disabled and the original command is sent instead. Likewise, a rejected extended send
+ remaining command disables extended APDUs and the remaining data is read with the short form.
+ */
+- (void)readResponseOfCommand:(YKFAPDU *)apdu shortCommand:(YKFAPDU *)shortApdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout completion:(YKFSmartCardInterfaceResponseBlock)completion {
+    __block YKFResponseBuffer *buffer = nil;
+    __block YKFAPDU *sendRemainingApdu = nil;
+    __block BOOL sendRemainingIsExtended = NO;
+    __block NSUInteger roundTrips = 0;
+    
+    // While an exchange is pending the connection controller keeps the response block alive.
+    __block __weak YKFConnectionControllerCommandResponseBlock weakResponseBlock = nil;
+    YKFConnectionControllerCommandResponseBlock responseBlock = ^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        if (shortApdu && !roundTrips && [self isExtendedLengthRejectedWithResponse:response error:error]) {
+            YKFLogInfo(@"Extended APDU rejected. Sending the command with short length...");
+            self.keySupportsExtendedLength = NO;
+            [self readResponseOfCommand:shortApdu shortCommand:nil sendRemainingIns:sendRemainingIns timeout:timeout completion:completion];
+            return;
+        }
+        if (roundTrips && sendRemainingIsExtended && [self isExtendedLengthRejectedWithResponse:response error:error]) {
+            YKFLogInfo(@"Extended send remaining command rejected. Requesting the remaining data with short length...");
+            self.keySupportsExtendedLength = NO;
+            sendRemainingIsExtended = NO;
+            sendRemainingApdu = [self sendRemainingApdu:sendRemainingIns];
+            [self.connectionController execute:sendRemainingApdu timeout:timeout completion:weakResponseBlock];
+            return;
+        }
         if (error) {
             completion(nil, error);
             return;
         }
-
-        [data appendData:[self dataFromKeyResponse:response]];
+        
+        ++roundTrips;
+        NSData *responseData = [self dataFromKeyResponse:response];
         UInt16 statusCode = [self statusCodeFromKeyResponse:response];
         
         if (statusCode >> 8 == YKFAPDUErrorCodeMoreData) {
             YKFLogInfo(@"Key has more data to send. Requesting for remaining data...");
-            UInt16 ins;
-            switch (sendRemainingIns) {
-                case YKFSmartCardInterfaceSendRemainingInsNormal:
-                    ins = 0xC0;
-                    break;
-                case YKFSmartCardInterfaceSendRemainingInsOATH:
-                    ins = 0xA5;
-                    break;
+            // At least the announced length; the buffer grows by half of its capacity if more parts follow.
+            NSUInteger remainingLength = statusCode & 0xFF;
+            if (!remainingLength) {
+                remainingLength = YKFSmartCardInterfaceShortResponseLength;
             }
-            YKFAPDU *sendRemainingApdu = [[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(unsigned char[]){0x00, ins, 0x00, 0x00, 0x00} length:5]];
-            // Queue a new request recursively
-            [self executeCommand:sendRemainingApdu sendRemainingIns:sendRemainingIns timeout:timeout data:data completion:completion];
-            return;
-        } else if (statusCode == 0x9000) {
+            if (!buffer) {
+                buffer = [[YKFResponseBuffer alloc] initWithCapacity:responseData.length + remainingLength];
+            }
+            [buffer appendData:responseData];
+            [buffer reserveLength:remainingLength];
+            
+            if (!sendRemainingApdu) {
+                sendRemainingIsExtended = self.usesExtendedLength;
+                sendRemainingApdu = [self sendRemainingApdu:sendRemainingIns];
+            }
+            [self.connectionController execute:sendRemainingApdu timeout:timeout completion:weakResponseBlock];
+        } else if (statusCode == YKFAPDUErrorCodeNoError) {
+            NSData *data = responseData;
+            if (buffer) {
+                [buffer appendData:responseData];
+                data = [buffer takeData];
+            }
+            [self recordRoundTrips:roundTrips responseLength:data.length];
             completion(data, nil);
-            return;
         } else {
             YKFSessionError *error = [YKFSessionError errorWithCode:statusCode];
             completion(nil, error);
         }
-    }];
+    };
+    weakResponseBlock = responseBlock;
+    
+    [self.connectionController execute:apdu timeout:timeout completion:responseBlock];
 }
 
 - (void)executeCommand:(YKFAPDU *)apdu completion:(YKFSmartCardInterfaceResponseBlock)completion {
@@ -131,8 +195,17 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
 - (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout completion:(YKFSmartCardInterfaceResponseBlock)completion {
     YKFParameterAssertReturn(apdu);
     YKFParameterAssertReturn(completion);
-    NSMutableData *data = [NSMutableData new];
-    [self executeCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout data:data completion:completion];
+    if ([self shouldChainCommand:apdu]) {
+        [self executeChainedCommand:apdu offset:0 sendRemainingIns:sendRemainingIns timeout:timeout completion:completion];
+        return;
+    }
+    if (self.usesExtendedLength && apdu.mayReturnLongResponse && apdu.commandData && apdu.type == YKFAPDUTypeShort) {
+        // Ask for the whole response in the first exchange.
+        YKFAPDU *extendedApdu = [[YKFAPDU alloc] initExtendedWithCla:apdu.cla ins:apdu.ins p1:apdu.p1 p2:apdu.p2 data:apdu.commandData];
+        [self readResponseOfCommand:extendedApdu shortCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout completion:completion];
+        return;
+    }
+    [self readResponseOfCommand:apdu shortCommand:nil sendRemainingIns:sendRemainingIns timeout:timeout completion:completion];
 }
 
 - (void)dispatchAfterCurrentCommands:(YKFSmartCardInterfaceCommandBlock)block {
@@ -145,8 +218,116 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
     }];
 }
 
+- (void)dispatchAfterCurrentCommands:(YKFSmartCardInterfaceCommandBlock)block delay:(NSTimeInterval)delay {
+    [self.connectionController dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+        if (operation.isCancelled) {
+            return;
+        }
+        block();
+    } delay:delay];
+}
+
+#pragma mark - Command chaining
+
+- (BOOL)shouldChainCommand:(YKFAPDU *)apdu {
+    if (!self.connectionController.commandChainingEnabled || !apdu.commandData) {
+        return NO;
+    }
+    return apdu.commandData.length > [self commandChainingBlockSize];
+}
+
+- (NSUInteger)commandChainingBlockSize {
+    NSUInteger blockSize = MIN(self.connectionController.commandChainingBlockSize, UINT8_MAX);
+    return blockSize ? blockSize : UINT8_MAX;
+}
+
+/*
+ Sends the data of the command in blocks of commandChainingBlockSize bytes, with the chaining bit of CLA set on every
+ block but the last one (ISO 7816-4). The key replies 9000 to every chained block and the response to the whole
+ command comes with the last block.
+ 
+ Each block is queued on the communication queue from the completion of the previous one, so a block which fails stops
+ the chain instead of letting the key execute the command with the data of the remaining blocks only.
+ */
+- (void)executeChainedCommand:(YKFAPDU *)apdu offset:(NSUInteger)offset sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout completion:(YKFSmartCardInterfaceResponseBlock)completion {
+    NSData *commandData = apdu.commandData;
+    NSUInteger blockLength = MIN(commandData.length - offset, [self commandChainingBlockSize]);
+    BOOL isLastBlock = offset + blockLength == commandData.length;
+    
+    UInt8 cla = isLastBlock ? apdu.cla : apdu.cla | YKFSmartCardInterfaceCommandChainingMask;
+    NSData *blockData = [commandData ykf_noCopySubdataWithRange:NSMakeRange(offset, blockLength)];
+    YKFAPDU *block = [[YKFAPDU alloc] initWithCla:cla ins:apdu.ins p1:apdu.p1 p2:apdu.p2 data:blockData type:YKFAPDUTypeShort];
+    
+    if (isLastBlock) {
+        [self readResponseOfCommand:block shortCommand:nil sendRemainingIns:sendRemainingIns timeout:timeout completion:completion];
+        return;
+    }
+    
+    [self.connectionController execute:block
+                               timeout:timeout
+                            completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        if (error) {
+            completion(nil, error);
+            return;
+        }
+        UInt16 statusCode = [self statusCodeFromKeyResponse:response];
+        if (statusCode != YKFAPDUErrorCodeNoError) {
+            completion(nil, [YKFSessionError errorWithCode:statusCode]);
+            return;
+        }
+        [self executeChainedCommand:apdu offset:offset + blockLength sendRemainingIns:sendRemainingIns timeout:timeout completion:completion];
+    }];
+}
+
 #pragma mark - Helpers
 
+- (YKFAPDU *)sendRemainingApdu:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns {
+    UInt8 ins;
+    switch (sendRemainingIns) {
+        case YKFSmartCardInterfaceSendRemainingInsNormal:
+            ins = 0xC0;
+            break;
+        case YKFSmartCardInterfaceSendRemainingInsOATH:
+            ins = 0xA5;
+            break;
+    }
+    if (self.usesExtendedLength) {
+        // Ask for all the remaining data with the maximum extended Le.
+        return [[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(unsigned char[]){0x00, ins, 0x00, 0x00, 0x00, 0x00, 0x00} length:7]];
+    }
+    return [[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(unsigned char[]){0x00, ins, 0x00, 0x00, 0x00} length:5]];
+}
+
+/*
+ The key replies 6700 (wrong length) or 6Cxx (wrong Le) to an extended APDU it does not accept, and Core NFC fails the
+ exchange when the tag does not handle the extended frame.
+ */
+- (BOOL)isExtendedLengthRejectedWithResponse:(NSData *)response error:(NSError *)error {
+    if (error) {
+        return [error.domain isEqualToString:NFCErrorDomain] && (error.code == NFCReaderTransceiveErrorTagResponseError || error.code == NFCReaderTransceiveErrorPacketTooLong);
+    }
+    if (response.length < 2) {
+        return NO;
+    }
+    UInt16 statusCode = [self statusCodeFromKeyResponse:response];
+    return statusCode == YKFAPDUErrorCodeWrongLength || statusCode >> 8 == YKFAPDUErrorCodeWrongLe;
+}
+
+/*
+ Reading the response in chunks takes one exchange for every 256 bytes of response data.
+ */
+- (void)recordRoundTrips:(NSUInteger)roundTrips responseLength:(NSUInteger)responseLength {
+    NSUInteger chunkedRoundTrips = MAX(1, (responseLength + YKFSmartCardInterfaceShortResponseLength - 1) / YKFSmartCardInterfaceShortResponseLength);
+    NSUInteger savedRoundTrips = chunkedRoundTrips > roundTrips ? chunkedRoundTrips - roundTrips : 0;
+    
+    self.lastCommandRoundTrips = roundTrips;
+    self.lastCommandSavedRoundTrips = savedRoundTrips;
+    self.savedRoundTrips += savedRoundTrips;
+    if (savedRoundTrips) {
+        YKFLogVerbose(@"Extended length saved %lu round-trips.", (unsigned long)savedRoundTrips);
+    }
+}
+
 - (NSData *)dataFromKeyResponse:(NSData *)response {
     YKFParameterAssertReturnValue(response, [NSData data]);
     YKFAssertReturnValue(response.length >= 2, @"Key response data is too short.", [NSData data]);
@@ -155,7 +336,7 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
         return [NSData data];
     } else {
         NSRange range = {0, response.length - 2};
-        return [response subdataWithRange:range];
+        return [response ykf_noCopySubdataWithRange:range];
     }
 }
 
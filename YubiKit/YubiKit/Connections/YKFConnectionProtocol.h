@@ -66,6 +66,12 @@ typedef void (^YKFManagementSessionCompletion)(YKFManagementSession *_Nullable,
 ///             when none of the supplied sessions can be used.
 @property (nonatomic, readonly) YKFSmartCardInterface *_Nullable smartCardInterface;
 
+/// @abstract Enables ISO 7816-4 command chaining for the commands sent by the sessions and the smartCardInterface.
+/// @discussion When enabled, a command with more data than fits a block for the transport is sent as a chain of short
+///             APDUs instead of one extended APDU. Use this with readers which reject extended APDUs or handle them
+///             slowly. The setting applies to the commands sent after it was changed. Disabled by default.
+@property (nonatomic, assign) BOOL commandChainingEnabled;
+
 typedef void (^YKFRawComandCompletion)(NSData *_Nullable, NSError *_Nullable);
 
 /// @abstract Send a APDU and get the unparsed result as an NSData from the YubiKey.
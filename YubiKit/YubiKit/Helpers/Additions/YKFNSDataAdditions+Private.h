@@ -23,6 +23,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@interface NSData(NSData_APDUResponse)
+
+/*!
+ YES if the data is a key response which ends with the 9000 (success) status code.
+ */
+- (BOOL)ykf_isSuccessfulAPDUResponse;
+
+@end
+
 @interface NSData (NSDATA_OATHAdditions)
 
 - (nullable NSData *)ykf_deriveOATHKeyWithSalt:(NSData *)salt;
@@ -62,6 +71,65 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@interface NSData(NSData_NoCopySubdata)
+
+/*!
+ @method ykf_noCopySubdataWithRange:
+ 
+ @return
+    A data object which references the bytes in range without copying them. The returned object keeps an immutable
+    copy of the receiver alive, so slicing an immutable data object never copies the payload.
+ */
+- (NSData *)ykf_noCopySubdataWithRange:(NSRange)range;
+
+@end
+
+/*
+ Returns the length of the unpadded base64url encoding of length bytes.
+ */
+NSUInteger YKFBase64URLEncodedLength(NSUInteger length);
+
+/*
+ Writes the unpadded base64url encoding of length bytes into base64, which must have room for
+ YKFBase64URLEncodedLength(length) characters.
+ */
+void YKFBase64URLEncode(const UInt8 *bytes, NSUInteger length, char *base64);
+
+/*
+ Returns the length of the data encoded by length base64url characters, with or without padding.
+ */
+NSUInteger YKFBase64URLDecodedLength(const char *base64, NSUInteger length);
+
+/*
+ Decodes length base64url characters, with or without padding, into bytes, which must have room for
+ YKFBase64URLDecodedLength(base64, length) bytes. The characters of the standard base64 alphabet are accepted too.
+ Returns NO if base64 is not a valid encoding.
+ */
+BOOL YKFBase64URLDecode(const char *base64, NSUInteger length, UInt8 *bytes);
+
+/*
+ Returns the maximum length of the data encoded by length Base32 characters.
+ */
+NSUInteger YKFBase32DecodedMaxLength(NSUInteger length);
+
+/*
+ Decodes length Base32 characters (upper or lower case) into bytes, which must have room for
+ YKFBase32DecodedMaxLength(length) bytes, and sets bytesLength to the decoded length. The padding and the whitespace
+ are skipped. Returns NO if base32 contains other characters which are not Base32 symbols.
+ */
+BOOL YKFBase32Decode(const char *base32, NSUInteger length, UInt8 *bytes, NSUInteger *bytesLength);
+
+/*
+ Writes the lowercase hex digits of length bytes into hex, which must have room for 2 * length characters.
+ */
+void YKFHexEncode(const UInt8 *bytes, NSUInteger length, char *hex);
+
+/*
+ Decodes hexLength hex digits (upper or lower case) into bytes, which must have room for hexLength / 2 bytes.
+ Returns NO if hexLength is odd or if hex contains characters which are not hex digits.
+ */
+BOOL YKFHexDecode(const char *hex, NSUInteger hexLength, UInt8 *bytes);
+
 @interface NSData(NSData_Conversion)
 /*!
  @method ykf_hexadecimalString:
@@ -71,6 +139,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSString *)ykf_hexadecimalString;
 
+/*!
+ @method ykf_dataWithHexadecimalString:
+ 
+ @return
+    A data object from a string of hex symbols or nil if the string is not a sequence of hex encoded bytes.
+ */
++ (nullable NSData *)ykf_dataWithHexadecimalString:(NSString *)hexString;
+
 @end
 
 
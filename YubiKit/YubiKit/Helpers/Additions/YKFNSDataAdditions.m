@@ -15,6 +15,8 @@
 #import <Foundation/Foundation.h>
 #import "YKFNSDataAdditions.h"
 #import "YKFNSDataAdditions+Private.h"
+#import "YKFByteSpan.h"
+#import "YKFAPDUError.h"
 #import "MF_Base32Additions.h"
 
 #pragma mark - SHA
@@ -76,7 +78,7 @@
         return nil;
     }
     
-    UInt32 otpResponseValue = CFSwapInt32BigToHost(*((UInt32 *)&self.bytes[index]));
+    UInt32 otpResponseValue = YKFLoadBigEndianUInt32((const UInt8 *)self.bytes + index);
     otpResponseValue &= 0x7FFFFFFF; // remove first bit (sign bit)
     
     UInt32 modMask = pow(10, digits); // get last [digits] only
@@ -261,48 +263,171 @@
 @implementation NSData(NSData_Marshalling)
 
 - (NSUInteger)ykf_getBigEndianIntegerInRange:(NSRange)range {
-    NSInteger numberOfBytes = range.length;
-    if (numberOfBytes>sizeof(NSUInteger)) {
-        numberOfBytes = sizeof(NSUInteger);
+    // Reads at most the first sizeof(NSUInteger) bytes of the range.
+    YKFByteReader reader = YKFByteReaderMakeWithData(self);
+    if (!YKFByteReaderSkip(&reader, range.location)) {
+        return 0;
     }
-    Byte buffer[numberOfBytes];
-    [self getBytes:buffer range:NSMakeRange(range.location, numberOfBytes)];
-    NSUInteger value = 0;
-    for(NSInteger i = 0; i < numberOfBytes; ++i){
-        value = (value<<8) | buffer[i];
+    return (NSUInteger)YKFByteReaderReadBigEndian(&reader, MIN(range.length, sizeof(NSUInteger)));
+}
+
+@end
+
+#pragma mark - APDU Response
+
+@implementation NSData(NSData_APDUResponse)
+
+- (BOOL)ykf_isSuccessfulAPDUResponse {
+    if (self.length < 2) {
+        return NO;
     }
-    return value;
+    return YKFLoadBigEndianUInt16((const UInt8 *)self.bytes + self.length - 2) == YKFAPDUErrorCodeNoError;
 }
 
 @end
 
 #pragma mark - WebSafe Base64
 
+/*
+ The base64url alphabet (RFC 4648, section 5).
+ */
+static const char YKFBase64URLEncodingTable[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/*
+ The value of every base64url symbol, YKFBase64InvalidSymbol for the other characters. The symbols of the standard
+ alphabet ('+' and '/') are accepted too.
+ */
+static const UInt8 YKFBase64InvalidSymbol = 0xFF;
+
+static const UInt8 *YKFBase64URLDecodingTable(void) {
+    static UInt8 table[256];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        memset(table, YKFBase64InvalidSymbol, sizeof(table));
+        for (UInt8 i = 0; i < sizeof(YKFBase64URLEncodingTable); ++i) {
+            table[(UInt8)YKFBase64URLEncodingTable[i]] = i;
+        }
+        table['+'] = 62;
+        table['/'] = 63;
+    });
+    return table;
+}
+
+NSUInteger YKFBase64URLEncodedLength(NSUInteger length) {
+    return length / 3 * 4 + (length % 3 ? length % 3 + 1 : 0);
+}
+
+void YKFBase64URLEncode(const UInt8 *bytes, NSUInteger length, char *base64) {
+    const char *table = YKFBase64URLEncodingTable;
+    
+    // Full blocks of 3 bytes -> 4 symbols.
+    NSUInteger blocksLength = length - length % 3;
+    NSUInteger i = 0;
+    for (; i < blocksLength; i += 3) {
+        UInt32 block = (UInt32)bytes[i] << 16 | (UInt32)bytes[i + 1] << 8 | bytes[i + 2];
+        base64[0] = table[(block >> 18) & 0x3F];
+        base64[1] = table[(block >> 12) & 0x3F];
+        base64[2] = table[(block >> 6) & 0x3F];
+        base64[3] = table[block & 0x3F];
+        base64 += 4;
+    }
+    
+    // The last 1 or 2 bytes -> 2 or 3 symbols, without padding.
+    NSUInteger remaining = length - i;
+    if (remaining) {
+        UInt32 block = (UInt32)bytes[i] << 16 | (remaining == 2 ? (UInt32)bytes[i + 1] << 8 : 0);
+        base64[0] = table[(block >> 18) & 0x3F];
+        base64[1] = table[(block >> 12) & 0x3F];
+        if (remaining == 2) {
+            base64[2] = table[(block >> 6) & 0x3F];
+        }
+    }
+}
+
+NSUInteger YKFBase64URLDecodedLength(const char *base64, NSUInteger length) {
+    // Up to two padding symbols are tolerated.
+    for (NSUInteger padding = 0; padding < 2 && length > 0 && base64[length - 1] == '='; ++padding) {
+        --length;
+    }
+    return length / 4 * 3 + (length % 4 ? length % 4 - 1 : 0);
+}
+
+BOOL YKFBase64URLDecode(const char *base64, NSUInteger length, UInt8 *bytes) {
+    for (NSUInteger padding = 0; padding < 2 && length > 0 && base64[length - 1] == '='; ++padding) {
+        --length;
+    }
+    if (length % 4 == 1) {
+        return NO;
+    }
+    const UInt8 *table = YKFBase64URLDecodingTable();
+    
+    // The invalid symbols are accumulated and checked once, so the loop has no branch on the input.
+    UInt8 invalid = 0;
+    NSUInteger blocksLength = length - length % 4;
+    NSUInteger i = 0;
+    for (; i < blocksLength; i += 4) {
+        UInt8 a = table[(UInt8)base64[i]], b = table[(UInt8)base64[i + 1]];
+        UInt8 c = table[(UInt8)base64[i + 2]], d = table[(UInt8)base64[i + 3]];
+        invalid |= (a | b | c | d) & 0xC0;
+        UInt32 block = (UInt32)a << 18 | (UInt32)b << 12 | (UInt32)c << 6 | d;
+        bytes[0] = (UInt8)(block >> 16);
+        bytes[1] = (UInt8)(block >> 8);
+        bytes[2] = (UInt8)block;
+        bytes += 3;
+    }
+    
+    // The last 2 or 3 symbols -> 1 or 2 bytes.
+    NSUInteger remaining = length - i;
+    if (remaining) {
+        UInt8 a = table[(UInt8)base64[i]], b = table[(UInt8)base64[i + 1]];
+        UInt8 c = remaining == 3 ? table[(UInt8)base64[i + 2]] : 0;
+        invalid |= (a | b | c) & 0xC0;
+        UInt32 block = (UInt32)a << 18 | (UInt32)b << 12 | (UInt32)c << 6;
+        bytes[0] = (UInt8)(block >> 16);
+        if (remaining == 3) {
+            bytes[1] = (UInt8)(block >> 8);
+        }
+    }
+    return invalid == 0;
+}
+
 @implementation NSData(NSData_WebSafeBase64)
 
 - (instancetype)ykf_initWithWebsafeBase64EncodedString:(NSString *)websafeBase64EncodedData dataLength:(NSUInteger)dataLen {
-    if (!websafeBase64EncodedData) {
+    NSData *base64 = [websafeBase64EncodedData dataUsingEncoding:NSASCIIStringEncoding];
+    if (!base64) {
+        return nil;
+    }
+    NSUInteger length = YKFBase64URLDecodedLength(base64.bytes, base64.length);
+    
+    // The padding of the encoded string is the padding for an output of dataLen bytes.
+    if (length % 3 != dataLen % 3) {
         return nil;
     }
-    NSMutableString *base64EncodedString = [[NSMutableString alloc] initWithString:websafeBase64EncodedData];
-    [base64EncodedString replaceOccurrencesOfString:@"-" withString:@"+" options:0 range:NSMakeRange(0, [base64EncodedString length])];
-    [base64EncodedString replaceOccurrencesOfString:@"_" withString:@"/" options:0 range:NSMakeRange(0, [base64EncodedString length])];
-    if ((dataLen % 3) == 1){
-        [base64EncodedString appendString:@"=="];
+    
+    UInt8 *bytes = malloc(MAX(length, 1));
+    if (!bytes) {
+        return nil;
     }
-    else if ((dataLen % 3) == 2) {
-        [base64EncodedString appendString:@"="];
+    if (!YKFBase64URLDecode(base64.bytes, base64.length, bytes)) {
+        free(bytes);
+        return nil;
     }
-    return [self initWithBase64EncodedString:base64EncodedString options:0];
+    return [self initWithBytesNoCopy:bytes length:length freeWhenDone:YES];
 }
 
 - (NSString *)ykf_websafeBase64EncodedString {
-    NSMutableString *base64 = [[NSMutableString alloc] initWithString:[self base64EncodedStringWithOptions:0]];
-    [base64 replaceOccurrencesOfString:@"+" withString:@"-" options:0 range:NSMakeRange(0, [base64 length])];
-    [base64 replaceOccurrencesOfString:@"/" withString:@"_" options:0 range:NSMakeRange(0, [base64 length])];
-    [base64 replaceOccurrencesOfString:@"=" withString:@"" options:0 range:NSMakeRange(0, [base64 length])];
+    NSUInteger length = YKFBase64URLEncodedLength(self.length);
+    if (!length) {
+        return [NSString string];
+    }
     
-    return [NSString stringWithString:base64];
+    char *base64 = malloc(length);
+    if (!base64) {
+        return nil;
+    }
+    YKFBase64URLEncode(self.bytes, self.length, base64);
+    return [[NSString alloc] initWithBytesNoCopy:base64 length:length encoding:NSASCIIStringEncoding freeWhenDone:YES];
 }
 
 @end
@@ -321,18 +446,111 @@
 
 @end
 
+#pragma mark - No Copy Subdata
+
+@implementation NSData(NSData_NoCopySubdata)
+
+- (NSData *)ykf_noCopySubdataWithRange:(NSRange)range {
+    NSParameterAssert([self ykf_containsRange:range]);
+    if (!range.length) {
+        return [NSData data];
+    }
+    
+    // For immutable data copy is a retain. The deallocator block keeps the backing buffer alive for the slice.
+    NSData *backingData = [self copy];
+    if (range.location == 0 && range.length == backingData.length) {
+        return backingData;
+    }
+    
+    UInt8 *sliceBytes = (UInt8 *)backingData.bytes + range.location;
+    return [[NSData alloc] initWithBytesNoCopy:sliceBytes length:range.length deallocator:^(void *bytes, NSUInteger length) {
+        (void)backingData;
+    }];
+}
+
+@end
+
 #pragma mark - Base32
 
+/*
+ The value of every Base32 symbol (RFC 4648, upper or lower case). The padding and the whitespace are skipped,
+ the other characters are invalid.
+ */
+static const UInt8 YKFBase32SkippedSymbol = 0xFE;
+static const UInt8 YKFBase32InvalidSymbol = 0xFF;
+
+static const UInt8 *YKFBase32DecodingTable(void) {
+    static UInt8 table[256];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        memset(table, YKFBase32InvalidSymbol, sizeof(table));
+        for (UInt8 i = 0; i < 26; ++i) {
+            table['A' + i] = i;
+            table['a' + i] = i;
+        }
+        for (UInt8 i = 0; i < 6; ++i) {
+            table['2' + i] = 26 + i;
+        }
+        const char *skipped = "= \t\r\n";
+        for (NSUInteger i = 0; skipped[i]; ++i) {
+            table[(UInt8)skipped[i]] = YKFBase32SkippedSymbol;
+        }
+    });
+    return table;
+}
+
+NSUInteger YKFBase32DecodedMaxLength(NSUInteger length) {
+    return length / 8 * 5 + 5;
+}
+
+BOOL YKFBase32Decode(const char *base32, NSUInteger length, UInt8 *bytes, NSUInteger *bytesLength) {
+    const UInt8 *table = YKFBase32DecodingTable();
+    
+    // The symbols are shifted into an accumulator and every complete byte is written out.
+    UInt32 accumulator = 0;
+    NSUInteger bits = 0;
+    NSUInteger symbols = 0;
+    NSUInteger written = 0;
+    for (NSUInteger i = 0; i < length; ++i) {
+        UInt8 value = table[(UInt8)base32[i]];
+        if (value == YKFBase32SkippedSymbol) {
+            continue;
+        }
+        if (value == YKFBase32InvalidSymbol) {
+            return NO;
+        }
+        accumulator = (accumulator << 5) | value;
+        bits += 5;
+        ++symbols;
+        if (bits >= 8) {
+            bits -= 8;
+            bytes[written++] = (UInt8)(accumulator >> bits);
+        }
+    }
+    
+    // A single trailing symbol is decoded to one byte, as in the previous decoder.
+    if (symbols % 8 == 1) {
+        bytes[written++] = (UInt8)(accumulator << 3);
+    }
+    *bytesLength = written;
+    return YES;
+}
+
 @implementation NSData(NSData_Base32Additions)
 
 + (NSData *)ykf_dataWithBase32String:(NSString *)base32String {
-    NSRange range = NSMakeRange(0, [base32String length]);
-    NSError *error = NULL;
-    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern: @"[A-Za-z2-7=]*" options: 0 error: &error];
-    NSRange foundRange = [regex rangeOfFirstMatchInString: base32String options: 0 range: range];
-    if (!NSEqualRanges(range, foundRange)) return nil;
+    NSData *base32 = [base32String dataUsingEncoding:NSASCIIStringEncoding];
+    if (!base32) {
+        return nil;
+    }
     
-    return [self dataWithBase32String: base32String];
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:YKFBase32DecodedMaxLength(base32.length)];
+    NSUInteger length = 0;
+    if (!YKFBase32Decode(base32.bytes, base32.length, data.mutableBytes, &length)) {
+        return nil;
+    }
+    data.length = length;
+    return data;
 }
 
 - (NSString *)ykf_base32String {
@@ -343,23 +561,91 @@
 
 #pragma mark - HEX string conversion
 
+/*
+ The two lowercase hex digits of every byte value, indexed by 2 * byte.
+ */
+static const char YKFHexEncodingTable[512] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+/*
+ The value of every hex digit (upper or lower case), YKFHexInvalidDigit for the other characters.
+ */
+static const UInt8 YKFHexInvalidDigit = 0xFF;
+
+static const UInt8 *YKFHexDecodingTable(void) {
+    static UInt8 table[256];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        memset(table, YKFHexInvalidDigit, sizeof(table));
+        for (UInt8 digit = 0; digit < 10; ++digit) {
+            table['0' + digit] = digit;
+        }
+        for (UInt8 digit = 0; digit < 6; ++digit) {
+            table['a' + digit] = 10 + digit;
+            table['A' + digit] = 10 + digit;
+        }
+    });
+    return table;
+}
+
+void YKFHexEncode(const UInt8 *bytes, NSUInteger length, char *hex) {
+    for (NSUInteger i = 0; i < length; ++i) {
+        memcpy(hex + 2 * i, YKFHexEncodingTable + 2 * bytes[i], 2);
+    }
+}
+
+BOOL YKFHexDecode(const char *hex, NSUInteger hexLength, UInt8 *bytes) {
+    if (hexLength % 2) {
+        return NO;
+    }
+    const UInt8 *table = YKFHexDecodingTable();
+    // The invalid digits are accumulated and checked once, so the loop has no branch on the input.
+    UInt8 invalid = 0;
+    for (NSUInteger i = 0; i < hexLength / 2; ++i) {
+        UInt8 high = table[(UInt8)hex[2 * i]];
+        UInt8 low = table[(UInt8)hex[2 * i + 1]];
+        invalid |= (high | low) & 0xF0;
+        bytes[i] = (UInt8)(high << 4) | low;
+    }
+    return invalid == 0;
+}
+
 @implementation NSData (NSData_HexConversion)
 
 - (NSString *)ykf_hexadecimalString
 {
     /* Returns hexadecimal string of NSData. Empty string if data is empty. */
-    const unsigned char *dataBuffer = (const unsigned char *)[self bytes];
-    if (!dataBuffer) {
+    NSUInteger dataLength = self.length;
+    if (!dataLength) {
         return [NSString string];
     }
-
-    NSUInteger          dataLength  = [self length];
-    NSMutableString     *hexString  = [NSMutableString stringWithCapacity:(dataLength * 2)];
-    for (int i = 0; i < dataLength; ++i) {
-        [hexString appendFormat:@"%02x", (unsigned int)dataBuffer[i]];
+    
+    char *hex = malloc(dataLength * 2);
+    if (!hex) {
+        return [NSString string];
     }
+    YKFHexEncode(self.bytes, dataLength, hex);
+    return [[NSString alloc] initWithBytesNoCopy:hex length:dataLength * 2 encoding:NSASCIIStringEncoding freeWhenDone:YES];
+}
 
-    return [NSString stringWithString:hexString];
++ (NSData *)ykf_dataWithHexadecimalString:(NSString *)hexString {
+    NSData *hex = [hexString dataUsingEncoding:NSASCIIStringEncoding];
+    if (!hex || hex.length % 2) {
+        return nil;
+    }
+    
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:hex.length / 2];
+    if (!YKFHexDecode(hex.bytes, hex.length, data.mutableBytes)) {
+        return nil;
+    }
+    return data;
 }
 
 @end
@@ -370,19 +656,12 @@
 
 - (NSUInteger)ykf_integerValue
 {
-    UInt8 *dataBytes = (UInt8 *)self.bytes;
-    if (!dataBytes) {
+    // The value of the last sizeof(NSUInteger) bytes, the leading bytes of longer data are shifted out.
+    NSUInteger size = MIN(self.length, sizeof(NSUInteger));
+    if (!size) {
         return 0;
     }
-    
-    NSUInteger value = 0;
-    NSUInteger dataLength  = [self length];
-    for (int i = 0; i < dataLength; ++i) {
-        value <<= 8;
-        value += dataBytes[i];
-    }
-
-    return value;
+    return (NSUInteger)YKFLoadBigEndian((const UInt8 *)self.bytes + self.length - size, size);
 }
 
 @end
@@ -32,7 +32,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)ykf_appendEntryWithTag:(UInt8)tag data:(NSData *)data;
 
 /*
-Appends [tag] + 0x02 + 2 bytes to the mutable data buffer.
+Appends [tag] + 0x02 + 2 bytes to the mutable data buffer. The value is big endian.
 */
 - (void)ykf_appendShortWithTag:(UInt8)tag data:(NSUInteger)data;
 
@@ -63,4 +63,26 @@ Appends [tag] + 0x02 + 2 bytes to the mutable data buffer.
 
 @end
 
+/*
+ Helper category for writing the client data JSON of the FIDO requests directly into a buffer.
+ */
+@interface NSMutableData(NSMutableData_ClientData)
+
+/*
+ Appends the UTF8 bytes of the string.
+ */
+- (void)ykf_appendUTF8String:(NSString *)string;
+
+/*
+ Appends the string as a quoted JSON string. The quotes, backslashes and control characters are escaped.
+ */
+- (void)ykf_appendJSONString:(NSString *)string;
+
+/*
+ Appends the unpadded base64url encoding of the data.
+ */
+- (void)ykf_appendWebsafeBase64EncodedData:(NSData *)data;
+
+@end
+
 NS_ASSUME_NONNULL_END
@@ -14,6 +14,8 @@
 
 #import "YKFNSMutableDataAdditions.h"
 #import "YKFAssert.h"
+#import "YKFByteSpan.h"
+#import "YKFNSDataAdditions+Private.h"
 
 @implementation NSMutableData(NSMutableData_APDU)
 
@@ -33,64 +35,124 @@
 
 - (void)ykf_appendShortWithTag:(UInt8)tag data:(NSUInteger)data {
     YKFParameterAssertReturn(tag > 0);
-    NSMutableData *shortData =  [[NSMutableData alloc] init];
-    [shortData ykf_appendByte: data & 0xff00 >> 8];
-    [shortData ykf_appendByte: data & 0xff];
-    [self ykf_appendEntryWithTag:tag data:shortData];
+    [self ykf_appendUInt16EntryWithTag:tag value:(UInt16)data];
 }
 
-
 - (void)ykf_appendEntryWithTag:(UInt8)tag headerBytes:(NSArray *)headerBytes data:(NSData *)data {
     YKFParameterAssertReturn(tag > 0);
     YKFParameterAssertReturn(headerBytes.count > 0);
     YKFParameterAssertReturn(data.length > 0);
     YKFParameterAssertReturn(headerBytes.count + data.length <= UINT8_MAX);
     
-    NSMutableData *buffer = [[NSMutableData alloc] initWithCapacity:headerBytes.count + data.length];
+    NSUInteger offset = self.length;
+    self.length = offset + 2 + headerBytes.count + data.length;
+    YKFByteWriter writer = YKFByteWriterMake((UInt8 *)self.mutableBytes + offset, self.length - offset);
+    YKFByteWriterWriteUInt8(&writer, tag);
+    YKFByteWriterWriteUInt8(&writer, headerBytes.count + data.length);
     for (NSNumber *byte in headerBytes) {
-        UInt8 byteValue = [byte unsignedCharValue];
-        [buffer ykf_appendByte:byteValue];
+        YKFByteWriterWriteUInt8(&writer, [byte unsignedCharValue]);
     }
-    [buffer appendData:data];
-    
-    [self ykf_appendEntryWithTag:tag data:buffer];
+    YKFByteWriterWriteBytes(&writer, data.bytes, data.length);
 }
 
 - (void)ykf_appendUInt8EntryWithTag:(UInt8)tag value:(UInt8)value {
     YKFParameterAssertReturn(tag > 0);
-    [self ykf_appendByte:tag];
-    [self ykf_appendByte:sizeof(UInt8)];
-    [self appendBytes:&value length:sizeof(UInt8)];
+    UInt8 entry[] = {tag, sizeof(UInt8), value};
+    [self appendBytes:entry length:sizeof(entry)];
 }
 
 - (void)ykf_appendUInt16EntryWithTag:(UInt8)tag value:(UInt16)value {
     YKFParameterAssertReturn(tag > 0);
-    
-    UInt16 bigEndianValue = CFSwapInt16HostToBig(value);
-    
-    [self ykf_appendByte:tag];
-    [self ykf_appendByte:sizeof(UInt16)];
-    [self appendBytes:&bigEndianValue length:sizeof(UInt16)];
+    [self ykf_appendEntryWithTag:tag value:value size:sizeof(UInt16)];
 }
 
 - (void)ykf_appendUInt32EntryWithTag:(UInt8)tag value:(UInt32)value {
     YKFParameterAssertReturn(tag > 0);
-    
-    UInt32 bigEndianValue = CFSwapInt32HostToBig(value);
-    
-    [self ykf_appendByte:tag];
-    [self ykf_appendByte:sizeof(UInt32)];
-    [self appendBytes:&bigEndianValue length:sizeof(UInt32)];
+    [self ykf_appendEntryWithTag:tag value:value size:sizeof(UInt32)];
 }
 
 - (void)ykf_appendUInt64EntryWithTag:(UInt8)tag value:(UInt64)value {
     YKFParameterAssertReturn(tag > 0);
+    [self ykf_appendEntryWithTag:tag value:value size:sizeof(UInt64)];
+}
+
+#pragma mark - Helpers
+
+/*
+ Appends [tag] + [size] + [size bytes of the value in big endian order] with one append.
+ */
+- (void)ykf_appendEntryWithTag:(UInt8)tag value:(UInt64)value size:(NSUInteger)size {
+    UInt8 entry[2 + sizeof(UInt64)];
+    YKFByteWriter writer = YKFByteWriterMake(entry, sizeof(entry));
+    YKFByteWriterWriteUInt8(&writer, tag);
+    YKFByteWriterWriteUInt8(&writer, size);
+    YKFByteWriterWriteBigEndian(&writer, value, size);
+    [self appendBytes:entry length:writer.length];
+}
+
+@end
+
+@implementation NSMutableData(NSMutableData_ClientData)
+
+- (void)ykf_appendUTF8String:(NSString *)string {
+    NSUInteger maxLength = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    NSUInteger offset = self.length;
+    self.length = offset + maxLength;
+    
+    NSUInteger usedLength = 0;
+    [string getBytes:(UInt8 *)self.mutableBytes + offset maxLength:maxLength usedLength:&usedLength encoding:NSUTF8StringEncoding
+             options:0 range:NSMakeRange(0, string.length) remainingRange:NULL];
+    self.length = offset + usedLength;
+}
+
+- (void)ykf_appendJSONString:(NSString *)string {
+    static const char hexDigits[] = "0123456789abcdef";
     
-    UInt64 bigEndianValue = CFSwapInt64HostToBig(value);
+    NSUInteger start = self.length;
+    [self ykf_appendByte:'"'];
+    [self ykf_appendUTF8String:string];
     
-    [self ykf_appendByte:tag];
-    [self ykf_appendByte:sizeof(UInt64)];
-    [self appendBytes:&bigEndianValue length:sizeof(UInt64)];
+    // The multibyte UTF8 sequences have bit 8 set in all the bytes, so they are copied as they are.
+    NSUInteger end = self.length;
+    NSUInteger escapedLength = 0;
+    const UInt8 *bytes = (const UInt8 *)self.bytes;
+    for (NSUInteger i = start + 1; i < end; ++i) {
+        UInt8 byte = bytes[i];
+        if (byte == '"' || byte == '\\') {
+            escapedLength += 1;
+        } else if (byte < 0x20) {
+            escapedLength += 5;
+        }
+    }
+    if (escapedLength) {
+        // Escapes in place, from the end, after growing the buffer once.
+        self.length = end + escapedLength;
+        UInt8 *buffer = (UInt8 *)self.mutableBytes;
+        NSUInteger write = end + escapedLength;
+        for (NSUInteger read = end; read > start + 1; --read) {
+            UInt8 byte = buffer[read - 1];
+            if (byte == '"' || byte == '\\') {
+                buffer[--write] = byte;
+                buffer[--write] = '\\';
+            } else if (byte < 0x20) {
+                buffer[--write] = hexDigits[byte & 0x0F];
+                buffer[--write] = hexDigits[byte >> 4];
+                buffer[--write] = '0';
+                buffer[--write] = '0';
+                buffer[--write] = 'u';
+                buffer[--write] = '\\';
+            } else {
+                buffer[--write] = byte;
+            }
+        }
+    }
+    [self ykf_appendByte:'"'];
+}
+
+- (void)ykf_appendWebsafeBase64EncodedData:(NSData *)data {
+    NSUInteger offset = self.length;
+    self.length = offset + YKFBase64URLEncodedLength(data.length);
+    YKFBase64URLEncode(data.bytes, data.length, (char *)self.mutableBytes + offset);
 }
 
 @end
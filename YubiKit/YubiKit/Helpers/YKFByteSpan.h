@@ -0,0 +1,248 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFByteSpan_h
+#define YKFByteSpan_h
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Big endian loads and stores at any address. The values are copied with memcpy, so the bytes do not need to be
+ aligned for the integer type, and the compiler reduces the copy and the swap to a single load or store.
+ */
+
+static inline UInt16 YKFLoadBigEndianUInt16(const UInt8 *bytes) {
+    UInt16 value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt16BigToHost(value);
+}
+
+static inline UInt32 YKFLoadBigEndianUInt32(const UInt8 *bytes) {
+    UInt32 value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt32BigToHost(value);
+}
+
+static inline UInt64 YKFLoadBigEndianUInt64(const UInt8 *bytes) {
+    UInt64 value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt64BigToHost(value);
+}
+
+/*
+ Loads a big endian unsigned integer of size bytes (0 to 8).
+ */
+static inline UInt64 YKFLoadBigEndian(const UInt8 *bytes, NSUInteger size) {
+    NSCParameterAssert(size <= sizeof(UInt64));
+    UInt64 value = 0;
+    memcpy((UInt8 *)&value + sizeof(UInt64) - size, bytes, size);
+    return CFSwapInt64BigToHost(value);
+}
+
+static inline void YKFStoreBigEndianUInt16(UInt8 *bytes, UInt16 value) {
+    value = CFSwapInt16HostToBig(value);
+    memcpy(bytes, &value, sizeof(value));
+}
+
+static inline void YKFStoreBigEndianUInt32(UInt8 *bytes, UInt32 value) {
+    value = CFSwapInt32HostToBig(value);
+    memcpy(bytes, &value, sizeof(value));
+}
+
+static inline void YKFStoreBigEndianUInt64(UInt8 *bytes, UInt64 value) {
+    value = CFSwapInt64HostToBig(value);
+    memcpy(bytes, &value, sizeof(value));
+}
+
+/*
+ Stores the size (0 to 8) least significant bytes of value in big endian order.
+ */
+static inline void YKFStoreBigEndian(UInt8 *bytes, UInt64 value, NSUInteger size) {
+    NSCParameterAssert(size <= sizeof(UInt64));
+    value = CFSwapInt64HostToBig(value);
+    memcpy(bytes, (const UInt8 *)&value + sizeof(UInt64) - size, size);
+}
+
+/*
+ Returns the number of bytes required to store value without leading zero bytes (0 for 0).
+ */
+static inline NSUInteger YKFBigEndianLength(UInt64 value) {
+    NSUInteger size = 0;
+    for (; value; value >>= 8) {
+        ++size;
+    }
+    return size;
+}
+
+#pragma mark - YKFByteReader
+
+/*
+ Bounds checked reader over a span of bytes. A read past the end of the span returns 0, does not advance the reader
+ and sets the overflow flag, which stays set, so a parser can read all the fields and check the flag once.
+ */
+typedef struct {
+    const UInt8 *_Nullable bytes;
+    NSUInteger length;
+    NSUInteger offset;
+    BOOL overflow;
+} YKFByteReader;
+
+static inline YKFByteReader YKFByteReaderMake(const void *_Nullable bytes, NSUInteger length) {
+    YKFByteReader reader = {bytes, length, 0, NO};
+    return reader;
+}
+
+static inline YKFByteReader YKFByteReaderMakeWithData(NSData *_Nullable data) {
+    return YKFByteReaderMake(data.bytes, data.length);
+}
+
+static inline NSUInteger YKFByteReaderRemaining(const YKFByteReader *reader) {
+    return reader->length - reader->offset;
+}
+
+/*
+ Returns the pointer to the next count bytes and advances the reader, or NULL if there are less than count bytes left.
+ */
+static inline const UInt8 *_Nullable YKFByteReaderReadBytes(YKFByteReader *reader, NSUInteger count) {
+    if (reader->overflow || YKFByteReaderRemaining(reader) < count) {
+        reader->overflow = YES;
+        return NULL;
+    }
+    const UInt8 *bytes = reader->bytes + reader->offset;
+    reader->offset += count;
+    return bytes;
+}
+
+static inline BOOL YKFByteReaderSkip(YKFByteReader *reader, NSUInteger count) {
+    YKFByteReaderReadBytes(reader, count);
+    return !reader->overflow;
+}
+
+static inline UInt8 YKFByteReaderReadUInt8(YKFByteReader *reader) {
+    const UInt8 *bytes = YKFByteReaderReadBytes(reader, sizeof(UInt8));
+    return bytes ? bytes[0] : 0;
+}
+
+static inline UInt16 YKFByteReaderReadUInt16(YKFByteReader *reader) {
+    const UInt8 *bytes = YKFByteReaderReadBytes(reader, sizeof(UInt16));
+    return bytes ? YKFLoadBigEndianUInt16(bytes) : 0;
+}
+
+static inline UInt32 YKFByteReaderReadUInt32(YKFByteReader *reader) {
+    const UInt8 *bytes = YKFByteReaderReadBytes(reader, sizeof(UInt32));
+    return bytes ? YKFLoadBigEndianUInt32(bytes) : 0;
+}
+
+static inline UInt64 YKFByteReaderReadUInt64(YKFByteReader *reader) {
+    const UInt8 *bytes = YKFByteReaderReadBytes(reader, sizeof(UInt64));
+    return bytes ? YKFLoadBigEndianUInt64(bytes) : 0;
+}
+
+/*
+ Reads a big endian unsigned integer of size bytes (0 to 8).
+ */
+static inline UInt64 YKFByteReaderReadBigEndian(YKFByteReader *reader, NSUInteger size) {
+    if (size > sizeof(UInt64)) {
+        reader->overflow = YES;
+        return 0;
+    }
+    const UInt8 *bytes = YKFByteReaderReadBytes(reader, size);
+    return bytes ? YKFLoadBigEndian(bytes, size) : 0;
+}
+
+#pragma mark - YKFByteWriter
+
+/*
+ Bounds checked writer into a span of bytes, usually a stack buffer or the bytes of a NSMutableData. A write past the
+ end of the span writes nothing and sets the overflow flag, which stays set.
+ */
+typedef struct {
+    UInt8 *_Nullable bytes;
+    NSUInteger capacity;
+    NSUInteger length;
+    BOOL overflow;
+} YKFByteWriter;
+
+static inline YKFByteWriter YKFByteWriterMake(void *_Nullable bytes, NSUInteger capacity) {
+    YKFByteWriter writer = {bytes, capacity, 0, NO};
+    return writer;
+}
+
+/*
+ Returns the pointer to the next count bytes and advances the writer, or NULL if there is no room for count bytes.
+ */
+static inline UInt8 *_Nullable YKFByteWriterReserveBytes(YKFByteWriter *writer, NSUInteger count) {
+    if (writer->overflow || writer->capacity - writer->length < count) {
+        writer->overflow = YES;
+        return NULL;
+    }
+    UInt8 *bytes = writer->bytes + writer->length;
+    writer->length += count;
+    return bytes;
+}
+
+static inline void YKFByteWriterWriteBytes(YKFByteWriter *writer, const void *_Nullable bytes, NSUInteger count) {
+    UInt8 *destination = YKFByteWriterReserveBytes(writer, count);
+    if (destination && count) {
+        memcpy(destination, bytes, count);
+    }
+}
+
+static inline void YKFByteWriterWriteUInt8(YKFByteWriter *writer, UInt8 value) {
+    UInt8 *bytes = YKFByteWriterReserveBytes(writer, sizeof(UInt8));
+    if (bytes) {
+        bytes[0] = value;
+    }
+}
+
+static inline void YKFByteWriterWriteUInt16(YKFByteWriter *writer, UInt16 value) {
+    UInt8 *bytes = YKFByteWriterReserveBytes(writer, sizeof(UInt16));
+    if (bytes) {
+        YKFStoreBigEndianUInt16(bytes, value);
+    }
+}
+
+static inline void YKFByteWriterWriteUInt32(YKFByteWriter *writer, UInt32 value) {
+    UInt8 *bytes = YKFByteWriterReserveBytes(writer, sizeof(UInt32));
+    if (bytes) {
+        YKFStoreBigEndianUInt32(bytes, value);
+    }
+}
+
+static inline void YKFByteWriterWriteUInt64(YKFByteWriter *writer, UInt64 value) {
+    UInt8 *bytes = YKFByteWriterReserveBytes(writer, sizeof(UInt64));
+    if (bytes) {
+        YKFStoreBigEndianUInt64(bytes, value);
+    }
+}
+
+/*
+ Writes the size (0 to 8) least significant bytes of value in big endian order.
+ */
+static inline void YKFByteWriterWriteBigEndian(YKFByteWriter *writer, UInt64 value, NSUInteger size) {
+    if (size > sizeof(UInt64)) {
+        writer->overflow = YES;
+        return;
+    }
+    UInt8 *bytes = YKFByteWriterReserveBytes(writer, size);
+    if (bytes) {
+        YKFStoreBigEndian(bytes, value, size);
+    }
+}
+
+NS_ASSUME_NONNULL_END
+
+#endif /* YKFByteSpan_h */
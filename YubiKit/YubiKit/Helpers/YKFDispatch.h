@@ -19,3 +19,30 @@ void ykf_dispatch_thread_sync(NSThread* thread, dispatch_block_t block);
 
 void ykf_dispatch_block_main(dispatch_block_t block);
 void ykf_dispatch_block_sync_main(dispatch_block_t block);
+
+/*
+ The monotonic clock used to time the commands, in nanoseconds. It is the clock of dispatch_time(DISPATCH_TIME_NOW, ...),
+ which keeps running at the same pace when the wall clock of the device is adjusted, unlike NSDate.
+ */
+uint64_t ykf_monotonic_time(void);
+
+/*
+ The time elapsed since a value of ykf_monotonic_time(), in seconds.
+ */
+NSTimeInterval ykf_elapsed_time_since(uint64_t startTime);
+
+/*
+ The dispatch deadline after the timeout, for waits on semaphores which are also signaled on cancellation.
+ */
+dispatch_time_t ykf_dispatch_deadline(NSTimeInterval timeout);
+
+/*
+ Runs the block after the delay on the underlying queue of the operation queue. Until then the block is kept in
+ delayedBlocks, so the connection controllers can cancel it with ykf_dispatch_cancel_delayed_blocks().
+ */
+void ykf_dispatch_after_cancellable(NSTimeInterval delay, NSOperationQueue *queue, NSMutableDictionary *delayedBlocks, dispatch_block_t block);
+
+/*
+ Cancels the blocks of delayedBlocks which did not run yet.
+ */
+void ykf_dispatch_cancel_delayed_blocks(NSMutableDictionary *delayedBlocks);
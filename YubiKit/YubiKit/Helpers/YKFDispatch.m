@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #import "YKFDispatch.h"
+#import <time.h>
 
 void ykf_dispatch_thread_async(NSThread* thread, dispatch_block_t block) {
     if ([NSThread currentThread] == thread) {
@@ -46,3 +47,48 @@ void ykf_dispatch_block_sync_main(dispatch_block_t block) {
         dispatch_sync(dispatch_get_main_queue(), block);
     }
 }
+
+uint64_t ykf_monotonic_time(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+NSTimeInterval ykf_elapsed_time_since(uint64_t startTime) {
+    uint64_t now = ykf_monotonic_time();
+    return now > startTime ? (NSTimeInterval)(now - startTime) / NSEC_PER_SEC : 0;
+}
+
+dispatch_time_t ykf_dispatch_deadline(NSTimeInterval timeout) {
+    if (timeout <= 0) {
+        return DISPATCH_TIME_NOW;
+    }
+    return dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC));
+}
+
+void ykf_dispatch_after_cancellable(NSTimeInterval delay, NSOperationQueue *queue, NSMutableDictionary *delayedBlocks, dispatch_block_t block) {
+    NSCParameterAssert(delayedBlocks && block);
+    
+    NSString *key = [NSUUID UUID].UUIDString;
+    __weak NSMutableDictionary *weakDelayedBlocks = delayedBlocks;
+    dispatch_block_t delayedBlock = dispatch_block_create(0, ^{
+        NSMutableDictionary *strongDelayedBlocks = weakDelayedBlocks;
+        @synchronized (strongDelayedBlocks) {
+            [strongDelayedBlocks removeObjectForKey:key];
+        }
+        block();
+    });
+    @synchronized (delayedBlocks) {
+        delayedBlocks[key] = delayedBlock;
+    }
+    
+    dispatch_queue_t dispatchQueue = queue.underlyingQueue ?: dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+    dispatch_after(ykf_dispatch_deadline(delay), dispatchQueue, delayedBlock);
+}
+
+void ykf_dispatch_cancel_delayed_blocks(NSMutableDictionary *delayedBlocks) {
+    @synchronized (delayedBlocks) {
+        for (dispatch_block_t block in delayedBlocks.allValues) {
+            dispatch_block_cancel(block);
+        }
+        [delayedBlocks removeAllObjects];
+    }
+}
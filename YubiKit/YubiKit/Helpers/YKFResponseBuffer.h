@@ -0,0 +1,71 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @abstract
+    Growable byte buffer used to reassemble a response which is received in parts.
+ 
+ @discussion
+    The caller reserves the space announced by the key before appending the next part, so the buffer is usually
+    allocated once with the final length. When the data is taken the bytes are handed over to the returned NSData,
+    without a copy, and the buffer is empty again.
+ */
+@interface YKFResponseBuffer: NSObject
+
+/*!
+ The number of bytes appended since the buffer was created or the data was taken.
+ */
+@property (nonatomic, readonly) NSUInteger length;
+
+/*!
+ The number of bytes which can be appended without reallocating the buffer.
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/*!
+ The appended bytes. Valid until the next change of the buffer.
+ */
+@property (nonatomic, readonly, nullable) const UInt8 *bytes;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/*!
+ Makes room for at least additionalLength bytes after the current length. The buffer grows at least by half of its
+ capacity to keep the number of reallocations low when the reserved lengths are small.
+ */
+- (void)reserveLength:(NSUInteger)additionalLength;
+
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length;
+
+- (void)appendData:(NSData *)data;
+
+/*!
+ Reads the bytes available in the stream directly after the current length, growing the buffer if it is full.
+ Returns the result of [NSInputStream read:maxLength:].
+ */
+- (NSInteger)appendBytesFromInputStream:(NSInputStream *)inputStream;
+
+/*!
+ Returns the appended bytes and empties the buffer. The unused capacity is released and the returned data takes
+ ownership of the allocated bytes.
+ */
+- (NSData *)takeData;
+
+@end
+
+NS_ASSUME_NONNULL_END
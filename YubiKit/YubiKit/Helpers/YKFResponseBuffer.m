@@ -0,0 +1,112 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFResponseBuffer.h"
+#import "YKFAssert.h"
+
+static NSUInteger const YKFResponseBufferMinimumReadLength = 512; // bytes
+
+@interface YKFResponseBuffer()
+
+@property (nonatomic, readwrite) NSUInteger length;
+@property (nonatomic, readwrite) NSUInteger capacity;
+
+@end
+
+@implementation YKFResponseBuffer {
+    UInt8 *buffer;
+}
+
+- (instancetype)init {
+    return [self initWithCapacity:0];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        [self reserveLength:capacity];
+    }
+    return self;
+}
+
+- (const UInt8 *)bytes {
+    return buffer;
+}
+
+- (void)dealloc {
+    free(buffer);
+}
+
+- (void)reserveLength:(NSUInteger)additionalLength {
+    NSUInteger requiredCapacity = self.length + additionalLength;
+    if (requiredCapacity <= self.capacity) {
+        return;
+    }
+    NSUInteger capacity = MAX(requiredCapacity, self.capacity + self.capacity / 2);
+    UInt8 *reallocatedBuffer = realloc(buffer, capacity);
+    YKFAssertReturn(reallocatedBuffer, @"Could not allocate the response buffer.");
+    buffer = reallocatedBuffer;
+    self.capacity = capacity;
+}
+
+- (void)appendBytes:(const void *)appendedBytes length:(NSUInteger)length {
+    if (!length) {
+        return;
+    }
+    [self reserveLength:length];
+    if (self.capacity - self.length < length) {
+        return;
+    }
+    memcpy(buffer + self.length, appendedBytes, length);
+    self.length += length;
+}
+
+- (void)appendData:(NSData *)data {
+    YKFParameterAssertReturn(data);
+    [self appendBytes:data.bytes length:data.length];
+}
+
+- (NSInteger)appendBytesFromInputStream:(NSInputStream *)inputStream {
+    YKFParameterAssertReturnValue(inputStream, -1);
+    if (self.length == self.capacity) {
+        [self reserveLength:YKFResponseBufferMinimumReadLength];
+    }
+    YKFAssertReturnValue(self.capacity > self.length, @"Could not allocate the response buffer.", -1);
+    
+    NSInteger bytesRead = [inputStream read:buffer + self.length maxLength:self.capacity - self.length];
+    if (bytesRead > 0) {
+        self.length += bytesRead;
+    }
+    return bytesRead;
+}
+
+- (NSData *)takeData {
+    if (!self.length) {
+        return [NSData data];
+    }
+    if (self.capacity > self.length) {
+        // Give back the unused capacity, the returned data and its slices may be kept for long.
+        UInt8 *reallocatedBuffer = realloc(buffer, self.length);
+        if (reallocatedBuffer) {
+            buffer = reallocatedBuffer;
+        }
+    }
+    NSData *data = [[NSData alloc] initWithBytesNoCopy:buffer length:self.length freeWhenDone:YES];
+    buffer = NULL;
+    self.length = 0;
+    self.capacity = 0;
+    return data;
+}
+
+@end
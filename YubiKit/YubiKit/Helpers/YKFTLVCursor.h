@@ -0,0 +1,83 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFTLVCursor_h
+#define YKFTLVCursor_h
+
+#import <Foundation/Foundation.h>
+#import "YKFTLVRecord.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ A BER-TLV record read by a cursor. The record is described by ranges in the buffer walked by the cursor,
+ so reading it does not copy any bytes.
+ */
+typedef struct {
+    /// Tag of the record.
+    YKFTLVTag tag;
+    /// Range of the value in the buffer. The location is NSNotFound for records which were not found.
+    NSRange valueRange;
+    /// Range of the encoded record (tag, length and value) in the buffer.
+    NSRange recordRange;
+} YKFTLVView;
+
+/*
+ Walks a sequence of BER-TLV records in a contiguous buffer. The data is not retained: it must be immutable
+ and must outlive the cursor.
+ */
+typedef struct {
+    __unsafe_unretained NSData *_Nullable data;
+    const UInt8 *_Nullable bytes;
+    NSUInteger offset;
+    NSUInteger end;
+    BOOL malformed;
+} YKFTLVCursor;
+
+/*
+ Creates a cursor over all the bytes of data.
+ */
+YKFTLVCursor YKFTLVCursorMake(NSData *_Nullable data);
+
+/*
+ Creates a cursor over the records nested in the value of a record read by another cursor (nested descent).
+ */
+YKFTLVCursor YKFTLVCursorMakeWithValue(const YKFTLVCursor *cursor, const YKFTLVView *view);
+
+/*
+ Reads the next record and advances the cursor past it. Returns NO at the end of the buffer or if the record
+ is malformed, in which case the cursor stops and YKFTLVCursorIsAtEnd returns NO.
+ */
+BOOL YKFTLVCursorNext(YKFTLVCursor *cursor, YKFTLVView *view);
+
+/*
+ Returns YES if all the records were read and none of them was malformed.
+ */
+BOOL YKFTLVCursorIsAtEnd(const YKFTLVCursor *cursor);
+
+/*
+ Reads all the remaining records and keeps the first record for each of the tags. views must have count elements;
+ the view at index i describes the record with tags[i] or has the valueRange.location NSNotFound if there is no such
+ record. Returns NO if a record is malformed.
+ */
+BOOL YKFTLVCursorReadTags(YKFTLVCursor *cursor, const YKFTLVTag *tags, NSUInteger count, YKFTLVView *views);
+
+/*
+ Returns the value of a record as a no-copy slice of the cursor data or nil if the record was not found.
+ */
+NSData *_Nullable YKFTLVCursorValue(const YKFTLVCursor *cursor, const YKFTLVView *view);
+
+NS_ASSUME_NONNULL_END
+
+#endif /* YKFTLVCursor_h */
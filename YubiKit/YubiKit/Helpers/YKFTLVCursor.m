@@ -0,0 +1,121 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFTLVCursor.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFByteSpan.h"
+
+YKFTLVCursor YKFTLVCursorMake(NSData *data) {
+    YKFTLVCursor cursor = {data, data.bytes, 0, data.length, NO};
+    return cursor;
+}
+
+YKFTLVCursor YKFTLVCursorMakeWithValue(const YKFTLVCursor *cursor, const YKFTLVView *view) {
+    YKFTLVCursor valueCursor = {cursor->data, cursor->bytes, view->valueRange.location, NSMaxRange(view->valueRange), NO};
+    if (view->valueRange.location == NSNotFound) {
+        valueCursor.offset = 0;
+        valueCursor.end = 0;
+    }
+    return valueCursor;
+}
+
+static BOOL YKFTLVCursorFail(YKFTLVCursor *cursor) {
+    cursor->malformed = YES;
+    return NO;
+}
+
+BOOL YKFTLVCursorNext(YKFTLVCursor *cursor, YKFTLVView *view) {
+    if (cursor->malformed || cursor->offset >= cursor->end) {
+        return NO;
+    }
+    
+    const UInt8 *bytes = cursor->bytes;
+    NSUInteger start = cursor->offset;
+    NSUInteger offset = start;
+    NSUInteger end = cursor->end;
+    
+    // tag
+    YKFTLVTag tag = bytes[offset++];
+    if ((tag & 0x1F) == 0x1F) {
+        // The subsequent tag bytes have bit 8 set, except the last one.
+        if (offset >= end) {
+            return YKFTLVCursorFail(cursor);
+        }
+        tag = (tag << 8) | bytes[offset++];
+        while ((tag & 0x80) == 0x80) {
+            if (offset >= end || offset - start >= sizeof(YKFTLVTag)) {
+                return YKFTLVCursorFail(cursor);
+            }
+            tag = (tag << 8) | bytes[offset++];
+        }
+    }
+    
+    // length
+    if (offset >= end) {
+        return YKFTLVCursorFail(cursor);
+    }
+    NSUInteger length = bytes[offset++];
+    if (length == 0x80) {
+        // Indefinite length is not supported.
+        return YKFTLVCursorFail(cursor);
+    } else if (length > 0x80) {
+        NSUInteger lengthOfLength = length - 0x80;
+        if (lengthOfLength > sizeof(length) || end - offset < lengthOfLength) {
+            return YKFTLVCursorFail(cursor);
+        }
+        length = (NSUInteger)YKFLoadBigEndian(bytes + offset, lengthOfLength);
+        offset += lengthOfLength;
+    }
+    
+    // value
+    if (end - offset < length) {
+        return YKFTLVCursorFail(cursor);
+    }
+    
+    view->tag = tag;
+    view->valueRange = NSMakeRange(offset, length);
+    view->recordRange = NSMakeRange(start, offset + length - start);
+    cursor->offset = offset + length;
+    return YES;
+}
+
+BOOL YKFTLVCursorIsAtEnd(const YKFTLVCursor *cursor) {
+    return !cursor->malformed && cursor->offset >= cursor->end;
+}
+
+BOOL YKFTLVCursorReadTags(YKFTLVCursor *cursor, const YKFTLVTag *tags, NSUInteger count, YKFTLVView *views) {
+    for (NSUInteger i = 0; i < count; ++i) {
+        views[i].tag = tags[i];
+        views[i].valueRange = NSMakeRange(NSNotFound, 0);
+        views[i].recordRange = NSMakeRange(NSNotFound, 0);
+    }
+    
+    YKFTLVView view;
+    while (YKFTLVCursorNext(cursor, &view)) {
+        for (NSUInteger i = 0; i < count; ++i) {
+            if (tags[i] == view.tag && views[i].valueRange.location == NSNotFound) {
+                views[i] = view;
+                break;
+            }
+        }
+    }
+    return YKFTLVCursorIsAtEnd(cursor);
+}
+
+NSData *YKFTLVCursorValue(const YKFTLVCursor *cursor, const YKFTLVView *view) {
+    if (view->valueRange.location == NSNotFound || !cursor->data) {
+        return nil;
+    }
+    return [cursor->data ykf_noCopySubdataWithRange:view->valueRange];
+}
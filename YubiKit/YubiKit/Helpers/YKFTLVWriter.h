@@ -0,0 +1,71 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFTLVWriter_h
+#define YKFTLVWriter_h
+
+#import <Foundation/Foundation.h>
+#import "YKFTLVRecord.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Writes BER-TLV records, including nested constructed records, into one growable buffer.
+ 
+ The length of a constructed record is not known when it is opened: the writer reserves the length bytes and patches
+ them when the record is closed. The encoding is the same as the one of YKFTLVRecord.data.
+ */
+@interface YKFTLVWriter : NSObject
+
+/*
+ The encoded records. The buffer is owned by the writer and must not be used after writing more records.
+ All the constructed records must be closed before reading it.
+ */
+@property (nonatomic, readonly) NSData *data;
+
+/*
+ Creates a writer. The capacity is a hint for the total length of the encoded records.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/*
+ Appends a record with a primitive value.
+ */
+- (void)appendTag:(YKFTLVTag)tag value:(NSData *)value;
+
+/*
+ Appends a record with a primitive value read from bytes.
+ */
+- (void)appendTag:(YKFTLVTag)tag bytes:(const void *_Nullable)bytes length:(NSUInteger)length;
+
+/*
+ Opens a constructed record. The records appended until the matching endConstructed are its value.
+ */
+- (void)beginConstructedWithTag:(YKFTLVTag)tag;
+
+/*
+ Closes the last opened constructed record and patches its length.
+ */
+- (void)endConstructed;
+
+/*
+ Not available: use [initWithCapacity:].
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* YKFTLVWriter_h */
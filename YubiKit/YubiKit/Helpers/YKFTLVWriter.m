@@ -0,0 +1,126 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFTLVWriter.h"
+#import "YKFAssert.h"
+#import "YKFByteSpan.h"
+
+/*
+ The length bytes reserved when a constructed record is opened: 0x82 followed by two bytes, which covers the
+ values up to 64 KB, so the containers of large values are patched in place. Shorter values move the content
+ down by at most two bytes.
+ */
+static const NSUInteger YKFTLVWriterReservedLengthBytes = 3;
+
+/*
+ The longest length: the length of length byte followed by the bytes of a NSUInteger.
+ */
+static const NSUInteger YKFTLVWriterMaxLengthBytes = 1 + sizeof(NSUInteger);
+
+/*
+ Writes the length in the shortest form and returns the number of bytes written.
+ */
+static NSUInteger YKFTLVWriterEncodeLength(UInt8 *buffer, NSUInteger length) {
+    if (length < 0x80) {
+        buffer[0] = (UInt8)length;
+        return 1;
+    }
+    NSUInteger size = YKFBigEndianLength(length);
+    buffer[0] = 0x80 | (UInt8)size;
+    YKFStoreBigEndian(buffer + 1, length, size);
+    return 1 + size;
+}
+
+@interface YKFTLVWriter()
+
+@property (nonatomic) NSMutableData *buffer;
+
+/*
+ The offsets of the reserved length bytes of the open constructed records.
+ */
+@property (nonatomic) NSMutableArray<NSNumber *> *openRecords;
+
+@end
+
+@implementation YKFTLVWriter
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        self.buffer = [[NSMutableData alloc] initWithCapacity:capacity];
+        self.openRecords = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (NSData *)data {
+    NSAssert(self.openRecords.count == 0, @"Reading TLV data with open constructed records.");
+    return self.buffer;
+}
+
+#pragma mark - Writing
+
+- (void)appendTag:(YKFTLVTag)tag value:(NSData *)value {
+    [self appendTag:tag bytes:value.bytes length:value.length];
+}
+
+- (void)appendTag:(YKFTLVTag)tag bytes:(const void *)bytes length:(NSUInteger)length {
+    [self appendTag:tag];
+    
+    UInt8 lengthBytes[YKFTLVWriterMaxLengthBytes];
+    [self.buffer appendBytes:lengthBytes length:YKFTLVWriterEncodeLength(lengthBytes, length)];
+    if (length) {
+        [self.buffer appendBytes:bytes length:length];
+    }
+}
+
+- (void)beginConstructedWithTag:(YKFTLVTag)tag {
+    [self appendTag:tag];
+    
+    [self.openRecords addObject:@(self.buffer.length)];
+    self.buffer.length += YKFTLVWriterReservedLengthBytes;
+}
+
+- (void)endConstructed {
+    YKFAssertReturn(self.openRecords.count > 0, @"No open constructed TLV record.");
+    
+    NSUInteger lengthOffset = self.openRecords.lastObject.unsignedIntegerValue;
+    [self.openRecords removeLastObject];
+    
+    NSUInteger valueLength = self.buffer.length - lengthOffset - YKFTLVWriterReservedLengthBytes;
+    UInt8 lengthBytes[YKFTLVWriterMaxLengthBytes];
+    NSUInteger lengthSize = YKFTLVWriterEncodeLength(lengthBytes, valueLength);
+    
+    NSRange reservedRange = NSMakeRange(lengthOffset, YKFTLVWriterReservedLengthBytes);
+    if (lengthSize == YKFTLVWriterReservedLengthBytes) {
+        [self.buffer replaceBytesInRange:reservedRange withBytes:lengthBytes];
+    } else {
+        // Moves the value when the length does not fit the reserved bytes exactly.
+        [self.buffer replaceBytesInRange:reservedRange withBytes:lengthBytes length:lengthSize];
+    }
+}
+
+#pragma mark - Helpers
+
+/*
+ Appends the tag bytes without the leading zero bytes, as YKFTLVRecord.data.
+ */
+- (void)appendTag:(YKFTLVTag)tag {
+    UInt8 tagBytes[sizeof(YKFTLVTag)];
+    NSUInteger size = YKFBigEndianLength(tag);
+    YKFStoreBigEndian(tagBytes, tag, size);
+    [self.buffer appendBytes:tagBytes length:size];
+}
+
+@end
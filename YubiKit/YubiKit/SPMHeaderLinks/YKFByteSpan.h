@@ -0,0 +1 @@
+../Helpers/YKFByteSpan.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/FIDO2/CBOR/YKFCBORDecoder+Private.h
\ No newline at end of file
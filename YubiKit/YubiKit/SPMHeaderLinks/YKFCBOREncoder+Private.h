@@ -0,0 +1 @@
+../Connections/Shared/Sessions/FIDO2/CBOR/YKFCBOREncoder+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/FIDO2/CBOR/YKFCBORMapSchema.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Helpers/YKFResponseBuffer.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Helpers/YKFTLVCursor.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Helpers/YKFTLVWriter.h
\ No newline at end of file
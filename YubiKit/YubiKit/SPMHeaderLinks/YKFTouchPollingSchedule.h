@@ -0,0 +1 @@
+../Connections/Shared/Sessions/YKFTouchPollingSchedule.h
\ No newline at end of file
@@ -46,6 +46,7 @@
 
 #import "YKFFeature.h"
 #import "YKFVersion.h"
+#import "YKFTouchPollingSchedule.h"
 
 #import "YKFU2FSession.h"
 #import "YKFFIDO2Session.h"
@@ -0,0 +1,33 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#import <Foundation/Foundation.h>
+
+/*
+ Output stream to memory which accepts at most maxChunkLength bytes per write, with a random length for every write.
+ The written data is available with NSStreamDataWrittenToMemoryStreamKey, as for a memory stream.
+ */
+@interface FakeChunkedOutputStream: NSOutputStream
+
+@property (nonatomic, readonly) NSUInteger maxChunkLength;
+
+/*
+ The number of calls to write:maxLength: which wrote data.
+ */
+@property (nonatomic, readonly) NSUInteger writeCount;
+
+- (instancetype)initWithMaxChunkLength:(NSUInteger)maxChunkLength;
+
+@end
@@ -0,0 +1,99 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#import "FakeChunkedOutputStream.h"
+
+@interface FakeChunkedOutputStream()
+
+@property (nonatomic, readwrite) NSUInteger maxChunkLength;
+@property (nonatomic, readwrite) NSUInteger writeCount;
+
+@property (nonatomic) NSMutableData *writtenData;
+@property (nonatomic) NSStreamStatus status;
+@property (nonatomic, weak) id<NSStreamDelegate> streamDelegate;
+
+@end
+
+@implementation FakeChunkedOutputStream
+
+- (instancetype)initWithMaxChunkLength:(NSUInteger)maxChunkLength {
+    self = [super init];
+    if (self) {
+        self.maxChunkLength = MAX(maxChunkLength, 1);
+        self.writtenData = [[NSMutableData alloc] init];
+        self.status = NSStreamStatusNotOpen;
+    }
+    return self;
+}
+
+#pragma mark - NSStream
+
+- (void)open {
+    self.status = NSStreamStatusOpen;
+}
+
+- (void)close {
+    self.status = NSStreamStatusClosed;
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.status;
+}
+
+- (id<NSStreamDelegate>)delegate {
+    return self.streamDelegate;
+}
+
+- (void)setDelegate:(id<NSStreamDelegate>)delegate {
+    self.streamDelegate = delegate;
+}
+
+- (NSError *)streamError {
+    return nil;
+}
+
+- (void)scheduleInRunLoop:(NSRunLoop *)aRunLoop forMode:(NSRunLoopMode)mode {
+    // The stream has always space available and does not send events.
+}
+
+- (void)removeFromRunLoop:(NSRunLoop *)aRunLoop forMode:(NSRunLoopMode)mode {
+}
+
+- (id)propertyForKey:(NSStreamPropertyKey)key {
+    if ([key isEqualToString:NSStreamDataWrittenToMemoryStreamKey]) {
+        return [self.writtenData copy];
+    }
+    return nil;
+}
+
+#pragma mark - NSOutputStream
+
+- (BOOL)hasSpaceAvailable {
+    return self.status == NSStreamStatusOpen;
+}
+
+- (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)len {
+    if (self.status != NSStreamStatusOpen) {
+        return -1;
+    }
+    NSUInteger chunkLength = MIN(len, 1 + arc4random_uniform((UInt32)self.maxChunkLength));
+    [self.writtenData appendBytes:buffer length:chunkLength];
+    if (chunkLength) {
+        self.writeCount += 1;
+    }
+    return chunkLength;
+}
+
+@end
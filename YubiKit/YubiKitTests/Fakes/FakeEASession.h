@@ -18,6 +18,7 @@
 @interface FakeEASession: NSObject<YKFEASessionProtocol>
 
 - (instancetype)initWithInputData:(NSData *)inputData accessory:(id<YKFEAAccessoryProtocol>)accessory protocol:(NSString *)protocol;
+- (instancetype)initWithInputData:(NSData *)inputData outputStream:(NSOutputStream *)outputStream accessory:(id<YKFEAAccessoryProtocol>)accessory protocol:(NSString *)protocol;
 - (NSData *)outputStreamData;
 
 @end
@@ -26,10 +26,14 @@
 @implementation FakeEASession
 
 - (instancetype)initWithInputData:(NSData *)inputData accessory:(id<YKFEAAccessoryProtocol>)accessory protocol:(NSString *)protocol {
+    return [self initWithInputData:inputData outputStream:[[NSOutputStream alloc] initToMemory] accessory:accessory protocol:protocol];
+}
+
+- (instancetype)initWithInputData:(NSData *)inputData outputStream:(NSOutputStream *)outputStream accessory:(id<YKFEAAccessoryProtocol>)accessory protocol:(NSString *)protocol {
     self = [super init];
     if (self) {
         self.inputStream = [[NSInputStream alloc] initWithData:inputData];
-        self.outputStream = [[NSOutputStream alloc] initToMemory];
+        self.outputStream = outputStream;
         
         self.accessory = accessory;
         self.protocolString = protocol;
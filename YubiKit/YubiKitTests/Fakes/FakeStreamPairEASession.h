@@ -0,0 +1,38 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#import <Foundation/Foundation.h>
+#import "EASession+Testing.h"
+
+/*
+ Session with real bound stream pairs, answered by a simulated key which runs on its own thread. The key reads
+ every command written to the output stream and, after the configured latency, writes the next response to the
+ input stream. The last response is repeated when there are more commands than responses.
+ 
+ A response is the data of one frame or an array with the data of several frames (e.g. busy frames followed by the
+ response frame), which are written one after the other with the latency before each of them.
+ */
+@interface FakeStreamPairEASession: NSObject<YKFEASessionProtocol>
+
+@property (atomic, readonly) NSUInteger commandCount;
+
+/*
+ When not 0 the responses are written in chunks of this length, with the latency before every chunk.
+ */
+@property (atomic, assign) NSUInteger responseChunkLength;
+
+- (instancetype)initWithResponses:(NSArray *)responses latency:(NSTimeInterval)latency;
+
+@end
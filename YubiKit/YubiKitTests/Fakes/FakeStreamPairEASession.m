@@ -0,0 +1,112 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#import "FakeStreamPairEASession.h"
+
+static NSUInteger const FakeStreamPairEASessionBufferSize = 65536;
+
+@interface FakeStreamPairEASession()
+
+@property (nonatomic, readwrite) id<YKFEAAccessoryProtocol> accessory;
+@property (nonatomic, readwrite) NSString *protocolString;
+@property (nonatomic, readwrite) NSInputStream *inputStream;
+@property (nonatomic, readwrite) NSOutputStream *outputStream;
+
+@property (atomic, readwrite) NSUInteger commandCount;
+
+@property (nonatomic) NSArray *responses;
+@property (nonatomic) NSTimeInterval latency;
+
+// The key side of the stream pairs.
+@property (nonatomic) NSInputStream *keyInputStream;
+@property (nonatomic) NSOutputStream *keyOutputStream;
+
+@end
+
+@implementation FakeStreamPairEASession
+
+- (instancetype)initWithResponses:(NSArray *)responses latency:(NSTimeInterval)latency {
+    self = [super init];
+    if (self) {
+        self.responses = responses;
+        self.latency = latency;
+        self.protocolString = @"YLP";
+        
+        CFReadStreamRef readStream = NULL;
+        CFWriteStreamRef writeStream = NULL;
+        
+        CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, FakeStreamPairEASessionBufferSize);
+        self.keyInputStream = CFBridgingRelease(readStream);
+        self.outputStream = CFBridgingRelease(writeStream);
+        
+        CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, FakeStreamPairEASessionBufferSize);
+        self.inputStream = CFBridgingRelease(readStream);
+        self.keyOutputStream = CFBridgingRelease(writeStream);
+        
+        // The thread keeps the session alive until the output stream is closed.
+        [NSThread detachNewThreadSelector:@selector(keyThreadExecution) toTarget:self withObject:nil];
+    }
+    return self;
+}
+
+- (void)keyThreadExecution {
+    [self.keyInputStream open];
+    [self.keyOutputStream open];
+    
+    UInt8 *buffer = malloc(FakeStreamPairEASessionBufferSize);
+    while (YES) {
+        // Blocks until the next command or until the output stream is closed.
+        NSInteger commandLength = [self.keyInputStream read:buffer maxLength:FakeStreamPairEASessionBufferSize];
+        if (commandLength <= 0) {
+            break;
+        }
+        
+        NSUInteger index = MIN(self.commandCount, self.responses.count - 1);
+        self.commandCount += 1;
+        
+        id response = self.responses[index];
+        NSArray<NSData *> *frames = [response isKindOfClass:[NSArray class]] ? response : @[response];
+        for (NSData *frame in frames) {
+            if (![self writeFrame:frame]) {
+                break;
+            }
+        }
+    }
+    free(buffer);
+    
+    [self.keyInputStream close];
+    [self.keyOutputStream close];
+}
+
+- (BOOL)writeFrame:(NSData *)frame {
+    NSUInteger chunkLength = self.responseChunkLength ? self.responseChunkLength : frame.length;
+    NSUInteger offset = 0;
+    while (offset < frame.length) {
+        if (self.latency > 0) {
+            [NSThread sleepForTimeInterval:self.latency];
+        }
+        NSUInteger chunkEnd = MIN(offset + chunkLength, frame.length);
+        while (offset < chunkEnd) {
+            NSInteger bytesWritten = [self.keyOutputStream write:(const UInt8 *)frame.bytes + offset maxLength:chunkEnd - offset];
+            if (bytesWritten <= 0) {
+                return NO; // The stream was closed.
+            }
+            offset += bytesWritten;
+        }
+    }
+    return YES;
+}
+
+@end
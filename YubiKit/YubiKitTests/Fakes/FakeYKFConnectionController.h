@@ -18,6 +18,10 @@
 @interface FakeYKFConnectionController: NSObject<YKFConnectionControllerProtocol>
 
 @property (nonatomic) YKFAPDU *executionCommand;
+@property (nonatomic, readonly) NSArray<YKFAPDU *> *executionCommandSequence;
+
+// The delays of the blocks dispatched with [dispatchBlockOnCommunicationQueue:delay:], in order.
+@property (nonatomic, readonly) NSArray<NSNumber *> *dispatchDelays;
 
 @property (nonatomic) YKFConnectionControllerCommandResponseBlock commandResponseBlock;
 @property (nonatomic) YKFConnectionControllerCompletionBlock operationExecutionBlock;
@@ -27,4 +31,7 @@
 @property (nonatomic) NSArray *commandExecutionResponseDataSequence;
 @property (nonatomic) NSArray *commandExecutionResponseErrorSequence;
 
+@property (nonatomic, readwrite) NSUInteger commandChainingBlockSize;
+@property (nonatomic, readwrite) BOOL supportsExtendedLength;
+
 @end
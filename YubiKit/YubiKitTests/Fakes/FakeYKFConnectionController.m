@@ -13,15 +13,38 @@
 // limitations under the License.
 
 #import "FakeYKFConnectionController.h"
+#import "YKFNSDataAdditions+Private.h"
 
 @interface FakeYKFConnectionController()
 
 @property (nonatomic, assign) NSUInteger commandExecutionSequenceIndex;
+@property (nonatomic) NSMutableArray<YKFAPDU *> *executedCommands;
+@property (nonatomic) NSMutableArray<NSNumber *> *delays;
 
 @end
 
 @implementation FakeYKFConnectionController
 
+@synthesize commandChainingEnabled;
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.executedCommands = [[NSMutableArray alloc] init];
+        self.delays = [[NSMutableArray alloc] init];
+        self.commandChainingBlockSize = 255;
+    }
+    return self;
+}
+
+- (NSArray<YKFAPDU *> *)executionCommandSequence {
+    return [self.executedCommands copy];
+}
+
+- (NSArray<NSNumber *> *)dispatchDelays {
+    return [self.delays copy];
+}
+
 - (void)setCommandExecutionResponseDataSequence:(NSArray *)commandExecutionResponseDataSequence {
     _commandExecutionResponseDataSequence = commandExecutionResponseDataSequence;
     self.commandExecutionSequenceIndex = 0;
@@ -36,6 +59,7 @@
 
 - (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion {
     self.executionCommand = command;
+    [self.executedCommands addObject:command];
     self.commandResponseBlock = completion;
     
     NSData *responseData = [self nextResponseDataInSequence];
@@ -50,6 +74,7 @@
 
 - (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion {
     self.executionCommand = command;
+    [self.executedCommands addObject:command];
     self.commandResponseBlock = completion;
     
     NSData *responseData = [self nextResponseDataInSequence];
@@ -62,6 +87,38 @@
     ++self.commandExecutionSequenceIndex;
 }
 
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    [self executeBatch:commands timeout:0 completion:completion];
+}
+
+- (void)executeBatch:(NSArray<YKFAPDU *> *)commands timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerBatchResponseBlock)completion {
+    NSMutableArray<NSData *> *responses = [[NSMutableArray alloc] init];
+    NSError *responseError = nil;
+    
+    for (YKFAPDU *command in commands) {
+        self.executionCommand = command;
+        [self.executedCommands addObject:command];
+        
+        NSData *responseData = [self nextResponseDataInSequence];
+        responseError = [self nextResponseErrorInSequence];
+        ++self.commandExecutionSequenceIndex;
+        
+        if (responseError || !responseData) {
+            break;
+        }
+        [responses addObject:responseData];
+        
+        // Stop on the first status other than 0x9000, like the connection controllers.
+        if (![responseData ykf_isSuccessfulAPDUResponse]) {
+            break;
+        }
+    }
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        completion(responses, responseError, 0);
+    });
+}
+
 - (void)dispatchOnSequentialQueue:(YKFConnectionControllerCompletionBlock)block delay:(NSTimeInterval)delay {
     self.operationExecutionBlock = block;
     
@@ -94,6 +151,14 @@
     // Do nothing
 }
 
+- (void)dispatchBlockOnCommunicationQueue:(nonnull YKFConnectionControllerCommunicationQueueBlock)block delay:(NSTimeInterval)delay {
+    [self.delays addObject:@(delay)];
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        block([[NSOperation alloc] init]);
+    });
+}
+
 #pragma mark - Helpers
 
 - (NSData *)nextResponseDataInSequence {
@@ -115,7 +180,7 @@
         return self.commandExecutionResponseErrorSequence[self.commandExecutionSequenceIndex];
     }
 
-    return self.commandExecutionResponseErrorSequence[self.commandExecutionSequenceIndex];
+    return nil;
 }
 
 @end
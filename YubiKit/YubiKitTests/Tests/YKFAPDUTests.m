@@ -0,0 +1,102 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFAPDU.h"
+#import "YKFAPDU+Private.h"
+#import "YKFManagementWriteAPDU.h"
+#import "YKFManagementInterfaceConfiguration+Private.h"
+#import "YKFManagementDeviceInfo+Private.h"
+#import "YKFTLVRecord.h"
+
+@interface YKFAPDUTests: YKFTestCase
+@end
+
+@implementation YKFAPDUTests
+
+- (void)test_WhenShortAPDUIsCreated_HeaderLcAndDataAreEncoded {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a000000308"] type:YKFAPDUTypeShort];
+    XCTAssertEqualObjects(apdu.apduData, [NSData dataFromHexString:@"00a40400 05 a000000308"]);
+    XCTAssertEqualObjects(apdu.ylpApduData, [NSData dataFromHexString:@"00 00a40400 05 a000000308"]);
+    XCTAssertEqualObjects(apdu.commandData, [NSData dataFromHexString:@"a000000308"]);
+}
+
+- (void)test_WhenShortAPDUHasNoData_OnlyTheHeaderIsEncoded {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xf8 p1:0x00 p2:0x00 data:[NSData data] type:YKFAPDUTypeShort];
+    XCTAssertEqualObjects(apdu.apduData, [NSData dataFromHexString:@"00f80000"]);
+    XCTAssertEqualObjects(apdu.ylpApduData, [NSData dataFromHexString:@"00 00f80000"]);
+    XCTAssertEqual(apdu.commandData.length, 0);
+}
+
+- (void)test_WhenExtendedAPDUIsCreated_LcIsEncodedOnThreeBytes {
+    NSMutableData *data = [NSMutableData dataWithLength:0x123];
+    ((UInt8 *)data.mutableBytes)[0] = 0xaa;
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xdb p1:0x3f p2:0xff data:data type:YKFAPDUTypeExtended];
+    
+    NSMutableData *expected = [[NSData dataFromHexString:@"00db3fff 000123"] mutableCopy];
+    [expected appendData:data];
+    XCTAssertEqualObjects(apdu.apduData, expected);
+    XCTAssertEqual(apdu.ylpApduData.length, expected.length + 1);
+    XCTAssertEqualObjects([apdu.ylpApduData subdataWithRange:NSMakeRange(1, expected.length)], expected);
+    XCTAssertEqualObjects(apdu.commandData, data);
+}
+
+- (void)test_WhenExtendedAPDUHasNoData_ExtendedLeIsEncoded {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0x03 p1:0x00 p2:0x00 data:[NSData data] type:YKFAPDUTypeExtended];
+    XCTAssertEqualObjects(apdu.apduData, [NSData dataFromHexString:@"00030000 000000"]);
+    XCTAssertEqualObjects(apdu.ylpApduData, [NSData dataFromHexString:@"00 00030000 000000"]);
+}
+
+- (void)test_WhenExtendedAPDUAsksForTheWholeResponse_MaximumLeIsEncoded {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initExtendedWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"]];
+    XCTAssertEqualObjects(apdu.apduData, [NSData dataFromHexString:@"00cb3fff 000005 5c035fc105 0000"]);
+    XCTAssertEqualObjects(apdu.commandData, [NSData dataFromHexString:@"5c035fc105"]);
+    
+    YKFAPDU *apduWithoutData = [[YKFAPDU alloc] initExtendedWithCla:0x00 ins:0xfd p1:0x00 p2:0x00 data:[NSData data]];
+    XCTAssertEqualObjects(apduWithoutData.apduData, [NSData dataFromHexString:@"00fd0000 000000"]);
+}
+
+- (void)test_WhenExtendedAPDUIsCreated_YLPAndAPDUViewsShareOneBuffer {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xdb p1:0x3f p2:0xff data:[NSMutableData dataWithLength:1000] type:YKFAPDUTypeExtended];
+    const UInt8 *ylpBytes = apdu.ylpApduData.bytes;
+    XCTAssertEqual((const UInt8 *)apdu.apduData.bytes, ylpBytes + 1);
+    XCTAssertEqual((const UInt8 *)apdu.commandData.bytes, ylpBytes + 1 + 7);
+}
+
+- (void)test_WhenAPDUIsCreatedFromData_DataIsUsedAsIs {
+    NSData *data = [NSData dataFromHexString:@"00a4040008a000000527471117"];
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithData:data];
+    XCTAssertEqualObjects(apdu.apduData, data);
+    XCTAssertEqualObjects(apdu.ylpApduData, [NSData dataFromHexString:@"00 00a4040008a000000527471117"]);
+    XCTAssertNil(apdu.commandData);
+}
+
+- (void)test_WhenManagementConfigurationIsWritten_ShortValuesAreBigEndian {
+    NSMutableArray<YKFTLVRecord *> *records = [@[[[YKFTLVRecord alloc] initWithTag:YKFManagementTagUSBSupported value:[NSData dataFromHexString:@"023b"]],
+                                                 [[YKFTLVRecord alloc] initWithTag:YKFManagementTagNFCSupported value:[NSData dataFromHexString:@"023b"]]] mutableCopy];
+    YKFManagementInterfaceConfiguration *configuration = [[YKFManagementInterfaceConfiguration alloc] initWithTLVRecords:records];
+    [configuration setEnabled:YES application:YKFManagementApplicationTypeCTAP2 overTransport:YKFManagementTransportTypeUSB];
+    [configuration setEnabled:YES application:YKFManagementApplicationTypeOTP overTransport:YKFManagementTransportTypeNFC];
+    [configuration setEnabled:YES application:YKFManagementApplicationTypeOATH overTransport:YKFManagementTransportTypeNFC];
+    configuration.isNFCRestricted = YES;
+    
+    YKFManagementWriteAPDU *apdu = [[YKFManagementWriteAPDU alloc] initWithConfiguration:configuration reboot:NO lockCode:nil newLockCode:nil];
+    
+    // USB enabled 0x0200, NFC enabled 0x0021, NFC restricted 1.
+    XCTAssertEqualObjects(apdu.apduData, [NSData dataFromHexString:@"001c0000 0d 0c 03020200 0e020021 17020001"]);
+}
+
+@end
@@ -17,7 +17,10 @@
 #import "YKFTestCase.h"
 #import "YKFAccessoryConnectionController.h"
 #import "FakeEASession.h"
+#import "FakeStreamPairEASession.h"
+#import "FakeChunkedOutputStream.h"
 #import "YKFAPDU+Private.h"
+#import "YKFSessionError.h"
 
 @interface YKFAccessoryConnectionControllerTests: YKFTestCase
 
@@ -147,6 +150,48 @@
     XCTAssert([response isEqualToData:[inputData subdataWithRange:NSMakeRange(1, 2)]], @"Response data doesn't match the input data.");
 }
 
+#pragma mark - Partial Writes
+
+- (void)writeCommand:(YKFAPDU *)command maxChunkLength:(NSUInteger)maxChunkLength {
+    NSData *inputData = [NSData dataFromHexString:@"00 9000"];
+    FakeChunkedOutputStream *outputStream = [[FakeChunkedOutputStream alloc] initWithMaxChunkLength:maxChunkLength];
+    self.eaSession = [[FakeEASession alloc] initWithInputData:inputData outputStream:outputStream accessory:nil protocol:@"YLP"];
+    
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:self.eaSession operationQueue:self.operationQueue];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    XCTAssertEqualObjects([self.eaSession outputStreamData], command.ylpApduData, @"Command data doesn't match written data.");
+    XCTAssertGreaterThan(outputStream.writeCount, 1);
+    
+    [self closeConnectionController:connectionController];
+}
+
+- (void)test_WhenTheOutputStreamAcceptsPartialWrites_TheWholeCommandIsWritten {
+    NSMutableData *data = [NSMutableData dataWithLength:4096];
+    UInt8 *bytes = data.mutableBytes;
+    for (NSUInteger i = 0; i < data.length; ++i) {
+        bytes[i] = (UInt8)(i * 31 + 7);
+    }
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xdb p1:0x3f p2:0xff data:data type:YKFAPDUTypeExtended];
+    
+    [self writeCommand:command maxChunkLength:7];
+}
+
+- (void)test_WhenTheOutputStreamAcceptsSmallChunks_LargeCommandsAreWrittenInLinearTime {
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xdb p1:0x3f p2:0xff data:[NSMutableData dataWithLength:65535] type:YKFAPDUTypeExtended];
+    
+    [self measureBlock:^{
+        [self writeCommand:command maxChunkLength:16];
+    }];
+}
+
 #pragma mark - Delayed Responses
 
 - (void)test_WhenConnectionControllerReadsDelayedResponse_ControllerWaitsForResult {
@@ -174,4 +219,308 @@
     XCTAssert(result == XCTWaiterResultTimedOut); // The result should time out because the key didn't reply to the request.
 }
 
+#pragma mark - Latency
+
+- (void)closeConnectionController:(YKFAccessoryConnectionController *)connectionController {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Close key connection controller completion"];
+    [connectionController closeConnectionWithCompletion:^{
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:1];
+    XCTAssert(result == XCTWaiterResultCompleted);
+}
+
+- (void)test_WhenTheKeyRespondsWithLatency_EveryCommandGetsItsResponse {
+    NSTimeInterval latency = 0.005;
+    NSUInteger commandCount = 10;
+    
+    NSData *response = [NSData dataFromHexString:@"00 9000"];
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[response] latency:latency];
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a0000005272101"] type:YKFAPDUTypeShort];
+    
+    __block NSUInteger completedCommandCount = 0;
+    [self measureBlock:^{
+        XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+        expectation.expectedFulfillmentCount = commandCount;
+        for (NSUInteger i = 0; i < commandCount; ++i) {
+            [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+                XCTAssertNil(error);
+                XCTAssertEqualObjects(result, [NSData dataFromHexString:@"9000"]);
+                completedCommandCount += 1;
+                [expectation fulfill];
+            }];
+        }
+        XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+        XCTAssert(result == XCTWaiterResultCompleted);
+    }];
+    
+    // The time per command is reported by the measurement, the key received each command exactly once.
+    XCTAssertGreaterThan(completedCommandCount, 0);
+    XCTAssertEqual(completedCommandCount, session.commandCount);
+    
+    [self closeConnectionController:connectionController];
+}
+
+#pragma mark - Deadlines
+
+- (void)test_WhenTheKeyRespondsAfterTheTimeout_CommandFailsAtTheDeadline {
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[[NSData dataFromHexString:@"00 9000"]] latency:1.0];
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a0000005272101"] type:YKFAPDUTypeShort];
+    
+    __block NSError *commandError = nil;
+    __block NSTimeInterval commandExecutionTime = 0;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    [connectionController execute:command timeout:0.3 completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(result);
+        commandError = error;
+        commandExecutionTime = executionTime;
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    // The key responds after 1 second, a command which waited past its deadline would get the response.
+    XCTAssertEqual(commandError.code, YKFSessionErrorReadTimeoutCode);
+    XCTAssertGreaterThanOrEqual(commandExecutionTime, 0.3);
+    
+    [self closeConnectionController:connectionController];
+}
+
+- (void)test_WhenTheCommandsAreCancelled_WaitingCommandReleasesTheQueueRightAway {
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[[NSData dataFromHexString:@"00 9000"]] latency:5.0];
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a0000005272101"] type:YKFAPDUTypeShort];
+    
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTFail(@"The cancelled command notified its completion.");
+    }];
+    [self waitForTimeInterval:0.2];
+    
+    [connectionController cancelAllCommands];
+    
+    // The key responds after 5 seconds, the queue is released long before.
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Communication queue released."];
+    [connectionController dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:2.5];
+    XCTAssert(result == XCTWaiterResultCompleted, @"The cancelled command kept waiting for the key.");
+    XCTAssertEqual(session.commandCount, 1);
+    
+    [self closeConnectionController:connectionController];
+}
+
+- (void)test_WhenACommandIsCancelled_ItsLateResponseIsNotReadByTheNextCommand {
+    NSArray *responses = @[[NSData dataFromHexString:@"00 6a82"], [NSData dataFromHexString:@"00 0102 9000"]];
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:responses latency:0.3];
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a0000005272101"] type:YKFAPDUTypeShort];
+    
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTFail(@"The cancelled command notified its completion.");
+    }];
+    [self waitForTimeInterval:0.1];
+    [connectionController cancelAllCommands];
+    
+    __block NSData *response = nil;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        response = result;
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    XCTAssertEqualObjects(response, [NSData dataFromHexString:@"0102 9000"]);
+    XCTAssertEqual(session.commandCount, 2);
+    
+    [self closeConnectionController:connectionController];
+}
+
+- (void)test_WhenACommandIsCancelledDuringAPartialFrame_TheConnectionRecovers {
+    // The response of the first command is delivered in two parts: its header, then the status code.
+    NSArray *responses = @[@[[NSData dataFromHexString:@"00"], [NSData dataFromHexString:@"6a82"]], [NSData dataFromHexString:@"00 0102 9000"]];
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:responses latency:0.3];
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a0000005272101"] type:YKFAPDUTypeShort];
+    
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTFail(@"The cancelled command notified its completion.");
+    }];
+    // Cancel after the header was read by the command and before the status code arrives.
+    [self waitForTimeInterval:0.45];
+    [connectionController cancelAllCommands];
+    
+    // The rest of the frame has no header, so it cannot be discarded as a frame and fails the next command.
+    __block NSError *discardError = nil;
+    XCTestExpectation *failedExpectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution failure."];
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(result);
+        discardError = error;
+        [failedExpectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[failedExpectation] timeout:5];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    XCTAssertNotNil(discardError);
+    
+    // The dropped bytes are not expected again: the following command is sent and gets its response.
+    __block NSData *response = nil;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    [connectionController execute:command timeout:5 completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        response = result;
+        [expectation fulfill];
+    }];
+    result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    XCTAssertEqualObjects(response, [NSData dataFromHexString:@"0102 9000"]);
+    XCTAssertEqual(session.commandCount, 2);
+    
+    [self closeConnectionController:connectionController];
+}
+
+#pragma mark - Response Framing
+
+- (NSData *)executeCommand:(YKFAPDU *)command session:(FakeStreamPairEASession *)session {
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    
+    __block NSData *response = nil;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        response = result;
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    [self closeConnectionController:connectionController];
+    return response;
+}
+
+- (void)test_WhenTheResponseArrivesInParts_TheWholeFrameIsRead {
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[[NSData dataFromHexString:@"00 9000"]] latency:0.02];
+    session.responseChunkLength = 1;
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a0000005272101"] type:YKFAPDUTypeShort];
+    
+    NSData *response = [self executeCommand:command session:session];
+    XCTAssertEqualObjects(response, [NSData dataFromHexString:@"9000"]);
+}
+
+- (void)test_WhenTheResponseIsLarge_TheDataIsReadInOneBuffer {
+    NSMutableData *frame = [NSMutableData dataWithLength:1 + 5000];
+    UInt8 *bytes = frame.mutableBytes;
+    for (NSUInteger i = 1; i < frame.length; ++i) {
+        bytes[i] = (UInt8)i;
+    }
+    [frame appendData:[NSData dataFromHexString:@"9000"]];
+    
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[frame] latency:0];
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeExtended];
+    
+    NSData *response = [self executeCommand:command session:session];
+    XCTAssertEqualObjects(response, [frame subdataWithRange:NSMakeRange(1, frame.length - 1)]);
+}
+
+- (void)test_WhenTheLargeResponseArrivesInParts_TheWholeFrameIsRead {
+    NSMutableData *frame = [NSMutableData dataWithLength:1 + 5000];
+    UInt8 *bytes = frame.mutableBytes;
+    for (NSUInteger i = 1; i < frame.length; ++i) {
+        bytes[i] = (UInt8)i;
+    }
+    [frame appendData:[NSData dataFromHexString:@"9000"]];
+    
+    // The stream runs dry after each part, long before the end of the frame.
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[frame] latency:0.001];
+    session.responseChunkLength = 100;
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeExtended];
+    
+    NSData *response = [self executeCommand:command session:session];
+    XCTAssertEqualObjects(response, [frame subdataWithRange:NSMakeRange(1, frame.length - 1)]);
+}
+
+#pragma mark - Busy Frames
+
+- (void)test_WhenTheKeyIsBusy_ControllerWaitsForTheAnnouncedFramesAndCountsThem {
+    // Two busy frames announcing 50 ms (0x000032) before the response.
+    NSArray *frames = @[[NSData dataFromHexString:@"01 000032"], [NSData dataFromHexString:@"01 000032"], [NSData dataFromHexString:@"00 9000"]];
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[frames] latency:0.05];
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0x47 p1:0x00 p2:0x9a data:[NSData dataFromHexString:@"ac03800107"] type:YKFAPDUTypeShort];
+    
+    __block NSData *response = nil;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        response = result;
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    XCTAssertEqualObjects(response, [NSData dataFromHexString:@"9000"]);
+    XCTAssertEqual(connectionController.lastCommandBusyFrameCount, 2);
+    
+    [self closeConnectionController:connectionController];
+}
+
+- (void)test_WhenTheBusyFrameArrivesInParts_TheWholeWTXIsRead {
+    // The busy frame is split after its third byte, which is also the length of the shortest response frame.
+    NSArray *frames = @[[NSData dataFromHexString:@"01 000032"], [NSData dataFromHexString:@"00 9000"]];
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:@[frames] latency:0.05];
+    session.responseChunkLength = 3;
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    
+    YKFAPDU *command = [[YKFAPDU alloc] initWithCla:0x00 ins:0x47 p1:0x00 p2:0x9a data:[NSData dataFromHexString:@"ac03800107"] type:YKFAPDUTypeShort];
+    
+    __block NSData *response = nil;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    [connectionController execute:command completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        response = result;
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    XCTAssertEqualObjects(response, [NSData dataFromHexString:@"9000"]);
+    XCTAssertEqual(connectionController.lastCommandBusyFrameCount, 1);
+    
+    [self closeConnectionController:connectionController];
+}
+
+#pragma mark - Batches
+
+- (void)test_WhenExecutingBatch_CommandsAreExecutedUntilTheFirstFailedStatus {
+    NSArray *responses = @[[NSData dataFromHexString:@"00 9000"], [NSData dataFromHexString:@"00 63c2"], [NSData dataFromHexString:@"00 9000"]];
+    FakeStreamPairEASession *session = [[FakeStreamPairEASession alloc] initWithResponses:responses latency:0];
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:session operationQueue:self.operationQueue];
+    
+    YKFAPDU *selectCommand = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa4 p1:0x04 p2:0x00 data:[NSData dataFromHexString:@"a000000308"] type:YKFAPDUTypeShort];
+    YKFAPDU *verifyCommand = [[YKFAPDU alloc] initWithCla:0x00 ins:0x20 p1:0x00 p2:0x80 data:[NSData dataFromHexString:@"313233343536ffff"] type:YKFAPDUTypeShort];
+    YKFAPDU *signCommand = [[YKFAPDU alloc] initWithCla:0x00 ins:0x87 p1:0x11 p2:0x9a data:[NSData dataFromHexString:@"7c0482008100"] type:YKFAPDUTypeShort];
+    
+    __block NSArray<NSData *> *batchResponses = nil;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Batch execution completion."];
+    [connectionController executeBatch:@[selectCommand, verifyCommand, signCommand] completion:^(NSArray<NSData *> *results, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        batchResponses = results;
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted);
+    
+    NSArray *expectedResponses = @[[NSData dataFromHexString:@"9000"], [NSData dataFromHexString:@"63c2"]];
+    XCTAssertEqualObjects(batchResponses, expectedResponses);
+    XCTAssertEqual(session.commandCount, 2, @"The commands after the failed status were sent to the key.");
+    
+    [self closeConnectionController:connectionController];
+}
+
 @end
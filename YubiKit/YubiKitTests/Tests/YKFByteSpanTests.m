@@ -0,0 +1,196 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFByteSpan.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFNSMutableDataAdditions.h"
+
+@interface YKFByteSpanTests: YKFTestCase
+@end
+
+@implementation YKFByteSpanTests
+
+#pragma mark - Loads and stores
+
+- (void)test_unalignedLoads {
+    UInt8 bytes[] = {0xff, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    
+    // Offset 1 is not aligned for any of the integer types.
+    XCTAssertEqual(YKFLoadBigEndianUInt16(bytes + 1), 0x0102);
+    XCTAssertEqual(YKFLoadBigEndianUInt32(bytes + 1), 0x01020304);
+    XCTAssertEqual(YKFLoadBigEndianUInt64(bytes + 1), 0x0102030405060708);
+    XCTAssertEqual(YKFLoadBigEndian(bytes + 1, 0), 0);
+    XCTAssertEqual(YKFLoadBigEndian(bytes + 1, 3), 0x010203);
+    XCTAssertEqual(YKFLoadBigEndian(bytes, 8), 0xff01020304050607);
+}
+
+- (void)test_unalignedStores {
+    UInt8 bytes[9] = {0};
+    
+    YKFStoreBigEndianUInt16(bytes + 1, 0x0102);
+    XCTAssertEqualObjects([NSData dataWithBytes:bytes length:sizeof(bytes)], [NSData dataFromHexString:@"00 0102 000000000000"]);
+    
+    YKFStoreBigEndianUInt32(bytes + 1, 0x01020304);
+    XCTAssertEqualObjects([NSData dataWithBytes:bytes length:sizeof(bytes)], [NSData dataFromHexString:@"00 01020304 00000000"]);
+    
+    YKFStoreBigEndianUInt64(bytes + 1, 0x0102030405060708);
+    XCTAssertEqualObjects([NSData dataWithBytes:bytes length:sizeof(bytes)], [NSData dataFromHexString:@"00 0102030405060708"]);
+    
+    YKFStoreBigEndian(bytes, 0xaabbcc, 3);
+    XCTAssertEqualObjects([NSData dataWithBytes:bytes length:sizeof(bytes)], [NSData dataFromHexString:@"aabbcc 030405060708"]);
+}
+
+- (void)test_bigEndianLength {
+    XCTAssertEqual(YKFBigEndianLength(0), 0);
+    XCTAssertEqual(YKFBigEndianLength(0x01), 1);
+    XCTAssertEqual(YKFBigEndianLength(0xff), 1);
+    XCTAssertEqual(YKFBigEndianLength(0x100), 2);
+    XCTAssertEqual(YKFBigEndianLength(0x7f49), 2);
+    XCTAssertEqual(YKFBigEndianLength(0x5fc105), 3);
+    XCTAssertEqual(YKFBigEndianLength(UINT64_MAX), 8);
+}
+
+#pragma mark - YKFByteReader
+
+- (void)test_readerReadsFields {
+    NSData *data = [NSData dataFromHexString:@"01 0203 04050607 08090a0b0c0d0e0f aabbcc"];
+    YKFByteReader reader = YKFByteReaderMakeWithData(data);
+    
+    XCTAssertEqual(YKFByteReaderReadUInt8(&reader), 0x01);
+    XCTAssertEqual(YKFByteReaderReadUInt16(&reader), 0x0203);
+    XCTAssertEqual(YKFByteReaderReadUInt32(&reader), 0x04050607);
+    XCTAssertEqual(YKFByteReaderReadUInt64(&reader), 0x08090a0b0c0d0e0f);
+    XCTAssertEqual(YKFByteReaderRemaining(&reader), 3);
+    XCTAssertEqual(YKFByteReaderReadBigEndian(&reader, 3), 0xaabbcc);
+    XCTAssertEqual(YKFByteReaderRemaining(&reader), 0);
+    XCTAssertFalse(reader.overflow);
+}
+
+- (void)test_readerOverflowIsSticky {
+    NSData *data = [NSData dataFromHexString:@"010203"];
+    YKFByteReader reader = YKFByteReaderMakeWithData(data);
+    
+    XCTAssertEqual(YKFByteReaderReadUInt32(&reader), 0);
+    XCTAssertTrue(reader.overflow);
+    XCTAssertEqual(reader.offset, 0, @"A failed read does not advance the reader.");
+    
+    // The following reads fail as well, even if there are enough bytes left.
+    XCTAssertEqual(YKFByteReaderReadUInt8(&reader), 0);
+    XCTAssertFalse(YKFByteReaderSkip(&reader, 1));
+    XCTAssertTrue(reader.overflow);
+}
+
+- (void)test_readerRejectsOversizedInteger {
+    UInt8 bytes[16] = {0};
+    YKFByteReader reader = YKFByteReaderMake(bytes, sizeof(bytes));
+    XCTAssertEqual(YKFByteReaderReadBigEndian(&reader, 9), 0);
+    XCTAssertTrue(reader.overflow);
+}
+
+- (void)test_readerOverEmptyData {
+    YKFByteReader reader = YKFByteReaderMakeWithData(nil);
+    XCTAssertTrue(YKFByteReaderSkip(&reader, 0));
+    XCTAssertEqual(YKFByteReaderReadUInt8(&reader), 0);
+    XCTAssertTrue(reader.overflow);
+}
+
+#pragma mark - YKFByteWriter
+
+- (void)test_writerWritesFields {
+    UInt8 bytes[18];
+    YKFByteWriter writer = YKFByteWriterMake(bytes, sizeof(bytes));
+    
+    YKFByteWriterWriteUInt8(&writer, 0x01);
+    YKFByteWriterWriteUInt16(&writer, 0x0203);
+    YKFByteWriterWriteUInt32(&writer, 0x04050607);
+    YKFByteWriterWriteUInt64(&writer, 0x08090a0b0c0d0e0f);
+    YKFByteWriterWriteBigEndian(&writer, 0xaabbcc, 3);
+    
+    XCTAssertFalse(writer.overflow);
+    XCTAssertEqualObjects([NSData dataWithBytes:bytes length:writer.length],
+                          [NSData dataFromHexString:@"01 0203 04050607 08090a0b0c0d0e0f aabbcc"]);
+}
+
+- (void)test_writerOverflowIsSticky {
+    UInt8 bytes[3] = {0};
+    YKFByteWriter writer = YKFByteWriterMake(bytes, sizeof(bytes));
+    
+    YKFByteWriterWriteUInt16(&writer, 0x0102);
+    YKFByteWriterWriteUInt16(&writer, 0x0304);
+    XCTAssertTrue(writer.overflow);
+    XCTAssertEqual(writer.length, 2, @"A failed write does not advance the writer.");
+    
+    YKFByteWriterWriteUInt8(&writer, 0x05);
+    XCTAssertEqual(writer.length, 2);
+    XCTAssertEqualObjects([NSData dataWithBytes:bytes length:sizeof(bytes)], [NSData dataFromHexString:@"010200"]);
+}
+
+#pragma mark - Data additions
+
+- (void)test_bigEndianIntegerInRange {
+    NSData *data = [NSData dataFromHexString:@"ff 0102 030405060708090a"];
+    XCTAssertEqual([data ykf_getBigEndianIntegerInRange:NSMakeRange(1, 2)], 0x0102);
+    XCTAssertEqual([data ykf_getBigEndianIntegerInRange:NSMakeRange(0, 1)], 0xff);
+    XCTAssertEqual([data ykf_getBigEndianIntegerInRange:NSMakeRange(1, 0)], 0);
+    
+    // Only the first sizeof(NSUInteger) bytes of a longer range are read.
+    XCTAssertEqual([data ykf_getBigEndianIntegerInRange:NSMakeRange(3, 9)], 0x030405060708090a);
+    
+    // Out of bounds ranges are read as 0.
+    XCTAssertEqual([data ykf_getBigEndianIntegerInRange:NSMakeRange(10, 4)], 0);
+    XCTAssertEqual([data ykf_getBigEndianIntegerInRange:NSMakeRange(20, 1)], 0);
+}
+
+- (void)test_integerValue {
+    XCTAssertEqual([[NSData data] ykf_integerValue], 0);
+    XCTAssertEqual([[NSData dataFromHexString:@"05"] ykf_integerValue], 0x05);
+    XCTAssertEqual([[NSData dataFromHexString:@"050403"] ykf_integerValue], 0x050403);
+    
+    // The leading bytes of data longer than NSUInteger are shifted out.
+    XCTAssertEqual([[NSData dataFromHexString:@"ff 0102030405060708"] ykf_integerValue], 0x0102030405060708);
+}
+
+- (void)test_parseOATHOTPAtUnalignedIndex {
+    // 0x50ef7f19 from the RFC 4226 dynamic truncation example.
+    NSData *data = [NSData dataFromHexString:@"aa 50ef7f19"];
+    XCTAssertEqualObjects([data ykf_parseOATHOTPFromIndex:1 digits:6], @"872921");
+}
+
+#pragma mark - Mutable data additions
+
+- (void)test_appendIntegerEntries {
+    NSMutableData *data = [[NSMutableData alloc] init];
+    [data ykf_appendUInt8EntryWithTag:0x01 value:0x11];
+    [data ykf_appendUInt16EntryWithTag:0x02 value:0x1122];
+    [data ykf_appendUInt32EntryWithTag:0x03 value:0x11223344];
+    [data ykf_appendUInt64EntryWithTag:0x04 value:0x1122334455667788];
+    XCTAssertEqualObjects(data, [NSData dataFromHexString:@"010111 02021122 030411223344 04081122334455667788"]);
+}
+
+- (void)test_appendShortEntryIsBigEndian {
+    NSMutableData *data = [[NSMutableData alloc] init];
+    [data ykf_appendShortWithTag:0x03 data:0x023b];
+    XCTAssertEqualObjects(data, [NSData dataFromHexString:@"0302023b"]);
+}
+
+- (void)test_appendEntryWithHeaderBytes {
+    NSMutableData *data = [[NSMutableData alloc] initWithData:[NSData dataFromHexString:@"aa"]];
+    [data ykf_appendEntryWithTag:0x71 headerBytes:@[@(0x01), @(0x02)] data:[NSData dataFromHexString:@"112233"]];
+    XCTAssertEqualObjects(data, [NSData dataFromHexString:@"aa 7105 0102 112233"]);
+}
+
+@end
@@ -16,6 +16,7 @@
 #import "YKFTestCase.h"
 #import "YKFCBOREncoder.h"
 #import "YKFCBORDecoder.h"
+#import "YKFCBORDecoder+Private.h"
 
 @interface YKFCBORDecoderTests: YKFTestCase
 
@@ -339,4 +340,189 @@
     [inputStream close];
 }
 
+#pragma mark - Buffer Decoding Tests
+
+- (void)testMixedInputMapDecodingFromData {
+    NSDictionary *testInput = @{self.testIntegers[0]: self.testStrings[0],
+                                self.testIntegers[1]: YKFCBORByteString(self.testLongData[3]),
+                                self.testIntegers[2]: YKFCBORBool(YES),
+                                self.testIntegers[3]:
+                                    [YKFCBORMap cborMapWithValue:
+                                     @{self.testStrings[0]: YKFCBORInteger(-1000000),
+                                       self.testStrings[1]: [YKFCBORArray cborArrayWithValue:
+                                                             @[self.testIntegers[0],
+                                                               self.testStrings[1]]
+                                                             ]
+                                       }]
+                                };
+    NSData *encodedMap = [YKFCBOREncoder encodeMap:YKFCBORMap(testInput)];
+    
+    id decodedObject = [YKFCBORDecoder decodeObjectFromData:encodedMap];
+    
+    XCTAssert([decodedObject isKindOfClass:YKFCBORMap.class], @"CBOR - Wrong class decoded when parsing map.");
+    YKFCBORMap *decodedMap = (YKFCBORMap *)decodedObject;
+    
+    XCTAssert([testInput isEqualToDictionary:decodedMap.value],  @"CBOR - Wrong map decoded.");
+}
+
+- (void)testByteStringDecodingFromDataDoesNotCopy {
+    NSData *encodedByteString = [YKFCBOREncoder encodeByteString:YKFCBORByteString(self.testLongData[3])];
+    
+    YKFCBORByteString *decodedByteString = [YKFCBORDecoder decodeObjectFromData:encodedByteString];
+    
+    XCTAssert([decodedByteString isKindOfClass:YKFCBORByteString.class], @"CBOR - Wrong class decoded when parsing byte strings.");
+    XCTAssert([decodedByteString.value isEqualToData:self.testLongData[3]], @"CBOR - Wrong byte string decoded.");
+    
+    // 0x59 + 2 bytes length
+    const UInt8 *expectedBytes = (const UInt8 *)encodedByteString.bytes + 3;
+    XCTAssertEqual(decodedByteString.value.bytes, expectedBytes, @"CBOR - Byte string was copied from the input buffer.");
+}
+
+- (void)testSequenceDecodingFromData {
+    NSData *encodedString = [YKFCBOREncoder encodeTextString:self.testStrings[0]];
+    NSData *encodedInteger = [YKFCBOREncoder encodeInteger:YKFCBORInteger(1000)];
+    
+    NSMutableData *inputData = [[NSMutableData alloc] initWithData:encodedString];
+    [inputData appendData:encodedInteger];
+    
+    NSUInteger offset = 0;
+    id decodedObject = [YKFCBORDecoder decodeObjectFromData:inputData offset:&offset];
+    XCTAssert([decodedObject isEqual:self.testStrings[0]], @"CBOR - Wrong text string decoded.");
+    XCTAssertEqual(offset, encodedString.length);
+    
+    decodedObject = [YKFCBORDecoder decodeObjectFromData:inputData offset:&offset];
+    XCTAssert([decodedObject isEqual:YKFCBORInteger(1000)], @"CBOR - Wrong integer decoded.");
+    XCTAssertEqual(offset, inputData.length);
+    
+    XCTAssertNil([YKFCBORDecoder decodeObjectFromData:inputData offset:&offset]);
+    XCTAssertEqual(offset, inputData.length);
+}
+
+- (void)testTruncatedInputDecodingFromData {
+    NSData *encodedArray = [YKFCBOREncoder encodeArray:YKFCBORArray(self.testStrings)];
+    
+    for (NSUInteger length = 0; length < encodedArray.length; ++length) {
+        NSData *truncatedArray = [encodedArray subdataWithRange:NSMakeRange(0, length)];
+        XCTAssertNil([YKFCBORDecoder decodeObjectFromData:truncatedArray], @"CBOR - Decoded truncated input.");
+    }
+}
+
+- (void)testTagsSimpleValuesAndFloatsDecodingFromData {
+    // {1: 24(h'0102'), 2: null, 3: 1.5 (half precision), 4: [_ 1, 2]} followed by 5
+    UInt8 bytes[] = {0xA4, 0x01, 0xD8, 0x18, 0x42, 0x01, 0x02, 0x02, 0xF6, 0x03, 0xF9, 0x3E, 0x00,
+                     0x04, 0x9F, 0x01, 0x02, 0xFF, 0x05};
+    NSData *inputData = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    NSUInteger offset = 0;
+    YKFCBORMap *decodedMap = [YKFCBORDecoder decodeObjectFromData:inputData offset:&offset];
+    XCTAssertNotNil(decodedMap, @"CBOR - Map with tags, simple values and floats not decoded.");
+    XCTAssertEqual(offset, sizeof(bytes) - 1);
+    
+    UInt8 taggedBytes[] = {0x01, 0x02};
+    NSData *taggedData = [NSData dataWithBytes:taggedBytes length:sizeof(taggedBytes)];
+    XCTAssertEqualObjects(decodedMap.value[YKFCBORInteger(1)], YKFCBORTaggedItem(24, YKFCBORByteString(taggedData)));
+    XCTAssertEqualObjects(decodedMap.value[YKFCBORInteger(2)], YKFCBORNull());
+    XCTAssertEqualObjects(decodedMap.value[YKFCBORInteger(3)], YKFCBORFloat(1.5));
+    XCTAssertEqualObjects(decodedMap.value[YKFCBORInteger(4)], YKFCBORArray((@[YKFCBORInteger(1), YKFCBORInteger(2)])));
+    
+    XCTAssertEqualObjects([YKFCBORDecoder decodeObjectFromData:inputData offset:&offset], YKFCBORInteger(5));
+    
+    NSDictionary *foundationMap = [YKFCBORDecoder convertCBORObjectToFoundationType:decodedMap];
+    XCTAssertEqualObjects(foundationMap[@1], taggedData);
+    XCTAssertEqualObjects(foundationMap[@2], [NSNull null]);
+    XCTAssertEqualObjects(foundationMap[@3], @1.5);
+    XCTAssertEqualObjects(foundationMap[@4], (@[@1, @2]));
+}
+
+- (void)testTruncatedIndefiniteLengthDecodingFromData {
+    // [_ 1, 2] without the break code.
+    UInt8 bytes[] = {0x9F, 0x01, 0x02};
+    NSData *inputData = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    NSUInteger offset = 0;
+    XCTAssertNil([YKFCBORDecoder decodeObjectFromData:inputData offset:&offset], @"CBOR - Decoded truncated input.");
+    XCTAssertEqual(offset, 0);
+}
+
+#pragma mark - Interned Text Strings Tests
+
+- (void)testInternedTextStringLookup {
+    NSArray *internedStrings = @[@"id", @"type", @"name", @"displayName", @"icon", @"transports", @"public-key"];
+    for (NSString *string in internedStrings) {
+        NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertEqualObjects(YKFCBORInternedTextString(data.bytes, data.length), string);
+    }
+    
+    NSArray *unknownStrings = @[@"i", @"ie", @"types", @"public-kez", @"displayname", @"transports-and-more"];
+    for (NSString *string in unknownStrings) {
+        NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertNil(YKFCBORInternedTextString(data.bytes, data.length));
+    }
+}
+
+- (void)testInternedTextStringsDoNotCollide {
+    NSArray<NSString *> *internedStrings = YKFCBORInternedTextStrings();
+    XCTAssertEqual([NSSet setWithArray:internedStrings].count, internedStrings.count, @"CBOR - Duplicated interned strings.");
+    
+    // A string which collides with another one, or which is too long, is not found in the table.
+    for (NSString *string in internedStrings) {
+        NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertEqual(YKFCBORInternedTextString(data.bytes, data.length), string, @"CBOR - Interned string %@ not found.", string);
+    }
+}
+
+- (void)testInternedTextStringDecodingFromData {
+    NSData *encodedDescriptor = [self encodedCredentialListWithCount:2 keys:@[@"id", @"type", @"public-key"]];
+    
+    YKFCBORArray *descriptors = [YKFCBORDecoder decodeObjectFromData:encodedDescriptor];
+    XCTAssertEqual(descriptors.value.count, 2);
+    
+    YKFCBORMap *firstDescriptor = descriptors.value[0];
+    YKFCBORMap *secondDescriptor = descriptors.value[1];
+    YKFCBORTextString *firstType = firstDescriptor.value[YKFCBORTextString(@"type")];
+    YKFCBORTextString *secondType = secondDescriptor.value[YKFCBORTextString(@"type")];
+    
+    XCTAssertEqualObjects(firstType.value, @"public-key");
+    XCTAssertEqual(firstType.value, secondType.value, @"CBOR - Known text strings are not shared.");
+}
+
+- (void)testCredentialListDecodingPerformanceWithInternedStrings {
+    NSData *encodedList = [self encodedCredentialListWithCount:100 keys:@[@"id", @"type", @"public-key"]];
+    
+    [self measureBlock:^{
+        for (int i = 0; i < 100; ++i) {
+            [YKFCBORDecoder decodeObjectFromData:encodedList];
+        }
+    }];
+}
+
+- (void)testCredentialListDecodingPerformanceWithUnknownStrings {
+    // Same sizes as the known strings, so the only difference is the lookup result.
+    NSData *encodedList = [self encodedCredentialListWithCount:100 keys:@[@"iD", @"tYpe", @"pUblic-key"]];
+    
+    [self measureBlock:^{
+        for (int i = 0; i < 100; ++i) {
+            [YKFCBORDecoder decodeObjectFromData:encodedList];
+        }
+    }];
+}
+
+#pragma mark - Helpers
+
+/*
+ Encodes a list of credential descriptors like the ones returned when enumerating resident credentials.
+ The keys are: the id key, the type key and the type value.
+ */
+- (NSData *)encodedCredentialListWithCount:(NSUInteger)count keys:(NSArray<NSString *> *)keys {
+    NSMutableArray *descriptors = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        NSMutableData *credentialId = [[NSMutableData alloc] initWithLength:64];
+        memcpy(credentialId.mutableBytes, &i, sizeof(i));
+        
+        [descriptors addObject:YKFCBORMap((@{YKFCBORTextString(keys[0]): YKFCBORByteString(credentialId),
+                                             YKFCBORTextString(keys[1]): YKFCBORTextString(keys[2])}))];
+    }
+    return [YKFCBOREncoder encodeObject:YKFCBORArray(descriptors)];
+}
+
 @end
@@ -15,6 +15,9 @@
 #import <XCTest/XCTest.h>
 #import "YKFTestCase.h"
 #import "YKFCBOREncoder.h"
+#import "YKFCBOREncoder+Private.h"
+#import "YKFCBORDecoder.h"
+#import "YKFCBORMapSchema.h"
 
 @interface YKFCBOREncoderTests: YKFTestCase
 @end
@@ -67,6 +70,85 @@
     }
 }
 
+- (void)testIntegerEncodingCanonicalForm {
+    NSArray *testVectors =
+        @[@[@(255), [NSData dataWithBytes:(UInt8[]){0x18, 0xFF} length:2]],
+          @[@(-24), [NSData dataWithBytes:(UInt8[]){0x37} length:1]],
+          @[@(-25), [NSData dataWithBytes:(UInt8[]){0x38, 0x18} length:2]],
+          @[@(-200), [NSData dataWithBytes:(UInt8[]){0x38, 0xC7} length:2]],
+          @[@(-256), [NSData dataWithBytes:(UInt8[]){0x38, 0xFF} length:2]],
+          @[@(-257), [NSData dataWithBytes:(UInt8[]){0x39, 0x01, 0x00} length:3]],
+          @[@(-40000), [NSData dataWithBytes:(UInt8[]){0x39, 0x9C, 0x3F} length:3]],
+          @[@(-65536), [NSData dataWithBytes:(UInt8[]){0x39, 0xFF, 0xFF} length:3]],
+          @[@(-3000000000), [NSData dataWithBytes:(UInt8[]){0x3A, 0xB2, 0xD0, 0x5D, 0xFF} length:5]],
+          @[@(-4294967296), [NSData dataWithBytes:(UInt8[]){0x3A, 0xFF, 0xFF, 0xFF, 0xFF} length:5]],
+          @[@(INT64_MAX), [NSData dataWithBytes:(UInt8[]){0x1B, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF} length:9]],
+          @[@(INT64_MIN), [NSData dataWithBytes:(UInt8[]){0x3B, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF} length:9]]
+          ];
+    
+    for (NSArray *testEntry in testVectors) {
+        NSInteger integer = ((NSNumber *)testEntry[0]).integerValue;
+        NSData *expectedEncodedData = (NSData *)testEntry[1];
+        
+        NSData *encodedInteger = [YKFCBOREncoder encodeInteger:YKFCBORInteger(integer)];
+        XCTAssertEqualObjects(encodedInteger, expectedEncodedData, @"Integer (%ld) not encoded in the shortest form.", (long)integer);
+        
+        NSData *singleBufferEncodedInteger = [YKFCBOREncoder encodeObjectInSingleBuffer:YKFCBORInteger(integer)];
+        XCTAssertEqualObjects(singleBufferEncodedInteger, expectedEncodedData, @"Integer (%ld) not encoded in the shortest form.", (long)integer);
+    }
+}
+
+- (void)testIntegerEncodingBoundaries {
+    // The last value of each argument size and the values around it, for both signs.
+    UInt64 boundaries[] = {0, 23, 24, UINT8_MAX, UINT16_MAX, UINT32_MAX, INT64_MAX};
+    
+    for (NSUInteger i = 0; i < sizeof(boundaries) / sizeof(UInt64); ++i) {
+        for (SInt64 delta = -1; delta <= 1; ++delta) {
+            if ((boundaries[i] == 0 && delta < 0) || (boundaries[i] == INT64_MAX && delta > 0)) {
+                continue;
+            }
+            SInt64 value = (SInt64)(boundaries[i] + delta);
+            [self verifyIntegerEncoding:value];
+            [self verifyIntegerEncoding:-1 - value];
+        }
+    }
+}
+
+- (void)testIntegerEncodingExhaustiveRange {
+    // Covers every value with 1, 2 and 3 byte heads and the first values with a 5 byte head.
+    for (SInt64 value = -70000; value <= 70000; ++value) {
+        UInt8 buffer[YKFCBORMaxHeadLength];
+        NSUInteger length = YKFCBORWriteInteger(buffer, value);
+        NSData *expectedEncodedData = [self referenceEncodingOfInteger:value];
+        
+        if (length != expectedEncodedData.length || memcmp(buffer, expectedEncodedData.bytes, length) != 0) {
+            XCTFail(@"Integer (%lld) not encoded in the shortest form.", value);
+            return;
+        }
+        XCTAssertEqual(YKFCBORIntegerLength(value), length);
+    }
+}
+
+- (void)testLengthHeaderBoundaries {
+    NSArray *lengths = @[@(0), @(23), @(24), @(255), @(256), @(65535), @(65536)];
+    
+    for (NSNumber *length in lengths) {
+        NSData *data = [[NSMutableData alloc] initWithLength:length.unsignedIntegerValue];
+        
+        // The reference encoding of the integer length has the major type 0 head.
+        NSData *expectedHead = [self referenceEncodingOfInteger:length.integerValue];
+        UInt8 expectedInitialByte = ((UInt8 *)expectedHead.bytes)[0] | YKFCBORByteStringTagMask;
+        
+        NSData *encodedData = [YKFCBOREncoder encodeByteString:YKFCBORByteString(data)];
+        XCTAssertEqual(encodedData.length, expectedHead.length + data.length);
+        XCTAssertEqual(((UInt8 *)encodedData.bytes)[0], expectedInitialByte);
+        XCTAssertEqual(memcmp((UInt8 *)encodedData.bytes + 1, (UInt8 *)expectedHead.bytes + 1, expectedHead.length - 1), 0);
+        
+        NSData *singleBufferEncodedData = [YKFCBOREncoder encodeObjectInSingleBuffer:YKFCBORByteString(data)];
+        XCTAssertEqualObjects(singleBufferEncodedData, encodedData);
+    }
+}
+
 #pragma mark - Byte String Tests (MT 2)
 
 - (void)testByteStringEncoding {
@@ -208,4 +290,175 @@
     XCTAssert([falseEncoded isEqualToData:[NSData dataWithBytes:(UInt8[]){0xF4} length:1]]);
 }
 
+#pragma mark - Single Buffer Tests
+
+- (void)testSingleBufferEncoding {
+    NSMutableArray *descriptors = [[NSMutableArray alloc] init];
+    for (UInt8 i = 0; i < 50; ++i) {
+        NSMutableData *credentialId = [[NSMutableData alloc] initWithLength:64];
+        ((UInt8 *)credentialId.mutableBytes)[0] = i;
+        [descriptors addObject:YKFCBORMap((@{YKFCBORTextString(@"id"): YKFCBORByteString(credentialId),
+                                             YKFCBORTextString(@"type"): YKFCBORTextString(@"public-key")}))];
+    }
+    
+    NSDictionary *testMap = @{YKFCBORInteger(1): YKFCBORByteString([[NSMutableData alloc] initWithLength:32]),
+                              YKFCBORInteger(2): YKFCBORMap((@{YKFCBORTextString(@"id"): YKFCBORTextString(@"example.com"),
+                                                               YKFCBORTextString(@"name"): YKFCBORTextString(@"水 𐅑 ü")})),
+                              YKFCBORInteger(4): YKFCBORArray((@[YKFCBORMap((@{YKFCBORTextString(@"alg"): YKFCBORInteger(-7),
+                                                                              YKFCBORTextString(@"type"): YKFCBORTextString(@"public-key")})),
+                                                                 YKFCBORMap((@{YKFCBORTextString(@"alg"): YKFCBORInteger(-257),
+                                                                              YKFCBORTextString(@"type"): YKFCBORTextString(@"public-key")}))])),
+                              YKFCBORInteger(5): YKFCBORArray(descriptors),
+                              YKFCBORInteger(7): YKFCBORMap((@{YKFCBORTextString(@"rk"): YKFCBORBool(YES),
+                                                               YKFCBORTextString(@"uv"): YKFCBORBool(NO)})),
+                              YKFCBORInteger(9): YKFCBORInteger(1000000000000)};
+    YKFCBORMap *cborMap = YKFCBORMap(testMap);
+    
+    NSData *expectedEncodedData = [YKFCBOREncoder encodeObject:cborMap];
+    NSData *encodedData = [YKFCBOREncoder encodeObjectInSingleBuffer:cborMap];
+    
+    XCTAssertEqual([YKFCBOREncoder encodedLengthOfObject:cborMap], expectedEncodedData.length);
+    XCTAssert([encodedData isEqualToData:expectedEncodedData], @"Single buffer encoding does not match the encoding of the map.");
+}
+
+- (void)testSingleBufferEncodingOfPrimitives {
+    NSArray *testVectors =
+        @[@[YKFCBORInteger(0), [NSData dataWithBytes:(UInt8[]){0x00} length:1]],
+          @[YKFCBORInteger(23), [NSData dataWithBytes:(UInt8[]){0x17} length:1]],
+          @[YKFCBORInteger(24), [NSData dataWithBytes:(UInt8[]){0x18, 0x18} length:2]],
+          @[YKFCBORInteger(-1), [NSData dataWithBytes:(UInt8[]){0x20} length:1]],
+          @[YKFCBORInteger(-1000), [NSData dataWithBytes:(UInt8[]){0x39, 0x03, 0xE7} length:3]],
+          @[YKFCBORByteString([NSData data]), [NSData dataWithBytes:(UInt8[]){0x40} length:1]],
+          @[YKFCBORTextString(@""), [NSData dataWithBytes:(UInt8[]){0x60} length:1]],
+          @[YKFCBORTextString(@"水"), [NSData dataWithBytes:(UInt8[]){0x63, 0xE6, 0xB0, 0xB4} length:4]],
+          @[YKFCBORArray(@[]), [NSData dataWithBytes:(UInt8[]){0x80} length:1]],
+          @[YKFCBORMap(@{}), [NSData dataWithBytes:(UInt8[]){0xA0} length:1]],
+          @[YKFCBORBool(YES), [NSData dataWithBytes:(UInt8[]){0xF5} length:1]]
+          ];
+    
+    for (NSArray *testEntry in testVectors) {
+        NSData *encodedData = [YKFCBOREncoder encodeObjectInSingleBuffer:testEntry[0]];
+        NSData *expectedEncodedData = (NSData *)testEntry[1];
+        
+        XCTAssertEqual([YKFCBOREncoder encodedLengthOfObject:testEntry[0]], expectedEncodedData.length);
+        XCTAssert([encodedData isEqualToData:expectedEncodedData], @"Single buffer encoding does not match for %@.", testEntry[0]);
+    }
+}
+
+#pragma mark - Schema Map Tests
+
+- (void)testSchemaMapEncoding {
+    YKFCBORMapSchema *schema = [[YKFCBORMapSchema alloc] initWithIntegerKeyCount:4];
+    XCTAssertNotNil(schema);
+    
+    YKFCBORSchemaMap *schemaMap = YKFCBORSchemaMap(schema);
+    [schemaMap setObject:YKFCBORByteString([[NSMutableData alloc] initWithLength:32]) forIntegerKey:1];
+    [schemaMap setObject:YKFCBORTextString(@"example.com") forIntegerKey:2];
+    [schemaMap setObject:YKFCBORInteger(1) forIntegerKey:4];
+    XCTAssertEqual(schemaMap.count, 3);
+    
+    NSDictionary *testMap = @{YKFCBORInteger(1): YKFCBORByteString([[NSMutableData alloc] initWithLength:32]),
+                              YKFCBORInteger(2): YKFCBORTextString(@"example.com"),
+                              YKFCBORInteger(4): YKFCBORInteger(1)};
+    NSData *expectedEncodedData = [YKFCBOREncoder encodeMap:YKFCBORMap(testMap)];
+    NSData *encodedData = [YKFCBOREncoder encodeObjectInSingleBuffer:schemaMap];
+    
+    XCTAssertEqual([YKFCBOREncoder encodedLengthOfObject:schemaMap], expectedEncodedData.length);
+    XCTAssert([encodedData isEqualToData:expectedEncodedData], @"Schema map encoding does not match the encoding of the map.");
+    
+    schemaMap[1] = nil;
+    XCTAssertEqual(schemaMap.count, 2);
+}
+
+- (void)testSchemaMapCanonicalKeyOrder {
+    // COSE key labels: the canonical order puts the positive integers before the negative ones.
+    YKFCBORMapSchema *schema = [[YKFCBORMapSchema alloc] initWithKeys:@[YKFCBORInteger(1), YKFCBORInteger(3),
+                                                                        YKFCBORInteger(-1), YKFCBORInteger(-2)]];
+    XCTAssertNotNil(schema);
+    
+    YKFCBORSchemaMap *schemaMap = YKFCBORSchemaMap(schema);
+    schemaMap[3] = YKFCBORInteger(4);
+    schemaMap[2] = YKFCBORInteger(3);
+    schemaMap[0] = YKFCBORInteger(1);
+    schemaMap[1] = YKFCBORInteger(2);
+    
+    UInt8 expectedBytes[] = {0xA4, 0x01, 0x01, 0x03, 0x02, 0x20, 0x03, 0x21, 0x04};
+    NSData *expectedEncodedData = [NSData dataWithBytes:expectedBytes length:sizeof(expectedBytes)];
+    NSData *encodedData = [YKFCBOREncoder encodeObjectInSingleBuffer:schemaMap];
+    
+    XCTAssert([encodedData isEqualToData:expectedEncodedData], @"Schema map is not encoded in canonical order.");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testIntegerEncodingPerformance {
+    [self measureBlock:^{
+        for (SInt64 value = -50000; value < 50000; value += 7) {
+            [YKFCBOREncoder encodeInteger:YKFCBORInteger(value)];
+        }
+    }];
+}
+
+- (void)testIntegerHeadWritingPerformance {
+    [self measureBlock:^{
+        UInt8 buffer[YKFCBORMaxHeadLength];
+        NSUInteger totalLength = 0;
+        for (SInt64 value = -500000; value < 500000; ++value) {
+            totalLength += YKFCBORWriteInteger(buffer, value * 4099);
+        }
+        XCTAssert(totalLength > 0);
+    }];
+}
+
+#pragma mark - Helpers
+
+- (void)verifyIntegerEncoding:(SInt64)value {
+    NSData *expectedEncodedData = [self referenceEncodingOfInteger:value];
+    
+    NSData *encodedInteger = [YKFCBOREncoder encodeInteger:YKFCBORInteger(value)];
+    XCTAssertEqualObjects(encodedInteger, expectedEncodedData, @"Integer (%lld) not encoded in the shortest form.", value);
+    XCTAssertEqual([YKFCBOREncoder encodedLengthOfObject:YKFCBORInteger(value)], expectedEncodedData.length);
+    
+    NSData *singleBufferEncodedInteger = [YKFCBOREncoder encodeObjectInSingleBuffer:YKFCBORInteger(value)];
+    XCTAssertEqualObjects(singleBufferEncodedInteger, expectedEncodedData);
+    
+    YKFCBORInteger *decodedInteger = [YKFCBORDecoder decodeObjectFromData:encodedInteger];
+    XCTAssertEqual(decodedInteger.value, value, @"Integer (%lld) does not round trip.", value);
+}
+
+/*
+ Straightforward encoding of RFC 8949, section 3.1, used to verify the encoder.
+ */
+- (NSData *)referenceEncodingOfInteger:(SInt64)value {
+    UInt8 majorType = value < 0 ? 0x20 : 0x00;
+    UInt64 argument = value < 0 ? (UInt64)(-(value + 1)) : (UInt64)value;
+    
+    UInt8 additionalInfo = 0;
+    NSUInteger size = 0;
+    if (argument < 24) {
+        additionalInfo = (UInt8)argument;
+    } else if (argument <= 0xFF) {
+        additionalInfo = 24;
+        size = 1;
+    } else if (argument <= 0xFFFF) {
+        additionalInfo = 25;
+        size = 2;
+    } else if (argument <= 0xFFFFFFFF) {
+        additionalInfo = 26;
+        size = 4;
+    } else {
+        additionalInfo = 27;
+        size = 8;
+    }
+    
+    NSMutableData *data = [[NSMutableData alloc] init];
+    UInt8 head = majorType | additionalInfo;
+    [data appendBytes:&head length:1];
+    for (NSInteger i = size - 1; i >= 0; --i) {
+        UInt8 byte = (UInt8)(argument >> (8 * i));
+        [data appendBytes:&byte length:1];
+    }
+    return [data copy];
+}
+
 @end
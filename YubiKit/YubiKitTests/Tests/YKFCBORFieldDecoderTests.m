@@ -0,0 +1,270 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFCBOREncoder.h"
+#import "YKFCBORDecoder.h"
+#import "YKFCBORFieldDecoder.h"
+#import "YKFFIDO2Type.h"
+#import "YKFFIDO2GetInfoResponse.h"
+#import "YKFFIDO2GetInfoResponse+Private.h"
+#import "YKFFIDO2GetAssertionResponse.h"
+#import "YKFFIDO2GetAssertionResponse+Private.h"
+
+static const NSUInteger YKFCBORFieldDecoderTestsBenchmarkIterations = 1000;
+
+// authenticatorGetInfo response from a YubiKey 5 NFC.
+static const UInt8 YKFCBORFieldDecoderTestsGetInfoResponse[] = {
+    0xA6, 0x01, 0x82, 0x66, 0x55, 0x32, 0x46, 0x5F, 0x56, 0x32, 0x68, 0x46, 0x49, 0x44, 0x4F, 0x5F,
+    0x32, 0x5F, 0x30, 0x02, 0x81, 0x6B, 0x68, 0x6D, 0x61, 0x63, 0x2D, 0x73, 0x65, 0x63, 0x72, 0x65,
+    0x74, 0x03, 0x50, 0xFA, 0x2B, 0x99, 0xDC, 0x9E, 0x39, 0x42, 0x57, 0x8F, 0x92, 0x4A, 0x30, 0xD2,
+    0x3C, 0x41, 0x18, 0x04, 0xA4, 0x62, 0x72, 0x6B, 0xF5, 0x62, 0x75, 0x70, 0xF5, 0x64, 0x70, 0x6C,
+    0x61, 0x74, 0xF4, 0x69, 0x63, 0x6C, 0x69, 0x65, 0x6E, 0x74, 0x50, 0x69, 0x6E, 0xF4, 0x05, 0x19,
+    0x04, 0xB0, 0x06, 0x81, 0x01
+};
+
+static const YKFCBORField YKFCBORFieldDecoderTestsFields[] = {
+    {.integerKey = 1, .type = YKFCBORFieldTypeInteger, .required = YES},
+    {.integerKey = 2, .type = YKFCBORFieldTypeByteString},
+    {.integerKey = -1, .type = YKFCBORFieldTypeTextString}
+};
+
+@interface YKFCBORFieldDecoderTests: YKFTestCase
+
+@property (nonatomic) NSData *getAssertionResponse;
+
+@end
+
+@implementation YKFCBORFieldDecoderTests
+
+- (void)setUp {
+    [super setUp];
+    
+    NSMutableData *credentialId = [[NSMutableData alloc] initWithLength:64];
+    memset(credentialId.mutableBytes, 0xAB, credentialId.length);
+    
+    NSMutableData *authData = [[NSMutableData alloc] initWithLength:37];
+    ((UInt8 *)authData.mutableBytes)[32] = 0x05;
+    
+    NSMutableData *signature = [[NSMutableData alloc] initWithLength:71];
+    ((UInt8 *)signature.mutableBytes)[0] = 0x30;
+    
+    NSDictionary *credential = @{YKFCBORTextString(@"id"): YKFCBORByteString(credentialId),
+                                 YKFCBORTextString(@"type"): YKFCBORTextString(@"public-key")};
+    NSDictionary *user = @{YKFCBORTextString(@"id"): YKFCBORByteString([[NSMutableData alloc] initWithLength:16]),
+                           YKFCBORTextString(@"name"): YKFCBORTextString(@"john.smith@yubico.com"),
+                           YKFCBORTextString(@"displayName"): YKFCBORTextString(@"John Smith")};
+    NSDictionary *response = @{YKFCBORInteger(1): YKFCBORMap(credential),
+                               YKFCBORInteger(2): YKFCBORByteString(authData),
+                               YKFCBORInteger(3): YKFCBORByteString(signature),
+                               YKFCBORInteger(4): YKFCBORMap(user),
+                               YKFCBORInteger(5): YKFCBORInteger(2)};
+    
+    self.getAssertionResponse = [YKFCBOREncoder encodeMap:YKFCBORMap(response)];
+}
+
+#pragma mark - Response Tests
+
+- (void)testGetInfoResponseDecoding {
+    NSData *responseData = [NSData dataWithBytes:YKFCBORFieldDecoderTestsGetInfoResponse length:sizeof(YKFCBORFieldDecoderTestsGetInfoResponse)];
+    YKFFIDO2GetInfoResponse *response = [[YKFFIDO2GetInfoResponse alloc] initWithCBORData:responseData];
+    
+    XCTAssertNotNil(response);
+    XCTAssertEqualObjects(response.versions, (@[@"U2F_V2", @"FIDO_2_0"]));
+    XCTAssertEqualObjects(response.extensions, @[@"hmac-secret"]);
+    XCTAssertEqual(response.aaguid.length, 16);
+    XCTAssertEqualObjects(response.options[@"rk"], @(YES));
+    XCTAssertEqualObjects(response.options[@"clientPin"], @(NO));
+    XCTAssertEqual(response.maxMsgSize, 1200);
+    XCTAssertEqualObjects(response.pinProtocols, @[@(1)]);
+    XCTAssertEqual(response.minPinLength, 4);
+}
+
+- (void)testGetAssertionResponseDecoding {
+    YKFFIDO2GetAssertionResponse *response = [[YKFFIDO2GetAssertionResponse alloc] initWithCBORData:self.getAssertionResponse];
+    
+    XCTAssertNotNil(response);
+    XCTAssertEqual(response.credential.credentialId.length, 64);
+    XCTAssertEqualObjects(response.credential.credentialType.name, @"public-key");
+    XCTAssertEqual(response.credential.credentialTransports.count, 0);
+    XCTAssertEqual(response.authData.length, 37);
+    XCTAssertEqual(response.signature.length, 71);
+    XCTAssertEqualObjects(response.user.userName, @"john.smith@yubico.com");
+    XCTAssertEqualObjects(response.user.userDisplayName, @"John Smith");
+    XCTAssertNil(response.user.userIcon);
+    XCTAssertEqual(response.numberOfCredentials, 2);
+    
+    const UInt8 *responseBytes = response.rawResponse.bytes;
+    XCTAssert(response.authData.bytes > (const void *)responseBytes && response.authData.bytes < (const void *)(responseBytes + response.rawResponse.length),
+              @"The authData is not a slice of the response.");
+}
+
+- (void)testGetAssertionResponseWithMalformedUserIsRejected {
+    // The user entity without its required id.
+    NSDictionary *user = @{YKFCBORTextString(@"name"): YKFCBORTextString(@"john.smith@yubico.com")};
+    NSDictionary *response = @{YKFCBORInteger(2): YKFCBORByteString([[NSMutableData alloc] initWithLength:37]),
+                               YKFCBORInteger(3): YKFCBORByteString([[NSMutableData alloc] initWithLength:71]),
+                               YKFCBORInteger(4): YKFCBORMap(user)};
+    NSData *responseData = [YKFCBOREncoder encodeMap:YKFCBORMap(response)];
+    
+    // The parser asserts on invalid responses when the assertions are enabled.
+    YKFFIDO2GetAssertionResponse *parsedResponse = nil;
+    @try {
+        parsedResponse = [[YKFFIDO2GetAssertionResponse alloc] initWithCBORData:responseData];
+    } @catch (NSException *exception) {
+        parsedResponse = nil;
+    }
+    XCTAssertNil(parsedResponse);
+}
+
+#pragma mark - Validation Tests
+
+- (void)testFieldDecoding {
+    // {1: -10, 2: h'0102', 9: [1, 2], -1: "text"}
+    UInt8 bytes[] = {0xA4, 0x01, 0x29, 0x02, 0x42, 0x01, 0x02, 0x09, 0x82, 0x01, 0x02, 0x20, 0x64, 0x74, 0x65, 0x78, 0x74};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    YKFCBORFieldValue values[3];
+    XCTAssert([YKFCBORFieldDecoder decodeMapFromData:data fields:YKFCBORFieldDecoderTestsFields count:3 values:values]);
+    
+    XCTAssert(values[0].present);
+    XCTAssertEqual(values[0].integerValue, -10);
+    XCTAssertEqualObjects([YKFCBORFieldDecoder byteStringFromData:data value:&values[1]], [NSData dataWithBytes:(UInt8[]){0x01, 0x02} length:2]);
+    XCTAssertEqualObjects([YKFCBORFieldDecoder textStringFromData:data value:&values[2]], @"text");
+}
+
+- (void)testUnknownFieldsWithTagsAndFloatsAreSkipped {
+    // {1: -10, 2: h'0102', 7: 1.5, 8: [_ 1(0), null], -1: "text"}
+    UInt8 bytes[] = {0xA5, 0x01, 0x29, 0x02, 0x42, 0x01, 0x02, 0x07, 0xF9, 0x3E, 0x00, 0x08, 0x9F, 0xC1, 0x00, 0xF6, 0xFF,
+                     0x20, 0x64, 0x74, 0x65, 0x78, 0x74};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    YKFCBORFieldValue values[3];
+    XCTAssert([YKFCBORFieldDecoder decodeMapFromData:data fields:YKFCBORFieldDecoderTestsFields count:3 values:values]);
+    
+    XCTAssertEqual(values[0].integerValue, -10);
+    XCTAssertEqualObjects([YKFCBORFieldDecoder byteStringFromData:data value:&values[1]], [NSData dataWithBytes:(UInt8[]){0x01, 0x02} length:2]);
+    XCTAssertEqualObjects([YKFCBORFieldDecoder textStringFromData:data value:&values[2]], @"text");
+}
+
+- (void)testFieldTypeValidation {
+    // {1: "1"}
+    UInt8 bytes[] = {0xA1, 0x01, 0x61, 0x31};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    YKFCBORFieldValue values[3];
+    XCTAssertFalse([YKFCBORFieldDecoder decodeMapFromData:data fields:YKFCBORFieldDecoderTestsFields count:3 values:values],
+                   @"A value with the wrong type was decoded.");
+}
+
+- (void)testRequiredFieldValidation {
+    // {2: h''}
+    UInt8 bytes[] = {0xA1, 0x02, 0x40};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    YKFCBORFieldValue values[3];
+    XCTAssertFalse([YKFCBORFieldDecoder decodeMapFromData:data fields:YKFCBORFieldDecoderTestsFields count:3 values:values],
+                   @"A map without a required field was decoded.");
+}
+
+- (void)testDuplicatedKeysValidation {
+    // {1: 1, 1: 2}
+    UInt8 knownKeyBytes[] = {0xA2, 0x01, 0x01, 0x01, 0x02};
+    // {1: 1, 9: 1, 9: 2}
+    UInt8 unknownKeyBytes[] = {0xA3, 0x01, 0x01, 0x09, 0x01, 0x09, 0x02};
+    
+    YKFCBORFieldValue values[3];
+    NSData *data = [NSData dataWithBytes:knownKeyBytes length:sizeof(knownKeyBytes)];
+    XCTAssertFalse([YKFCBORFieldDecoder decodeMapFromData:data fields:YKFCBORFieldDecoderTestsFields count:3 values:values],
+                   @"A map with duplicated keys was decoded.");
+    
+    data = [NSData dataWithBytes:unknownKeyBytes length:sizeof(unknownKeyBytes)];
+    XCTAssertFalse([YKFCBORFieldDecoder decodeMapFromData:data fields:YKFCBORFieldDecoderTestsFields count:3 values:values],
+                   @"A map with duplicated unknown keys was decoded.");
+}
+
+- (void)testTruncatedInputValidation {
+    NSData *truncatedResponse = [self.getAssertionResponse subdataWithRange:NSMakeRange(0, self.getAssertionResponse.length - 1)];
+    
+    YKFCBORFieldValue values[3];
+    XCTAssertFalse([YKFCBORFieldDecoder decodeMapFromData:truncatedResponse fields:YKFCBORFieldDecoderTestsFields count:3 values:values],
+                   @"A truncated map was decoded.");
+}
+
+#pragma mark - Performance Tests
+
+/*
+ Baseline: the response is decoded into CBOR objects, converted to foundation types and then copied in the model.
+ */
+- (void)testGetAssertionDecodingPerformanceWithFoundationConversion {
+    NSData *responseData = self.getAssertionResponse;
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < YKFCBORFieldDecoderTestsBenchmarkIterations; ++i) {
+            NSInputStream *decoderInputStream = [[NSInputStream alloc] initWithData:responseData];
+            [decoderInputStream open];
+            YKFCBORMap *responseMap = [YKFCBORDecoder decodeObjectFrom:decoderInputStream];
+            [decoderInputStream close];
+            
+            NSDictionary *response = [YKFCBORDecoder convertCBORObjectToFoundationType:responseMap];
+            
+            YKFFIDO2PublicKeyCredentialUserEntity *user = [[YKFFIDO2PublicKeyCredentialUserEntity alloc] init];
+            user.userId = response[@(4)][@"id"];
+            user.userName = response[@(4)][@"name"];
+            user.userDisplayName = response[@(4)][@"displayName"];
+            XCTAssertNotNil(response[@(2)]);
+        }
+    }];
+}
+
+- (void)testGetAssertionDecodingPerformanceWithFieldTables {
+    NSData *responseData = self.getAssertionResponse;
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < YKFCBORFieldDecoderTestsBenchmarkIterations; ++i) {
+            YKFFIDO2GetAssertionResponse *response = [[YKFFIDO2GetAssertionResponse alloc] initWithCBORData:responseData];
+            XCTAssertNotNil(response.authData);
+        }
+    }];
+}
+
+- (void)testGetInfoDecodingPerformanceWithFoundationConversion {
+    NSData *responseData = [NSData dataWithBytes:YKFCBORFieldDecoderTestsGetInfoResponse length:sizeof(YKFCBORFieldDecoderTestsGetInfoResponse)];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < YKFCBORFieldDecoderTestsBenchmarkIterations; ++i) {
+            NSInputStream *decoderInputStream = [[NSInputStream alloc] initWithData:responseData];
+            [decoderInputStream open];
+            YKFCBORMap *responseMap = [YKFCBORDecoder decodeObjectFrom:decoderInputStream];
+            [decoderInputStream close];
+            
+            NSDictionary *response = [YKFCBORDecoder convertCBORObjectToFoundationType:responseMap];
+            XCTAssertNotNil(response[@(1)]);
+        }
+    }];
+}
+
+- (void)testGetInfoDecodingPerformanceWithFieldTables {
+    NSData *responseData = [NSData dataWithBytes:YKFCBORFieldDecoderTestsGetInfoResponse length:sizeof(YKFCBORFieldDecoderTestsGetInfoResponse)];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < YKFCBORFieldDecoderTestsBenchmarkIterations; ++i) {
+            YKFFIDO2GetInfoResponse *response = [[YKFFIDO2GetInfoResponse alloc] initWithCBORData:responseData];
+            XCTAssertNotNil(response.versions);
+        }
+    }];
+}
+
+@end
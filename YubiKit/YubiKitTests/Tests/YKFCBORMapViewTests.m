@@ -0,0 +1,112 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFCBOREncoder.h"
+#import "YKFCBORMapView.h"
+
+@interface YKFCBORMapViewTests: YKFTestCase
+
+@property (nonatomic) NSData *authData;
+@property (nonatomic) NSData *signature;
+@property (nonatomic) NSData *encodedResponse;
+
+@end
+
+@implementation YKFCBORMapViewTests
+
+- (void)setUp {
+    [super setUp];
+    
+    NSMutableData *authData = [[NSMutableData alloc] initWithLength:37];
+    ((UInt8 *)authData.mutableBytes)[32] = 0x01;
+    self.authData = [authData copy];
+    
+    NSMutableData *signature = [[NSMutableData alloc] initWithLength:71];
+    ((UInt8 *)signature.mutableBytes)[0] = 0x30;
+    self.signature = [signature copy];
+    
+    NSDictionary *user = @{YKFCBORTextString(@"id"): YKFCBORByteString([NSData dataWithBytes:(UInt8[]){0x01, 0x02} length:2]),
+                           YKFCBORTextString(@"name"): YKFCBORTextString(@"john.smith@yubico.com"),
+                           YKFCBORTextString(@"displayName"): YKFCBORTextString(@"John Smith")};
+    
+    NSDictionary *response = @{YKFCBORInteger(2): YKFCBORByteString(self.authData),
+                               YKFCBORInteger(3): YKFCBORByteString(self.signature),
+                               YKFCBORInteger(4): YKFCBORMap(user),
+                               YKFCBORInteger(5): YKFCBORInteger(3)};
+    
+    self.encodedResponse = [YKFCBOREncoder encodeMap:YKFCBORMap(response)];
+}
+
+#pragma mark - Tests
+
+- (void)testMapIndexing {
+    YKFCBORMapView *mapView = [[YKFCBORMapView alloc] initWithData:self.encodedResponse];
+    
+    XCTAssertNotNil(mapView);
+    XCTAssertEqual(mapView.count, 4);
+    XCTAssert([mapView containsKey:YKFCBORInteger(2)]);
+    XCTAssertFalse([mapView containsKey:YKFCBORInteger(1)]);
+    
+    NSArray *expectedKeys = @[YKFCBORInteger(2), YKFCBORInteger(3), YKFCBORInteger(4), YKFCBORInteger(5)];
+    XCTAssert([mapView.keys isEqualToArray:expectedKeys], @"The keys are not in the encoding order.");
+}
+
+- (void)testByteStringSlices {
+    YKFCBORMapView *mapView = [[YKFCBORMapView alloc] initWithData:self.encodedResponse];
+    
+    NSData *authData = [mapView byteStringForKey:YKFCBORInteger(2)];
+    NSData *signature = [mapView byteStringForKey:YKFCBORInteger(3)];
+    
+    XCTAssert([authData isEqualToData:self.authData]);
+    XCTAssert([signature isEqualToData:self.signature]);
+    
+    const UInt8 *responseBytes = self.encodedResponse.bytes;
+    XCTAssert(authData.bytes > (const void *)responseBytes && authData.bytes < (const void *)(responseBytes + self.encodedResponse.length),
+              @"The byte string is not a slice of the response.");
+    
+    XCTAssertNil([mapView byteStringForKey:YKFCBORInteger(5)], @"An integer was returned as byte string.");
+}
+
+- (void)testLazyValues {
+    YKFCBORMapView *mapView = [[YKFCBORMapView alloc] initWithData:self.encodedResponse];
+    
+    XCTAssertEqualObjects([mapView objectForKey:YKFCBORInteger(5)], @(3));
+    XCTAssert([[mapView cborObjectForKey:YKFCBORInteger(5)] isEqual:YKFCBORInteger(3)]);
+    
+    YKFCBORMapView *userView = [mapView mapViewForKey:YKFCBORInteger(4)];
+    XCTAssertNotNil(userView);
+    XCTAssertEqual(userView.count, 3);
+    XCTAssertEqualObjects([userView textStringForKey:YKFCBORTextString(@"displayName")], @"John Smith");
+    XCTAssertNil([userView textStringForKey:YKFCBORTextString(@"icon")]);
+    
+    NSData *encodedUser = [mapView encodedObjectForKey:YKFCBORInteger(4)];
+    YKFCBORMapView *encodedUserView = [[YKFCBORMapView alloc] initWithData:encodedUser];
+    XCTAssertEqualObjects([encodedUserView byteStringForKey:YKFCBORTextString(@"id")], [userView byteStringForKey:YKFCBORTextString(@"id")]);
+}
+
+- (void)testInvalidInput {
+    NSData *encodedArray = [YKFCBOREncoder encodeArray:YKFCBORArray(@[YKFCBORInteger(1)])];
+    XCTAssertNil([[YKFCBORMapView alloc] initWithData:encodedArray], @"A view was created for an array.");
+    
+    NSData *truncatedResponse = [self.encodedResponse subdataWithRange:NSMakeRange(0, self.encodedResponse.length - 1)];
+    XCTAssertNil([[YKFCBORMapView alloc] initWithData:truncatedResponse], @"A view was created for a truncated map.");
+    
+    // {1: 1, 1: 2}
+    NSData *duplicatedKeys = [NSData dataWithBytes:(UInt8[]){0xA2, 0x01, 0x01, 0x01, 0x02} length:5];
+    XCTAssertNil([[YKFCBORMapView alloc] initWithData:duplicatedKeys], @"A view was created for a map with duplicated keys.");
+}
+
+@end
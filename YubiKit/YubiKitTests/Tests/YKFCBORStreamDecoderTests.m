@@ -0,0 +1,328 @@
+// Copyright 2018-2019 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFCBOREncoder.h"
+#import "YKFCBORDecoder.h"
+#import "YKFCBORStreamDecoder.h"
+
+@interface YKFCBORStreamDecoderTests: YKFTestCase<YKFCBORStreamDecoderDelegate>
+
+@property (nonatomic) YKFCBORStreamDecoder *decoder;
+
+@property (nonatomic) NSMutableArray *decodedObjects;
+@property (nonatomic) NSMutableArray *nestedObjects;
+@property (nonatomic) NSMutableData *receivedStringData;
+
+@end
+
+@implementation YKFCBORStreamDecoderTests
+
+- (void)setUp {
+    [super setUp];
+    
+    self.decoder = [[YKFCBORStreamDecoder alloc] initWithDelegate:self];
+    self.decodedObjects = [[NSMutableArray alloc] init];
+    self.nestedObjects = [[NSMutableArray alloc] init];
+    self.receivedStringData = [[NSMutableData alloc] init];
+}
+
+#pragma mark - YKFCBORStreamDecoderDelegate
+
+- (void)streamDecoder:(YKFCBORStreamDecoder *)decoder didDecodeObject:(id)object {
+    [self.decodedObjects addObject:object];
+}
+
+- (void)streamDecoder:(YKFCBORStreamDecoder *)decoder didDecodeNestedObject:(id)object depth:(NSUInteger)depth {
+    [self.nestedObjects addObject:object];
+}
+
+- (void)streamDecoder:(YKFCBORStreamDecoder *)decoder didReceiveStringData:(NSData *)data depth:(NSUInteger)depth {
+    [self.receivedStringData appendData:data];
+}
+
+#pragma mark - Helpers
+
+- (BOOL)appendBytes:(const UInt8 *)bytes length:(NSUInteger)length chunkSize:(NSUInteger)chunkSize {
+    for (NSUInteger offset = 0; offset < length; offset += chunkSize) {
+        NSUInteger size = MIN(chunkSize, length - offset);
+        if (![self.decoder appendData:[NSData dataWithBytes:bytes + offset length:size]]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (id)decodeBytes:(const UInt8 *)bytes length:(NSUInteger)length {
+    [self.decoder reset];
+    [self.decodedObjects removeAllObjects];
+    
+    BOOL success = [self appendBytes:bytes length:length chunkSize:1];
+    XCTAssertTrue(success);
+    XCTAssertFalse(self.decoder.hasPartialObject);
+    XCTAssertEqual(self.decodedObjects.count, 1);
+    
+    return self.decodedObjects.firstObject;
+}
+
+- (BOOL)isMalformed:(const UInt8 *)bytes length:(NSUInteger)length {
+    [self.decoder reset];
+    [self.decodedObjects removeAllObjects];
+    
+    BOOL success = [self.decoder appendData:[NSData dataWithBytes:bytes length:length]];
+    return !success && self.decoder.failed;
+}
+
+#pragma mark - Definite Length Tests
+
+- (void)testMixedInputMapDecodingByteByByte {
+    NSMutableData *longData = [[NSMutableData alloc] initWithLength:1000];
+    YKFCBORMap *map = YKFCBORMap((@{YKFCBORInteger(1): YKFCBORByteString(longData),
+                                    YKFCBORInteger(2): YKFCBORArray((@[YKFCBORInteger(-1000000), YKFCBORTextString(@"public-key")])),
+                                    YKFCBORInteger(3): YKFCBORMap(@{YKFCBORTextString(@"up"): YKFCBORBool(YES)})}));
+    NSData *encodedMap = [YKFCBOREncoder encodeObject:map];
+    XCTAssertNotNil(encodedMap);
+    
+    for (NSUInteger chunkSize = 1; chunkSize <= encodedMap.length; chunkSize *= 7) {
+        [self.decodedObjects removeAllObjects];
+        
+        BOOL success = [self appendBytes:encodedMap.bytes length:encodedMap.length chunkSize:chunkSize];
+        XCTAssertTrue(success);
+        XCTAssertEqual(self.decodedObjects.count, 1);
+        XCTAssertEqualObjects(self.decodedObjects.firstObject, map);
+    }
+}
+
+- (void)testSequenceDecoding {
+    UInt8 sequence[] = {0x01, 0x18, 0x64, 0x39, 0x03, 0xE7, 0x63, 0x61, 0x62, 0x63};
+    NSArray *expectedObjects = @[YKFCBORInteger(1), YKFCBORInteger(100), YKFCBORInteger(-1000), YKFCBORTextString(@"abc")];
+    
+    XCTAssertTrue([self.decoder appendData:[NSData dataWithBytes:sequence length:sizeof(sequence)]]);
+    XCTAssertEqualObjects(self.decodedObjects, expectedObjects);
+}
+
+- (void)testPartialObject {
+    UInt8 partialArray[] = {0x83, 0x01, 0x19, 0x03};
+    
+    XCTAssertTrue([self.decoder appendData:[NSData dataWithBytes:partialArray length:sizeof(partialArray)]]);
+    XCTAssertTrue(self.decoder.hasPartialObject);
+    XCTAssertEqual(self.decodedObjects.count, 0);
+    XCTAssertEqual(self.nestedObjects.count, 1);
+    
+    UInt8 remainingArray[] = {0xE8, 0x02};
+    XCTAssertTrue([self.decoder appendData:[NSData dataWithBytes:remainingArray length:sizeof(remainingArray)]]);
+    XCTAssertFalse(self.decoder.hasPartialObject);
+    
+    NSArray *expectedArray = @[YKFCBORInteger(1), YKFCBORInteger(1000), YKFCBORInteger(2)];
+    XCTAssertEqualObjects(self.decodedObjects.firstObject, YKFCBORArray(expectedArray));
+}
+
+- (void)testStringDataIsReportedWhileReceived {
+    NSMutableData *longData = [[NSMutableData alloc] initWithCapacity:1000];
+    for (NSUInteger i = 0; i < 1000; ++i) {
+        UInt8 byte = i % 256;
+        [longData appendBytes:&byte length:1];
+    }
+    NSData *encodedString = [YKFCBOREncoder encodeObject:YKFCBORByteString(longData)];
+    
+    // Append everything but the last byte.
+    XCTAssertTrue([self appendBytes:encodedString.bytes length:encodedString.length - 1 chunkSize:64]);
+    XCTAssertEqual(self.decodedObjects.count, 0);
+    XCTAssertEqualObjects(self.receivedStringData, [longData subdataWithRange:NSMakeRange(0, 999)]);
+    
+    XCTAssertTrue([self appendBytes:(UInt8 *)encodedString.bytes + encodedString.length - 1 length:1 chunkSize:1]);
+    XCTAssertEqualObjects(self.receivedStringData, longData);
+    XCTAssertEqualObjects(self.decodedObjects.firstObject, YKFCBORByteString(longData));
+}
+
+#pragma mark - Indefinite Length Tests
+
+- (void)testIndefiniteLengthByteStringDecoding {
+    // (_ h'0102', h'030405')
+    UInt8 encoded[] = {0x5F, 0x42, 0x01, 0x02, 0x43, 0x03, 0x04, 0x05, 0xFF};
+    id object = [self decodeBytes:encoded length:sizeof(encoded)];
+    
+    NSData *expectedData = [NSData dataWithBytes:(UInt8[]){0x01, 0x02, 0x03, 0x04, 0x05} length:5];
+    XCTAssertEqualObjects(object, YKFCBORByteString(expectedData));
+    XCTAssertEqualObjects(self.receivedStringData, expectedData);
+}
+
+- (void)testIndefiniteLengthTextStringDecoding {
+    // (_ "strea", "ming")
+    UInt8 encoded[] = {0x7F, 0x65, 0x73, 0x74, 0x72, 0x65, 0x61, 0x64, 0x6D, 0x69, 0x6E, 0x67, 0xFF};
+    id object = [self decodeBytes:encoded length:sizeof(encoded)];
+    
+    XCTAssertEqualObjects(object, YKFCBORTextString(@"streaming"));
+}
+
+- (void)testIndefiniteLengthArrayDecoding {
+    // [_ 1, [2, 3], [_ 4, 5]]
+    UInt8 encoded[] = {0x9F, 0x01, 0x82, 0x02, 0x03, 0x9F, 0x04, 0x05, 0xFF, 0xFF};
+    id object = [self decodeBytes:encoded length:sizeof(encoded)];
+    
+    NSArray *expectedArray = @[YKFCBORInteger(1),
+                               YKFCBORArray((@[YKFCBORInteger(2), YKFCBORInteger(3)])),
+                               YKFCBORArray((@[YKFCBORInteger(4), YKFCBORInteger(5)]))];
+    XCTAssertEqualObjects(object, YKFCBORArray(expectedArray));
+}
+
+- (void)testIndefiniteLengthMapDecoding {
+    // {_ "a": 1, "b": [_ 2, 3]}
+    UInt8 encoded[] = {0xBF, 0x61, 0x61, 0x01, 0x61, 0x62, 0x9F, 0x02, 0x03, 0xFF, 0xFF};
+    id object = [self decodeBytes:encoded length:sizeof(encoded)];
+    
+    NSDictionary *expectedMap = @{YKFCBORTextString(@"a"): YKFCBORInteger(1),
+                                  YKFCBORTextString(@"b"): YKFCBORArray((@[YKFCBORInteger(2), YKFCBORInteger(3)]))};
+    XCTAssertEqualObjects(object, YKFCBORMap(expectedMap));
+}
+
+- (void)testIndefiniteLengthArrayElementsAreReportedBeforeBreak {
+    UInt8 encoded[] = {0x9F, 0xA1, 0x01, 0x02, 0xA1, 0x01, 0x03};
+    
+    XCTAssertTrue([self.decoder appendData:[NSData dataWithBytes:encoded length:sizeof(encoded)]]);
+    XCTAssertEqual(self.decodedObjects.count, 0);
+    
+    // Two maps and their values.
+    NSArray *expectedObjects = @[YKFCBORInteger(2), YKFCBORMap(@{YKFCBORInteger(1): YKFCBORInteger(2)}),
+                                 YKFCBORInteger(3), YKFCBORMap(@{YKFCBORInteger(1): YKFCBORInteger(3)})];
+    XCTAssertEqualObjects(self.nestedObjects, expectedObjects);
+    
+    UInt8 breakCode = 0xFF;
+    XCTAssertTrue([self.decoder appendData:[NSData dataWithBytes:&breakCode length:1]]);
+    XCTAssertEqual(self.decodedObjects.count, 1);
+}
+
+#pragma mark - Tags, Simple Values and Floats Tests
+
+- (void)testTagDecoding {
+    // 1(1363896240)
+    UInt8 encoded[] = {0xC1, 0x1A, 0x51, 0x4B, 0x67, 0xB0};
+    YKFCBORTaggedItem *object = [self decodeBytes:encoded length:sizeof(encoded)];
+    
+    XCTAssertTrue([object isKindOfClass:YKFCBORTaggedItem.class]);
+    XCTAssertEqual(object.tag, 1);
+    XCTAssertEqualObjects(object.item, YKFCBORInteger(1363896240));
+    XCTAssertEqualObjects([YKFCBORDecoder convertCBORObjectToFoundationType:object], @(1363896240));
+}
+
+- (void)testSimpleValueDecoding {
+    UInt8 falseValue[] = {0xF4};
+    XCTAssertEqualObjects([self decodeBytes:falseValue length:1], YKFCBORBool(NO));
+    
+    UInt8 nullValue[] = {0xF6};
+    id object = [self decodeBytes:nullValue length:1];
+    XCTAssertEqualObjects(object, YKFCBORNull());
+    XCTAssertEqualObjects([YKFCBORDecoder convertCBORObjectToFoundationType:object], [NSNull null]);
+    
+    UInt8 undefinedValue[] = {0xF7};
+    XCTAssertEqualObjects([self decodeBytes:undefinedValue length:1], YKFCBORSimpleValue(YKFCBORSimpleValueUndefined));
+    
+    UInt8 shortValue[] = {0xF0};
+    XCTAssertEqualObjects([self decodeBytes:shortValue length:1], YKFCBORSimpleValue(16));
+    
+    UInt8 extendedValue[] = {0xF8, 0xFF};
+    XCTAssertEqualObjects([self decodeBytes:extendedValue length:2], YKFCBORSimpleValue(255));
+}
+
+- (void)testFloatDecoding {
+    // Test vectors from RFC 8949, Appendix A.
+    UInt8 halfOne[] = {0xF9, 0x3C, 0x00};
+    XCTAssertEqualObjects([self decodeBytes:halfOne length:sizeof(halfOne)], YKFCBORFloat(1.0));
+    
+    UInt8 halfMax[] = {0xF9, 0x7B, 0xFF};
+    XCTAssertEqualObjects([self decodeBytes:halfMax length:sizeof(halfMax)], YKFCBORFloat(65504.0));
+    
+    UInt8 halfSubnormal[] = {0xF9, 0x00, 0x01};
+    XCTAssertEqualObjects([self decodeBytes:halfSubnormal length:sizeof(halfSubnormal)], YKFCBORFloat(5.9604644775390625e-8));
+    
+    UInt8 halfNegative[] = {0xF9, 0xC4, 0x00};
+    XCTAssertEqualObjects([self decodeBytes:halfNegative length:sizeof(halfNegative)], YKFCBORFloat(-4.0));
+    
+    UInt8 halfInfinity[] = {0xF9, 0x7C, 0x00};
+    XCTAssertEqualObjects([self decodeBytes:halfInfinity length:sizeof(halfInfinity)], YKFCBORFloat(INFINITY));
+    
+    UInt8 single[] = {0xFA, 0x47, 0xC3, 0x50, 0x00};
+    XCTAssertEqualObjects([self decodeBytes:single length:sizeof(single)], YKFCBORFloat(100000.0));
+    
+    UInt8 doublePrecision[] = {0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A};
+    XCTAssertEqualObjects([self decodeBytes:doublePrecision length:sizeof(doublePrecision)], YKFCBORFloat(1.1));
+    
+    UInt8 halfNaN[] = {0xF9, 0x7E, 0x00};
+    YKFCBORFloat *nanObject = [self decodeBytes:halfNaN length:sizeof(halfNaN)];
+    XCTAssertTrue(isnan(nanObject.value));
+}
+
+#pragma mark - Malformed Input Tests
+
+- (void)testMalformedInput {
+    // Break code outside of an indefinite-length item.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0xFF} length:1]);
+    
+    // Break code in a definite-length array.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0x82, 0x01, 0xFF} length:3]);
+    
+    // Integer in an indefinite-length byte string.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0x5F, 0x01} length:2]);
+    
+    // Text string chunk in an indefinite-length byte string.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0x5F, 0x61, 0x61} length:3]);
+    
+    // Nested indefinite-length string.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0x5F, 0x5F} length:2]);
+    
+    // Reserved additional information.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0x1C} length:1]);
+    
+    // Indefinite-length integer.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0x1F} length:1]);
+    
+    // Duplicated map key.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0xA2, 0x01, 0x01, 0x01, 0x02} length:5]);
+    
+    // Indefinite-length map with a key without value.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0xBF, 0x01, 0xFF} length:3]);
+    
+    // Map key which cannot be hashed.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0xA1, 0x80, 0x01} length:3]);
+    
+    // Simple value below 32 in the extended form.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0xF8, 0x10} length:2]);
+    
+    // Invalid UTF-8.
+    XCTAssertTrue([self isMalformed:(UInt8[]){0x61, 0xFF} length:2]);
+}
+
+- (void)testMalformedInputNesting {
+    // Deeper than the maximum nesting depth.
+    UInt8 encoded[32];
+    memset(encoded, 0x81, sizeof(encoded));
+    
+    XCTAssertTrue([self isMalformed:encoded length:sizeof(encoded)]);
+}
+
+- (void)testFailedDecoderRequiresReset {
+    UInt8 breakCode = 0xFF;
+    XCTAssertFalse([self.decoder appendData:[NSData dataWithBytes:&breakCode length:1]]);
+    
+    UInt8 integer = 0x01;
+    XCTAssertFalse([self.decoder appendData:[NSData dataWithBytes:&integer length:1]]);
+    XCTAssertEqual(self.decodedObjects.count, 0);
+    
+    [self.decoder reset];
+    XCTAssertTrue([self.decoder appendData:[NSData dataWithBytes:&integer length:1]]);
+    XCTAssertEqualObjects(self.decodedObjects.firstObject, YKFCBORInteger(1));
+}
+
+@end
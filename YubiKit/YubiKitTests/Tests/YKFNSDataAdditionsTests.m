@@ -9,6 +9,9 @@
 #import <XCTest/XCTest.h>
 
 #import "YKFNSDataAdditions.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFNSMutableDataAdditions.h"
+#import "MF_Base32Additions.h"
 
 @interface YKFNSDataAdditionsTests : XCTestCase
 @end
@@ -43,4 +46,221 @@
     XCTAssertNil(result, @"Returned nil because the secret contains symbol that could not be decoded");
 }
 
+#pragma mark - Hex
+
+- (void)test_WhenDataIsHexEncoded_StringMatchesFormattedBytes {
+    NSMutableData *data = [[NSMutableData alloc] initWithCapacity:256];
+    for (NSUInteger i = 0; i < 256; ++i) {
+        UInt8 byte = i;
+        [data appendBytes:&byte length:1];
+    }
+    XCTAssertEqualObjects([data ykf_hexadecimalString], [self referenceHexadecimalStringFromData:data]);
+    XCTAssertEqualObjects([[NSData data] ykf_hexadecimalString], @"");
+}
+
+- (void)test_WhenHexStringIsDecoded_DataMatchesBytes {
+    UInt8 bytes[] = {0x00, 0x9f, 0xa0, 0xff, 0x5c};
+    NSData *expected = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    XCTAssertEqualObjects([NSData ykf_dataWithHexadecimalString:@"009fa0ff5c"], expected);
+    XCTAssertEqualObjects([NSData ykf_dataWithHexadecimalString:@"009FA0FF5C"], expected);
+    XCTAssertEqualObjects([NSData ykf_dataWithHexadecimalString:@""], [NSData data]);
+}
+
+- (void)test_WhenHexStringIsNotHex_DataIsNil {
+    NSArray<NSString *> *strings = @[@"0", @"abc", @"0g", @"g0", @"00 ", @"0x00", @"/0", @":0", @"@0", @"`0", @"\u00e90"];
+    for (NSString *string in strings) {
+        XCTAssertNil([NSData ykf_dataWithHexadecimalString:string], @"%@", string);
+    }
+}
+
+- (void)test_WhenDataIsEncodedAndDecoded_DataIsUnchanged {
+    NSData *data = [NSData ykf_randomDataOfSize:4096];
+    XCTAssertEqualObjects([NSData ykf_dataWithHexadecimalString:[data ykf_hexadecimalString]], data);
+}
+
+- (void)test_HexEncodingPerformance {
+    NSData *data = [NSData ykf_randomDataOfSize:3 * 1024];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 1000; ++i) {
+            XCTAssertEqual([data ykf_hexadecimalString].length, 6 * 1024);
+        }
+    }];
+}
+
+- (void)test_HexEncodingWithFormatPerformance {
+    // The per byte format implementation replaced by the table encoder, as a reference for test_HexEncodingPerformance.
+    NSData *data = [NSData ykf_randomDataOfSize:3 * 1024];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 1000; ++i) {
+            XCTAssertEqual([self referenceHexadecimalStringFromData:data].length, 6 * 1024);
+        }
+    }];
+}
+
+- (void)test_HexDecodingPerformance {
+    NSString *hexString = [[NSData ykf_randomDataOfSize:3 * 1024] ykf_hexadecimalString];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 1000; ++i) {
+            XCTAssertEqual([NSData ykf_dataWithHexadecimalString:hexString].length, 3 * 1024);
+        }
+    }];
+}
+
+#pragma mark - WebSafe Base64
+
+- (void)test_WhenDataIsWebsafeBase64Encoded_StringMatchesTestVectors {
+    // RFC 4648, section 10, without padding.
+    NSDictionary<NSString *, NSString *> *vectors = @{@"": @"", @"f": @"Zg", @"fo": @"Zm8", @"foo": @"Zm9v",
+                                                      @"foob": @"Zm9vYg", @"fooba": @"Zm9vYmE", @"foobar": @"Zm9vYmFy"};
+    for (NSString *input in vectors) {
+        NSData *data = [input dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertEqualObjects([data ykf_websafeBase64EncodedString], vectors[input]);
+        
+        NSData *decoded = [[NSData alloc] ykf_initWithWebsafeBase64EncodedString:vectors[input] dataLength:data.length];
+        XCTAssertEqualObjects(decoded, data);
+    }
+    
+    UInt8 bytes[] = {0xfb, 0xff, 0xbf};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    XCTAssertEqualObjects([data ykf_websafeBase64EncodedString], @"-_-_");
+}
+
+- (void)test_WhenDataIsWebsafeBase64Encoded_StringMatchesFoundationBase64 {
+    for (NSUInteger length = 0; length < 100; ++length) {
+        NSData *data = [NSData ykf_randomDataOfSize:length];
+        NSString *expected = [data base64EncodedStringWithOptions:0];
+        expected = [expected stringByReplacingOccurrencesOfString:@"+" withString:@"-"];
+        expected = [expected stringByReplacingOccurrencesOfString:@"/" withString:@"_"];
+        expected = [expected stringByReplacingOccurrencesOfString:@"=" withString:@""];
+        
+        NSString *encoded = [data ykf_websafeBase64EncodedString];
+        XCTAssertEqualObjects(encoded, expected);
+        XCTAssertEqualObjects([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:encoded dataLength:length], data);
+    }
+}
+
+- (void)test_WhenWebsafeBase64StringHasPaddingOrStandardSymbols_DataIsDecoded {
+    UInt8 bytes[] = {0xfb, 0xff};
+    NSData *expected = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    XCTAssertEqualObjects([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:@"-_8=" dataLength:2], expected);
+    XCTAssertEqualObjects([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:@"+/8" dataLength:2], expected);
+}
+
+- (void)test_WhenWebsafeBase64StringIsInvalid_DataIsNil {
+    NSArray<NSString *> *strings = @[@"Z", @"Zm9vY", @"Zm9v!", @"Zm 9v", @"Zm9v===", @"=Zm9"];
+    for (NSString *string in strings) {
+        XCTAssertNil([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:string dataLength:string.length * 3 / 4], @"%@", string);
+    }
+    // The length of the string does not match the expected data length.
+    XCTAssertNil([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:@"Zm9v" dataLength:64]);
+}
+
+- (void)test_WhenJSONStringIsAppended_JSONIsParsed {
+    NSArray<NSString *> *strings = @[@"", @"https://example.com", @"quote\" backslash\\ tab\t newline\n", @"\u00e9\u4e2d\U0001F600", @"\x01\x1f"];
+    for (NSString *string in strings) {
+        NSMutableData *json = [NSMutableData data];
+        [json ykf_appendUTF8String:@"["];
+        [json ykf_appendJSONString:string];
+        [json ykf_appendUTF8String:@"]"];
+        
+        NSArray *parsed = [NSJSONSerialization JSONObjectWithData:json options:0 error:nil];
+        XCTAssertEqualObjects(parsed.firstObject, string);
+    }
+}
+
+- (void)test_WebsafeBase64EncodingPerformance {
+    NSData *data = [NSData ykf_randomDataOfSize:1024];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10000; ++i) {
+            XCTAssertEqual([data ykf_websafeBase64EncodedString].length, 1366);
+        }
+    }];
+}
+
+- (void)test_WebsafeBase64DecodingPerformance {
+    NSString *string = [[NSData ykf_randomDataOfSize:64] ykf_websafeBase64EncodedString];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 100000; ++i) {
+            XCTAssertEqual([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:string dataLength:64].length, 64);
+        }
+    }];
+}
+
+#pragma mark - Base32
+
+- (void)test_WhenSecretIsBase32Decoded_DataMatchesTestVectors {
+    // RFC 4648, section 10.
+    NSDictionary<NSString *, NSString *> *vectors = @{@"": @"", @"MY======": @"f", @"MZXQ====": @"fo", @"MZXW6===": @"foo",
+                                                      @"MZXW6YQ=": @"foob", @"MZXW6YTB": @"fooba", @"MZXW6YTBOI======": @"foobar"};
+    for (NSString *input in vectors) {
+        NSData *expected = [vectors[input] dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertEqualObjects([NSData ykf_dataWithBase32String:input], expected, @"%@", input);
+        XCTAssertEqualObjects([NSData ykf_dataWithBase32String:input.lowercaseString], expected, @"%@", input);
+        NSString *unpadded = [input stringByReplacingOccurrencesOfString:@"=" withString:@""];
+        XCTAssertEqualObjects([NSData ykf_dataWithBase32String:unpadded], expected, @"%@", input);
+    }
+}
+
+- (void)test_WhenSecretContainsWhitespace_WhitespaceIsSkipped {
+    NSData *expected = [NSData ykf_dataWithBase32String:@"HXDMVJECJJWSRB3HWIZR4IFUGFTMXBOZ"];
+    XCTAssertEqualObjects([NSData ykf_dataWithBase32String:@"hxdm vjec jjws rb3h\twizr 4ifu\r\ngftm xboz\n"], expected);
+}
+
+- (void)test_WhenSecretIsBase32Decoded_DataMatchesPreviousDecoder {
+    NSString *alphabet = @"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567abcdefghijklmnopqrstuvwxyz";
+    for (NSUInteger length = 0; length < 64; ++length) {
+        NSMutableString *secret = [NSMutableString stringWithCapacity:length];
+        for (NSUInteger i = 0; i < length; ++i) {
+            [secret appendString:[alphabet substringWithRange:NSMakeRange(arc4random_uniform((UInt32)alphabet.length), 1)]];
+        }
+        XCTAssertEqualObjects([NSData ykf_dataWithBase32String:secret], [NSData dataWithBase32String:secret], @"%@", secret);
+    }
+}
+
+- (void)test_WhenSecretContainsNonASCIISymbols_ObjectNil {
+    XCTAssertNil([NSData ykf_dataWithBase32String:@"AAAA\u00c5AAA"]);
+    XCTAssertNil([NSData ykf_dataWithBase32String:@"AAAA-AAA"]);
+}
+
+- (void)test_Base32BulkDecodingPerformance {
+    NSArray<NSString *> *secrets = [self base32SecretsWithCount:5000];
+    [self measureBlock:^{
+        for (NSString *secret in secrets) {
+            XCTAssertEqual([NSData ykf_dataWithBase32String:secret].length, 20);
+        }
+    }];
+}
+
+- (void)test_Base32BulkDecodingWithRegexPerformance {
+    // The regular expression validation replaced by the table decoder, as a reference for test_Base32BulkDecodingPerformance.
+    NSArray<NSString *> *secrets = [self base32SecretsWithCount:5000];
+    [self measureBlock:^{
+        for (NSString *secret in secrets) {
+            NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:@"[A-Za-z2-7=]*" options:0 error:nil];
+            NSRange range = NSMakeRange(0, secret.length);
+            XCTAssertTrue(NSEqualRanges([regex rangeOfFirstMatchInString:secret options:0 range:range], range));
+            XCTAssertEqual([NSData dataWithBase32String:secret].length, 20);
+        }
+    }];
+}
+
+#pragma mark - Helpers
+
+- (NSArray<NSString *> *)base32SecretsWithCount:(NSUInteger)count {
+    NSMutableArray<NSString *> *secrets = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        [secrets addObject:[[NSData ykf_randomDataOfSize:20] ykf_base32String]];
+    }
+    return secrets;
+}
+
+- (NSString *)referenceHexadecimalStringFromData:(NSData *)data {
+    const unsigned char *dataBuffer = (const unsigned char *)data.bytes;
+    NSMutableString *hexString = [NSMutableString stringWithCapacity:(data.length * 2)];
+    for (NSUInteger i = 0; i < data.length; ++i) {
+        [hexString appendFormat:@"%02x", (unsigned int)dataBuffer[i]];
+    }
+    return [NSString stringWithString:hexString];
+}
+
 @end
@@ -53,6 +53,14 @@ static NSString* const YKFOATHCredentialValidatorTestsVeryLargeSecret = @"HXDMVJ
     XCTAssertNotNil(credential, @"Valid TOTP url was not parsed correctly");
 }
 
+- (void)test_WhenCredentialIsCreatedWithLowercaseSpacedPaddedSecret_SecretIsDecoded {
+    NSString *url = @"otpauth://totp/ACME:john@example.com?secret=hxdm%20vjec%20jjws%20rb3h%20wizr%204ifu%20gftm%20xboz%3D%3D&issuer=ACME";
+    YKFOATHCredentialTemplate *credential = [[YKFOATHCredentialTemplate alloc] initWithURL:[NSURL URLWithString:url]];
+    XCTAssertNotNil(credential);
+    XCTAssertEqualObjects(credential.secret, [NSData ykf_dataWithBase32String:@"HXDMVJECJJWSRB3HWIZR4IFUGFTMXBOZ"]);
+    XCTAssertEqual(credential.secret.length, 20);
+}
+
 - (void)test_WhenCredentialIsCreatedWithValidHOTPURL_CredentialIsNotNil {
     NSString *url = @"otpauth://hotp/ACME:john@example.com?secret=HXDMVJECJJWSRB3HWIZR4IFUGFTMXBOZ&issuer=ACME&algorithm=SHA1&digits=6&counter=1234";
     YKFOATHCredentialTemplate *credential = [[YKFOATHCredentialTemplate alloc] initWithURL:[NSURL URLWithString:url]];
@@ -13,10 +13,13 @@
 // limitations under the License.
 
 #import <XCTest/XCTest.h>
+#import <CoreNFC/CoreNFC.h>
 #import "YKFTestCase.h"
 #import "FakeYKFConnectionController.h"
 #import "YKFSmartCardInterface.h"
 #import "YKFAPDU+Private.h"
+#import "YKFAPDUError.h"
+#import "YKFVersion.h"
 
 @interface YKFSmartCardInterfaceTests: YKFTestCase
 
@@ -96,4 +99,303 @@
     XCTAssert(result == XCTWaiterResultCompleted, @"");
 }
 
+#pragma mark - Command chaining
+
+- (void)test_WhenChainingIsEnabled_LargeCommandsAreSentAsChainedShortCommands {
+    self.keyConnectionController.commandChainingEnabled = YES;
+    self.keyConnectionController.commandChainingBlockSize = 255;
+    
+    NSMutableData *commandData = [NSMutableData dataWithLength:600];
+    ((UInt8 *)commandData.mutableBytes)[599] = 0xaa;
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xdb p1:0x3f p2:0xff data:commandData type:YKFAPDUTypeExtended];
+    
+    NSData *blockResponse = [NSData dataFromHexString:@"9000"];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[blockResponse, blockResponse, [NSData dataFromHexString:@"01029000"]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"CommandChaining"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(data, [NSData dataFromHexString:@"0102"]);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray<YKFAPDU *> *commands = self.keyConnectionController.executionCommandSequence;
+    XCTAssertEqual(commands.count, 3);
+    NSData *header = [NSData dataFromHexString:@"10db3fff ff"];
+    XCTAssertEqualObjects([commands[0].apduData subdataWithRange:NSMakeRange(0, 5)], header);
+    XCTAssertEqualObjects([commands[1].apduData subdataWithRange:NSMakeRange(0, 5)], header);
+    XCTAssertEqualObjects([commands[2].apduData subdataWithRange:NSMakeRange(0, 5)], [NSData dataFromHexString:@"00db3fff 5a"]);
+    
+    NSMutableData *sentData = [NSMutableData data];
+    for (YKFAPDU *command in commands) {
+        [sentData appendData:[command.apduData subdataWithRange:NSMakeRange(5, command.apduData.length - 5)]];
+    }
+    XCTAssertEqualObjects(sentData, commandData);
+}
+
+- (void)test_WhenChainingIsEnabled_ChainStopsAtTheFirstFailingBlock {
+    self.keyConnectionController.commandChainingEnabled = YES;
+    self.keyConnectionController.commandChainingBlockSize = 100;
+    
+    NSData *commandData = [NSMutableData dataWithLength:450];
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xdb p1:0x3f p2:0xff data:commandData type:YKFAPDUTypeExtended];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[NSData dataFromHexString:@"9000"], [NSData dataFromHexString:@"6a80"]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"CommandChainingError"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(data);
+        XCTAssertEqual(error.code, YKFAPDUErrorCodeWrongData);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    XCTAssertEqual(self.keyConnectionController.executionCommandSequence.count, 2);
+}
+
+- (void)test_WhenChainingIsDisabled_LargeCommandsAreSentAsExtendedCommands {
+    NSData *commandData = [NSMutableData dataWithLength:600];
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xdb p1:0x3f p2:0xff data:commandData type:YKFAPDUTypeExtended];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[NSData dataFromHexString:@"9000"]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ExtendedCommand"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    XCTAssertEqual(self.keyConnectionController.executionCommandSequence.count, 1);
+    XCTAssertEqual(self.keyConnectionController.executionCommand, apdu);
+}
+
+#pragma mark - Extended length
+
+- (NSData *)responseWithLength:(NSUInteger)length statusCode:(UInt16)statusCode {
+    NSMutableData *response = [NSMutableData dataWithLength:length + 2];
+    UInt8 *bytes = response.mutableBytes;
+    for (NSUInteger i = 0; i < length; ++i) {
+        bytes[i] = (UInt8)i;
+    }
+    bytes[length] = statusCode >> 8;
+    bytes[length + 1] = statusCode & 0xff;
+    return response;
+}
+
+- (void)test_WhenExtendedLengthIsSupported_ShortCommandsAskForTheWholeResponse {
+    self.keyConnectionController.supportsExtendedLength = YES;
+    [self.smartCardInterface configureWithVersion:[[YKFVersion alloc] initWithString:@"5.4.3"]];
+    XCTAssertTrue(self.smartCardInterface.usesExtendedLength);
+    
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeShort];
+    apdu.mayReturnLongResponse = YES;
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[self responseWithLength:600 statusCode:0x9000]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ExtendedLength"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(data.length, 600);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    XCTAssertEqualObjects(self.keyConnectionController.executionCommand.apduData, [NSData dataFromHexString:@"00cb3fff 000005 5c035fc105 0000"]);
+    XCTAssertEqual(self.smartCardInterface.lastCommandRoundTrips, 1);
+    XCTAssertEqual(self.smartCardInterface.lastCommandSavedRoundTrips, 2);
+    XCTAssertEqual(self.smartCardInterface.savedRoundTrips, 2);
+}
+
+- (void)test_WhenExtendedLengthIsSupported_CommandsWithShortResponsesAreNotRewritten {
+    self.keyConnectionController.supportsExtendedLength = YES;
+    [self.smartCardInterface configureWithVersion:[[YKFVersion alloc] initWithString:@"5.4.3"]];
+    
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0x20 p1:0x00 p2:0x80 data:[NSData dataFromHexString:@"313233343536ffff"] type:YKFAPDUTypeShort];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[self responseWithLength:0 statusCode:0x9000]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ShortResponse"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    XCTAssertEqualObjects(self.keyConnectionController.executionCommand.apduData, apdu.apduData);
+}
+
+- (void)test_WhenTheKeyRejectsTheExtendedCommand_TheCommandIsSentWithShortLength {
+    self.keyConnectionController.supportsExtendedLength = YES;
+    [self.smartCardInterface configureWithVersion:[[YKFVersion alloc] initWithString:@"5.4.3"]];
+    
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa1 p1:0x00 p2:0x00 data:[NSData data] type:YKFAPDUTypeShort];
+    apdu.mayReturnLongResponse = YES;
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[self responseWithLength:0 statusCode:0x6700],
+                                                                         [self responseWithLength:256 statusCode:0x6100],
+                                                                         [self responseWithLength:100 statusCode:0x9000]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ExtendedLengthRejected"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(data.length, 356);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray<YKFAPDU *> *commands = self.keyConnectionController.executionCommandSequence;
+    XCTAssertEqual(commands.count, 3);
+    XCTAssertEqualObjects(commands[0].apduData, [NSData dataFromHexString:@"00a10000 000000"]);
+    XCTAssertEqualObjects(commands[1].apduData, apdu.apduData);
+    XCTAssertEqualObjects(commands[2].apduData, [NSData dataFromHexString:@"00c0000000"]);
+    XCTAssertFalse(self.smartCardInterface.usesExtendedLength);
+}
+
+- (void)test_WhenTheTagRejectsTheExtendedCommand_TheCommandIsSentWithShortLength {
+    self.keyConnectionController.supportsExtendedLength = YES;
+    [self.smartCardInterface configureWithVersion:[[YKFVersion alloc] initWithString:@"5.4.3"]];
+    
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xa1 p1:0x00 p2:0x00 data:[NSData data] type:YKFAPDUTypeShort];
+    apdu.mayReturnLongResponse = YES;
+    NSError *transceiveError = [NSError errorWithDomain:NFCErrorDomain code:NFCReaderTransceiveErrorTagResponseError userInfo:nil];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[NSData data], [self responseWithLength:100 statusCode:0x9000]];
+    self.keyConnectionController.commandExecutionResponseErrorSequence = @[transceiveError];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ExtendedLengthTransceiveError"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(data.length, 100);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray<YKFAPDU *> *commands = self.keyConnectionController.executionCommandSequence;
+    XCTAssertEqual(commands.count, 2);
+    XCTAssertEqualObjects(commands.lastObject.apduData, apdu.apduData);
+    XCTAssertFalse(self.smartCardInterface.usesExtendedLength);
+}
+
+- (void)test_WhenExtendedLengthIsSupported_RemainingDataIsReadWithExtendedLe {
+    self.keyConnectionController.supportsExtendedLength = YES;
+    [self.smartCardInterface configureWithVersion:[[YKFVersion alloc] initWithString:@"5.4.3"]];
+    
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeShort];
+    apdu.mayReturnLongResponse = YES;
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[self responseWithLength:256 statusCode:0x6100],
+                                                                         [self responseWithLength:700 statusCode:0x9000]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ExtendedLengthRemaining"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(data.length, 956);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    XCTAssertEqualObjects(self.keyConnectionController.executionCommand.apduData, [NSData dataFromHexString:@"00c00000 000000"]);
+    XCTAssertEqual(self.smartCardInterface.lastCommandRoundTrips, 2);
+    XCTAssertEqual(self.smartCardInterface.lastCommandSavedRoundTrips, 2);
+}
+
+- (void)test_WhenTheKeyRejectsTheExtendedSendRemainingCommand_RemainingDataIsReadWithShortLength {
+    self.keyConnectionController.supportsExtendedLength = YES;
+    [self.smartCardInterface configureWithVersion:[[YKFVersion alloc] initWithString:@"5.4.3"]];
+    
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeShort];
+    apdu.mayReturnLongResponse = YES;
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[self responseWithLength:256 statusCode:0x6100],
+                                                                         [self responseWithLength:0 statusCode:0x6700],
+                                                                         [self responseWithLength:256 statusCode:0x6100],
+                                                                         [self responseWithLength:100 statusCode:0x9000]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ExtendedSendRemainingRejected"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(data.length, 612);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray<YKFAPDU *> *commands = self.keyConnectionController.executionCommandSequence;
+    XCTAssertEqual(commands.count, 4);
+    XCTAssertEqualObjects(commands[1].apduData, [NSData dataFromHexString:@"00c00000 000000"]);
+    XCTAssertEqualObjects(commands[2].apduData, [NSData dataFromHexString:@"00c0000000"]);
+    XCTAssertEqualObjects(commands[3].apduData, [NSData dataFromHexString:@"00c0000000"]);
+    XCTAssertFalse(self.smartCardInterface.usesExtendedLength);
+}
+
+- (void)test_WhenTheKeyDoesNotSupportExtendedLength_ResponsesAreReadInChunks {
+    self.keyConnectionController.supportsExtendedLength = YES;
+    [self.smartCardInterface configureWithVersion:[[YKFVersion alloc] initWithString:@"3.4.0"]];
+    XCTAssertFalse(self.smartCardInterface.usesExtendedLength);
+    
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeShort];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[self responseWithLength:256 statusCode:0x6100],
+                                                                         [self responseWithLength:100 statusCode:0x9000]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ShortLength"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(data.length, 356);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray<YKFAPDU *> *commands = self.keyConnectionController.executionCommandSequence;
+    XCTAssertEqualObjects(commands.firstObject.apduData, apdu.apduData);
+    XCTAssertEqualObjects(commands.lastObject.apduData, [NSData dataFromHexString:@"00c0000000"]);
+    XCTAssertEqual(self.smartCardInterface.lastCommandRoundTrips, 2);
+    XCTAssertEqual(self.smartCardInterface.lastCommandSavedRoundTrips, 0);
+}
+
+#pragma mark - Response reassembly
+
+- (void)test_WhenTheResponseIsSentInParts_PartsAreReassembledInOrder {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeShort];
+    NSArray<NSData *> *responses = @[[self responseWithLength:256 statusCode:0x6100],
+                                     [self responseWithLength:256 statusCode:0x612c],
+                                     [self responseWithLength:44 statusCode:0x9000]];
+    self.keyConnectionController.commandExecutionResponseDataSequence = responses;
+    
+    NSMutableData *expectedData = [NSMutableData new];
+    for (NSData *response in responses) {
+        [expectedData appendData:[response subdataWithRange:NSMakeRange(0, response.length - 2)]];
+    }
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Reassembly"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(data, expectedData);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray<YKFAPDU *> *commands = self.keyConnectionController.executionCommandSequence;
+    XCTAssertEqual(commands.count, 3);
+    XCTAssertEqualObjects(commands[1].apduData, [NSData dataFromHexString:@"00c0000000"]);
+    XCTAssertEqual(commands[1], commands[2], @"The send remaining command is reused for all the parts.");
+    XCTAssertEqual(self.smartCardInterface.lastCommandRoundTrips, 3);
+}
+
+- (void)test_WhenTheReassemblyFails_ErrorIsReturned {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xcb p1:0x3f p2:0xff data:[NSData dataFromHexString:@"5c035fc105"] type:YKFAPDUTypeShort];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[[self responseWithLength:256 statusCode:0x6100],
+                                                                         [NSData dataFromHexString:@"6a82"]];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"ReassemblyError"];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(data);
+        XCTAssertEqual(error.code, 0x6a82);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+}
+
 @end
@@ -0,0 +1,141 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFTLVRecord.h"
+#import "YKFTLVCursor.h"
+
+@interface YKFTLVCursorTests: YKFTestCase
+@end
+
+@implementation YKFTLVCursorTests
+
+- (void)test_next {
+    NSData *data = [NSData dataFromHexString:@"1e03112233 7f4900 a0818a112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899112233445566778899aabbcc"];
+    YKFTLVCursor cursor = YKFTLVCursorMake(data);
+    YKFTLVView view;
+    
+    XCTAssertTrue(YKFTLVCursorNext(&cursor, &view));
+    XCTAssertEqual(view.tag, 0x1e);
+    XCTAssertTrue(NSEqualRanges(view.valueRange, NSMakeRange(2, 3)));
+    XCTAssertTrue(NSEqualRanges(view.recordRange, NSMakeRange(0, 5)));
+    XCTAssertEqualObjects(YKFTLVCursorValue(&cursor, &view), [NSData dataFromHexString:@"112233"]);
+    
+    XCTAssertTrue(YKFTLVCursorNext(&cursor, &view));
+    XCTAssertEqual(view.tag, 0x7f49);
+    XCTAssertEqual(YKFTLVCursorValue(&cursor, &view).length, 0);
+    
+    XCTAssertTrue(YKFTLVCursorNext(&cursor, &view));
+    XCTAssertEqual(view.tag, 0xa0);
+    XCTAssertTrue(NSEqualRanges(view.valueRange, NSMakeRange(11, 0x8a)));
+    XCTAssertTrue(NSEqualRanges(view.recordRange, NSMakeRange(8, 3 + 0x8a)));
+    
+    XCTAssertFalse(YKFTLVCursorNext(&cursor, &view));
+    XCTAssertTrue(YKFTLVCursorIsAtEnd(&cursor));
+}
+
+- (void)test_nextMalformed {
+    NSArray<NSString *> *malformed = @[@"1e031122", @"1f", @"1f81", @"1e", @"1e80", @"1e8203", @"1e89010203040506070809", @"a1852233"];
+    for (NSString *hex in malformed) {
+        NSData *data = [NSData dataFromHexString:hex];
+        YKFTLVCursor cursor = YKFTLVCursorMake(data);
+        YKFTLVView view;
+        XCTAssertFalse(YKFTLVCursorNext(&cursor, &view), @"%@", hex);
+        XCTAssertFalse(YKFTLVCursorIsAtEnd(&cursor), @"%@", hex);
+        // The cursor stays stopped.
+        XCTAssertFalse(YKFTLVCursorNext(&cursor, &view), @"%@", hex);
+    }
+}
+
+- (void)test_readTags {
+    NSData *data = [NSData dataFromHexString:@"0101aa 0202bbbb 0101cc 0300"];
+    YKFTLVCursor cursor = YKFTLVCursorMake(data);
+    YKFTLVTag tags[] = {0x01, 0x03, 0x04};
+    YKFTLVView views[3];
+    XCTAssertTrue(YKFTLVCursorReadTags(&cursor, tags, 3, views));
+    
+    // The first record with the tag is kept.
+    XCTAssertEqualObjects(YKFTLVCursorValue(&cursor, &views[0]), [NSData dataFromHexString:@"aa"]);
+    XCTAssertEqualObjects(YKFTLVCursorValue(&cursor, &views[1]), [NSData data]);
+    XCTAssertEqual(views[2].valueRange.location, NSNotFound);
+    XCTAssertNil(YKFTLVCursorValue(&cursor, &views[2]));
+}
+
+- (void)test_readTagsMalformed {
+    NSData *data = [NSData dataFromHexString:@"0101aa 0205bbbb"];
+    YKFTLVCursor cursor = YKFTLVCursorMake(data);
+    YKFTLVTag tags[] = {0x01};
+    YKFTLVView views[1];
+    XCTAssertFalse(YKFTLVCursorReadTags(&cursor, tags, 1, views));
+}
+
+- (void)test_nestedDescent {
+    // 53 { 70 { certificate } 71 { 00 } } followed by fe 00
+    NSData *data = [NSData dataFromHexString:@"530a 7005 3003020101 710100 fe00"];
+    YKFTLVCursor cursor = YKFTLVCursorMake(data);
+    YKFTLVTag objectTag = 0x53;
+    YKFTLVView objectView;
+    XCTAssertTrue(YKFTLVCursorReadTags(&cursor, &objectTag, 1, &objectView));
+    
+    YKFTLVCursor objectCursor = YKFTLVCursorMakeWithValue(&cursor, &objectView);
+    YKFTLVTag tags[] = {0x70, 0x71};
+    YKFTLVView views[2];
+    XCTAssertTrue(YKFTLVCursorReadTags(&objectCursor, tags, 2, views));
+    XCTAssertEqualObjects(YKFTLVCursorValue(&objectCursor, &views[0]), [NSData dataFromHexString:@"3003020101"]);
+    XCTAssertEqualObjects(YKFTLVCursorValue(&objectCursor, &views[1]), [NSData dataFromHexString:@"00"]);
+    // The ranges are relative to the whole buffer.
+    XCTAssertEqual(views[0].valueRange.location, 4);
+}
+
+- (void)test_nestedDescentIntoMissingRecord {
+    NSData *data = [NSData dataFromHexString:@"0101aa"];
+    YKFTLVCursor cursor = YKFTLVCursorMake(data);
+    YKFTLVTag tag = 0x53;
+    YKFTLVView view;
+    XCTAssertTrue(YKFTLVCursorReadTags(&cursor, &tag, 1, &view));
+    
+    YKFTLVCursor nestedCursor = YKFTLVCursorMakeWithValue(&cursor, &view);
+    YKFTLVView nestedView;
+    XCTAssertFalse(YKFTLVCursorNext(&nestedCursor, &nestedView));
+    XCTAssertTrue(YKFTLVCursorIsAtEnd(&nestedCursor));
+}
+
+- (void)test_nestedDescentDoesNotReadPastValue {
+    // The nested record claims more bytes than its parent value.
+    NSData *data = [NSData dataFromHexString:@"5303 7005 30 0000000000"];
+    YKFTLVCursor cursor = YKFTLVCursorMake(data);
+    YKFTLVView view;
+    XCTAssertTrue(YKFTLVCursorNext(&cursor, &view));
+    
+    YKFTLVCursor nestedCursor = YKFTLVCursorMakeWithValue(&cursor, &view);
+    YKFTLVView nestedView;
+    XCTAssertFalse(YKFTLVCursorNext(&nestedCursor, &nestedView));
+    XCTAssertFalse(YKFTLVCursorIsAtEnd(&nestedCursor));
+}
+
+- (void)test_sequenceOfManyRecordsPerformance {
+    // 20000 records, which was quadratic when every record copied the rest of the buffer.
+    NSMutableData *data = [NSMutableData data];
+    for (NSUInteger i = 0; i < 20000; ++i) {
+        [data appendData:[NSData dataFromHexString:@"1e081122334455667788"]];
+    }
+    [self measureBlock:^{
+        NSArray<YKFTLVRecord *> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
+        XCTAssertEqual(records.count, 20000);
+    }];
+}
+
+@end
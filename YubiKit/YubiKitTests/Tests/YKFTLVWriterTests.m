@@ -0,0 +1,111 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFTLVRecord.h"
+#import "YKFTLVWriter.h"
+
+@interface YKFTLVWriterTests: YKFTestCase
+@end
+
+@implementation YKFTLVWriterTests
+
+- (void)test_primitiveRecords {
+    YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:0];
+    [writer appendTag:0x5c value:[NSData dataFromHexString:@"5fc105"]];
+    [writer appendTag:0x7f49 value:[NSData dataFromHexString:@"11223344"]];
+    [writer appendTag:0xfe bytes:NULL length:0];
+    XCTAssertEqualObjects(writer.data, [NSData dataFromHexString:@"5c035fc105 7f490411223344 fe00"]);
+}
+
+- (void)test_primitiveRecordMatchesRecordData {
+    NSArray<NSNumber *> *lengths = @[@0, @1, @0x7f, @0x80, @0xff, @0x100, @0xffff, @0x10000];
+    for (NSNumber *length in lengths) {
+        NSMutableData *value = [NSMutableData dataWithLength:length.unsignedIntegerValue];
+        YKFTLVRecord *record = [[YKFTLVRecord alloc] initWithTag:0x110011 value:value];
+        
+        YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:0];
+        [writer appendTag:0x110011 value:value];
+        XCTAssertEqualObjects(writer.data, record.data, @"length %@", length);
+    }
+}
+
+- (void)test_constructedRecords {
+    YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:0];
+    [writer beginConstructedWithTag:0x7c];
+    [writer appendTag:0x82 bytes:NULL length:0];
+    [writer beginConstructedWithTag:0xa0];
+    [writer appendTag:0x81 value:[NSData dataFromHexString:@"112233"]];
+    [writer endConstructed];
+    [writer endConstructed];
+    XCTAssertEqualObjects(writer.data, [NSData dataFromHexString:@"7c09 8200 a005 8103112233"]);
+}
+
+- (void)test_emptyConstructedRecord {
+    YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:0];
+    [writer beginConstructedWithTag:0x53];
+    [writer endConstructed];
+    [writer appendTag:0x01 bytes:NULL length:0];
+    XCTAssertEqualObjects(writer.data, [NSData dataFromHexString:@"5300 0100"]);
+}
+
+- (void)test_constructedRecordLengths {
+    // Short form, the reserved two byte form and the long forms which do not fit the reserved bytes.
+    NSArray<NSNumber *> *lengths = @[@0x7d, @0x7e, @0x7f, @0x80, @0xff, @0x100, @0xbff, @0xffff, @0x10000, @0x12345];
+    for (NSNumber *length in lengths) {
+        NSMutableData *value = [NSMutableData dataWithLength:length.unsignedIntegerValue];
+        ((UInt8 *)value.mutableBytes)[value.length - 1] = 0xaa;
+        
+        YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:0];
+        [writer beginConstructedWithTag:0x53];
+        [writer appendTag:0x70 value:value];
+        [writer appendTag:0x71 bytes:(UInt8[]){0x01} length:1];
+        [writer endConstructed];
+        [writer appendTag:0xfe bytes:NULL length:0];
+        
+        YKFTLVRecord *certificate = [[YKFTLVRecord alloc] initWithTag:0x70 value:value];
+        YKFTLVRecord *info = [[YKFTLVRecord alloc] initWithTag:0x71 value:[NSData dataFromHexString:@"01"]];
+        NSMutableData *expected = [[[YKFTLVRecord alloc] initWithTag:0x53 records:@[certificate, info]].data mutableCopy];
+        [expected appendData:[NSData dataFromHexString:@"fe00"]];
+        XCTAssertEqualObjects(writer.data, expected, @"length %@", length);
+    }
+}
+
+- (void)test_recordWithRecords {
+    YKFTLVRecord *first = [[YKFTLVRecord alloc] initWithTag:0x80 value:[NSData dataFromHexString:@"01"]];
+    YKFTLVRecord *second = [[YKFTLVRecord alloc] initWithTag:0x81 value:[NSData dataFromHexString:@"0203"]];
+    YKFTLVRecord *record = [[YKFTLVRecord alloc] initWithTag:0xa1 records:@[first, second]];
+    XCTAssertEqualObjects(record.data, [NSData dataFromHexString:@"a107 800101 81020203"]);
+}
+
+- (void)test_writeCertificatePerformance {
+    NSData *certificate = [NSMutableData dataWithLength:3 * 1024];
+    NSData *objectId = [NSData dataFromHexString:@"5fc105"];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10000; ++i) {
+            YKFTLVWriter *writer = [[YKFTLVWriter alloc] initWithCapacity:certificate.length + 32];
+            [writer appendTag:0x5c value:objectId];
+            [writer beginConstructedWithTag:0x53];
+            [writer appendTag:0x70 value:certificate];
+            [writer appendTag:0x71 bytes:(UInt8[]){0x00} length:1];
+            [writer appendTag:0xfe bytes:NULL length:0];
+            [writer endConstructed];
+            XCTAssertEqual(writer.data.length, 5 + 4 + 4 + 3 * 1024 + 3 + 2);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,47 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFTouchPollingSchedule.h"
+
+@interface YKFTouchPollingScheduleTests: YKFTestCase
+@end
+
+@implementation YKFTouchPollingScheduleTests
+
+- (void)test_WhenUsingTheDefaultSchedule_KeyIsPolledFastDuringTheFirstSecond {
+    YKFTouchPollingSchedule *schedule = [YKFTouchPollingSchedule defaultSchedule];
+    
+    for (NSUInteger pollCount = 0; pollCount < 10; ++pollCount) {
+        XCTAssertEqualWithAccuracy([schedule intervalForPollCount:pollCount], 0.1, 0.0001);
+    }
+    XCTAssertEqualWithAccuracy([schedule intervalForPollCount:10], 0.15, 0.0001);
+    XCTAssertEqualWithAccuracy([schedule intervalForPollCount:11], 0.225, 0.0001);
+    XCTAssertEqualWithAccuracy([schedule intervalForPollCount:12], 0.3375, 0.0001);
+    XCTAssertEqualWithAccuracy([schedule intervalForPollCount:13], 0.5, 0.0001);
+    XCTAssertEqualWithAccuracy([schedule intervalForPollCount:100], 0.5, 0.0001);
+}
+
+- (void)test_WhenCopyingTheSchedule_ChangesDoNotAffectTheCopy {
+    YKFTouchPollingSchedule *schedule = [YKFTouchPollingSchedule defaultSchedule];
+    YKFTouchPollingSchedule *copy = [schedule copy];
+    schedule.initialInterval = 1;
+    schedule.timeout = 1;
+    
+    XCTAssertEqualWithAccuracy(copy.initialInterval, 0.1, 0.0001);
+    XCTAssertEqualWithAccuracy(copy.timeout, 15, 0.0001);
+}
+
+@end
@@ -21,6 +21,8 @@
 
 #import "YKFAPDUError.h"
 #import "YKFU2FError.h"
+#import "YKFSessionError.h"
+#import "YKFTouchPollingSchedule.h"
 
 @interface YKFU2FServiceTests: YKFTestCase
 
@@ -222,6 +224,69 @@
     XCTAssertNotNil(self.keyConnectionController.executionCommand, @"No command data executed on the connection controller.");
 }
 
+#pragma mark - Touch Polling Tests
+
+- (void)test_WhenExecutingRegisterRequestWithTouchRequired_KeyIsPolledWithTheSchedule {
+    NSData *applicationSelectionResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
+    NSData *touchRequiredResponse = [NSData dataWithBytes:@[@(0x00), @(0x69), @(0x85)]]; // Condition not satisfied
+    NSData *commandResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
+    self.keyConnectionController.commandExecutionResponseDataSequence = @[applicationSelectionResponse, touchRequiredResponse, touchRequiredResponse, commandResponse];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"U2F"];
+    
+    [YKFU2FSession sessionWithConnectionController:self.keyConnectionController completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
+        self.session = session;
+        [self.session registerWithChallenge:self.challenge appId:self.appId completion:^(YKFU2FRegisterResponse * _Nullable response, NSError * _Nullable error) {
+            XCTAssertNil(error, @"Unexpected error: %@", error);
+            XCTAssertNotNil(response);
+            [expectation fulfill];
+        }];
+    }];
+    
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray *expectedDelays = @[@(0.1), @(0.1)];
+    XCTAssertEqualObjects(self.keyConnectionController.dispatchDelays, expectedDelays);
+    XCTAssertEqual(self.keyConnectionController.executionCommandSequence.count, 4);
+}
+
+- (void)test_WhenTheKeyIsNotTouchedBeforeTheScheduleTimeout_TouchTimeoutErrorIsReceivedBack {
+    NSData *applicationSelectionResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
+    NSData *touchRequiredResponse = [NSData dataWithBytes:@[@(0x00), @(0x69), @(0x85)]]; // Condition not satisfied
+    NSMutableArray *responses = [[NSMutableArray alloc] initWithObjects:applicationSelectionResponse, nil];
+    for (int i = 0; i < 20; ++i) {
+        [responses addObject:touchRequiredResponse];
+    }
+    self.keyConnectionController.commandExecutionResponseDataSequence = responses;
+    
+    YKFTouchPollingSchedule *schedule = [YKFTouchPollingSchedule defaultSchedule];
+    schedule.initialInterval = 0.05;
+    schedule.fastPollingDuration = 0.1;
+    schedule.timeout = 0.3;
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"U2F"];
+    
+    [YKFU2FSession sessionWithConnectionController:self.keyConnectionController completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
+        self.session = session;
+        self.session.touchPollingSchedule = schedule;
+        [self.session signWithChallenge:self.challenge keyHandle:self.keyHandle appId:self.appId completion:^(YKFU2FSignResponse * _Nullable response, NSError * _Nullable error) {
+            XCTAssertEqual(error.code, YKFSessionErrorTouchTimeoutCode);
+            XCTAssertNil(response);
+            [expectation fulfill];
+        }];
+    }];
+    
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    
+    NSArray<NSNumber *> *delays = self.keyConnectionController.dispatchDelays;
+    XCTAssertGreaterThan(delays.count, 2);
+    XCTAssertEqualWithAccuracy(delays[0].doubleValue, 0.05, 0.0001);
+    XCTAssertEqualWithAccuracy(delays[1].doubleValue, 0.05, 0.0001);
+    XCTAssertEqualWithAccuracy(delays[2].doubleValue, 0.075, 0.0001); // backing off after the fast polling
+}
+
 #pragma mark - Key State Tests
 
 - (void)disabled_test_WhenExecutingRegisterRequestWithTouchRequired_KeyStateIsUpdatingToTouchKey {